@@ -0,0 +1,92 @@
+#!/usr/bin/env python
+'''
+Profile the loading of all MaterialX documents within a directory, reporting
+the time spent in each phase of the read.
+'''
+
+import sys, os, argparse
+import MaterialX as mx
+
+
+PHASES = [mx.XmlReadStats.PhaseParse,
+          mx.XmlReadStats.PhaseXInclude,
+          mx.XmlReadStats.PhaseConstruct,
+          mx.XmlReadStats.PhaseDuplicates,
+          mx.XmlReadStats.PhaseUpgrade]
+
+def positiveInt(value):
+    count = int(value)
+    if count < 1:
+        raise argparse.ArgumentTypeError("%s is not a positive integer" % value)
+    return count
+
+def main():
+    parser = argparse.ArgumentParser(description="Profile the loading of all MaterialX documents within a directory.")
+    parser.add_argument("--searchPath", dest="searchPath", default="", help="Search path for the documents and their includes.")
+    parser.add_argument("--iterations", dest="iterations", type=positiveInt, default=1, help="Number of times each document is loaded.")
+    parser.add_argument("--json", dest="json", default="", help="Filename to which the read stats of the final iteration of each document are written as JSON.")
+    parser.add_argument("--memoryMap", dest="memoryMap", action="store_true", help="Map documents into memory rather than reading them.")
+    parser.add_argument("--threads", dest="threads", type=int, default=1, help="Number of threads used to construct each document.")
+    parser.add_argument(dest="inputDir", help="Directory of .mtlx files to profile.")
+    opts = parser.parse_args()
+
+    filenames = []
+    for root, dirs, files in os.walk(opts.inputDir):
+        for file in sorted(files):
+            if file.endswith("." + mx.MTLX_EXTENSION):
+                filenames.append(os.path.join(root, file))
+    if not filenames:
+        print("No MaterialX documents found in %s" % opts.inputDir)
+        sys.exit(1)
+
+    searchPath = mx.FileSearchPath(opts.searchPath) if opts.searchPath else mx.FileSearchPath()
+    allStats = []
+    for filename in filenames:
+        readOptions = mx.XmlReadOptions()
+        readOptions.memoryMapFiles = opts.memoryMap
+        readOptions.buildThreadCount = opts.threads
+
+        # Record each iteration in its own stats object, so that include
+        # trees and counts describe a single load.
+        iterationStats = []
+        try:
+            for i in range(opts.iterations):
+                readOptions.readStats = mx.XmlReadStats.create()
+                doc = mx.createDocument()
+                mx.readFromXmlFile(doc, filename, searchPath, readOptions)
+                iterationStats.append(readOptions.readStats)
+        except (mx.Exception, mx.ExceptionFileMissing, mx.ExceptionParseError) as err:
+            print("Failed to read %s: %s" % (filename, err))
+            continue
+        allStats.append(iterationStats)
+
+    # Report the phase times of each document, averaged over iterations.
+    scale = 1000.0 / opts.iterations
+    header = "%-48s %10s %10s" % ("Document (ms)", "bytes", "elements")
+    for phase in PHASES:
+        header += " %10s" % mx.XmlReadStats.getPhaseName(phase)
+    header += " %10s" % "total"
+    print(header)
+    totals = [0.0] * (len(PHASES) + 1)
+    for iterationStats in allStats:
+        stats = iterationStats[-1]
+        line = "%-48s %10d %10d" % (os.path.basename(stats.getSource())[-48:],
+                                    stats.getByteCount(),
+                                    stats.getElementCount())
+        for index, phase in enumerate(PHASES):
+            phaseTime = sum([s.getPhaseTime(phase) for s in iterationStats]) * scale
+            totals[index] += phaseTime
+            line += " %10.3f" % phaseTime
+        totalTime = sum([s.getTotalTime() for s in iterationStats]) * scale
+        totals[-1] += totalTime
+        line += " %10.3f" % totalTime
+        print(line)
+    print("%-48s %10s %10s" % ("All documents", "", "") + "".join([" %10.3f" % t for t in totals]))
+
+    if opts.json:
+        with open(opts.json, "w") as jsonFile:
+            jsonFile.write("[\n" + ",\n".join([iterationStats[-1].toJson().rstrip() for iterationStats in allStats]) + "\n]\n")
+        print("Wrote read stats to %s" % opts.json)
+
+if __name__ == '__main__':
+    main()
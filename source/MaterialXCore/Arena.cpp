@@ -0,0 +1,41 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#include <MaterialXCore/Arena.h>
+
+namespace MaterialX
+{
+
+const size_t Arena::DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+//
+// Arena methods
+//
+
+void* Arena::allocate(size_t size, size_t alignment)
+{
+    std::lock_guard<std::mutex> guard(_mutex);
+
+    // Align the current position within the active block.
+    size_t padding = _current ? (alignment - (size_t) _current % alignment) % alignment : 0;
+    if (!_current || size + padding > _remaining)
+    {
+        // Start a new block, sized to fit oversized requests.
+        size_t blockSize = std::max(_blockSize, size + alignment);
+        _blocks.emplace_back(new char[blockSize]);
+        _reservedBytes += blockSize;
+        _current = _blocks.back().get();
+        _remaining = blockSize;
+        padding = (alignment - (size_t) _current % alignment) % alignment;
+    }
+
+    char* result = _current + padding;
+    _current = result + size;
+    _remaining -= size + padding;
+    _allocatedBytes += size;
+    return result;
+}
+
+} // namespace MaterialX
@@ -0,0 +1,127 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#ifndef MATERIALX_ARENA_H
+#define MATERIALX_ARENA_H
+
+/// @file
+/// Arena allocation for element trees
+
+#include <MaterialXCore/Library.h>
+
+#include <mutex>
+
+namespace MaterialX
+{
+
+class Arena;
+
+/// A shared pointer to an Arena
+using ArenaPtr = shared_ptr<Arena>;
+
+/// @class Arena
+/// A simple region allocator, which hands out memory from a list of large
+/// blocks and releases all of its blocks at once when it is destroyed.
+///
+/// Individual allocations are never returned to the arena, so an arena is
+/// best suited to data with a shared lifetime, such as the elements of a
+/// document that is loaded and discarded as a unit.  Allocations are
+/// serialized by an internal mutex, so that separate subtrees of a document
+/// may be constructed concurrently.
+class Arena
+{
+  public:
+    explicit Arena(size_t blockSize = DEFAULT_BLOCK_SIZE) :
+        _blockSize(blockSize),
+        _current(nullptr),
+        _remaining(0),
+        _reservedBytes(0),
+        _allocatedBytes(0)
+    {
+    }
+    ~Arena() { }
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    /// Allocate a region of the given size and alignment from the arena.
+    void* allocate(size_t size, size_t alignment);
+
+    /// Return the total number of bytes reserved by the arena's blocks.
+    size_t getReservedBytes() const
+    {
+        std::lock_guard<std::mutex> guard(_mutex);
+        return _reservedBytes;
+    }
+
+    /// Return the total number of bytes handed out by the arena.
+    size_t getAllocatedBytes() const
+    {
+        std::lock_guard<std::mutex> guard(_mutex);
+        return _allocatedBytes;
+    }
+
+  public:
+    static const size_t DEFAULT_BLOCK_SIZE;
+
+  private:
+    size_t _blockSize;
+    mutable std::mutex _mutex;
+    vector<std::unique_ptr<char[]>> _blocks;
+    char* _current;
+    size_t _remaining;
+    size_t _reservedBytes;
+    size_t _allocatedBytes;
+};
+
+/// @class ArenaAllocator
+/// A standard allocator that draws its memory from a shared Arena.  Each
+/// copy of the allocator holds a reference to the arena, keeping it alive
+/// until the last object allocated through it has been released.
+template <class T> class ArenaAllocator
+{
+  public:
+    using value_type = T;
+
+    explicit ArenaAllocator(ArenaPtr arena) :
+        _arena(arena)
+    {
+    }
+    template <class U> ArenaAllocator(const ArenaAllocator<U>& other) :
+        _arena(other.getArena())
+    {
+    }
+
+    T* allocate(size_t count)
+    {
+        return static_cast<T*>(_arena->allocate(count * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T*, size_t)
+    {
+        // Memory is reclaimed when the arena itself is destroyed.
+    }
+
+    /// Return the arena of this allocator.
+    const ArenaPtr& getArena() const
+    {
+        return _arena;
+    }
+
+    template <class U> bool operator==(const ArenaAllocator<U>& rhs) const
+    {
+        return _arena == rhs.getArena();
+    }
+    template <class U> bool operator!=(const ArenaAllocator<U>& rhs) const
+    {
+        return _arena != rhs.getArena();
+    }
+
+  private:
+    ArenaPtr _arena;
+};
+
+} // namespace MaterialX
+
+#endif
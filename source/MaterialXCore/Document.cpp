@@ -7,7 +7,10 @@
 
 #include <MaterialXCore/Util.h>
 
+#include <algorithm>
+#include <atomic>
 #include <mutex>
+#include <unordered_map>
 
 namespace MaterialX
 {
@@ -20,6 +23,18 @@ namespace {
 const string DOCUMENT_VERSION_STRING = std::to_string(MATERIALX_MAJOR_VERSION) + "." +
                                        std::to_string(MATERIALX_MINOR_VERSION);
 
+using ElementOrderMap = std::unordered_map<const Element*, size_t>;
+
+// Sort the given index entries by the traversal order of their elements.
+template<class T> void sortByElementOrder(vector<std::pair<string, T>>& entries, const ElementOrderMap& elementOrder)
+{
+    std::stable_sort(entries.begin(), entries.end(),
+        [&elementOrder](const std::pair<string, T>& lhs, const std::pair<string, T>& rhs)
+        {
+            return elementOrder.at(lhs.second.get()) < elementOrder.at(rhs.second.get());
+        });
+}
+
 template<class T> shared_ptr<T> updateChildSubclass(ElementPtr parent, ElementPtr origChild)
 {
     string childName = origChild->getName();
@@ -31,6 +46,23 @@ template<class T> shared_ptr<T> updateChildSubclass(ElementPtr parent, ElementPt
     return newChild;
 }
 
+// Apply the v1.36 token conventions to the value of the given element.
+void upgradeTokenValues(ValueElementPtr valueElem)
+{
+    if (valueElem->getType() == GEOMNAME_TYPE_STRING &&
+        valueElem->getValueString() == "*")
+    {
+        valueElem->setValueString(UNIVERSAL_GEOM_NAME);
+    }
+    if (valueElem->getType() == FILENAME_TYPE_STRING)
+    {
+        StringMap stringMap;
+        stringMap["%UDIM"] = UDIM_TOKEN;
+        stringMap["%UVTILE"] = UV_TILE_TOKEN;
+        valueElem->setValueString(replaceSubstrings(valueElem->getValueString(), stringMap));
+    }
+}
+
 bool convertMaterialsToNodes(DocumentPtr doc)
 {
     bool modified = false;
@@ -164,15 +196,58 @@ bool convertMaterialsToNodes(DocumentPtr doc)
     return modified;
 }
 
+// Apply the document-level scope of the given library to an element
+// that has been copied from it.
+void applyLibraryScope(ElementPtr childCopy, ConstDocumentPtr library)
+{
+    if (!childCopy->hasFilePrefix() && library->hasFilePrefix())
+    {
+        childCopy->setFilePrefix(library->getFilePrefix());
+    }
+    if (!childCopy->hasGeomPrefix() && library->hasGeomPrefix())
+    {
+        childCopy->setGeomPrefix(library->getGeomPrefix());
+    }
+    if (!childCopy->hasColorSpace() && library->hasColorSpace())
+    {
+        childCopy->setColorSpace(library->getColorSpace());
+    }
+    if (!childCopy->hasNamespace() && library->hasNamespace())
+    {
+        childCopy->setNamespace(library->getNamespace());
+    }
+    if (!childCopy->hasSourceUri() && library->hasSourceUri())
+    {
+        childCopy->setSourceUri(library->getSourceUri());
+    }
+}
+
+// Return the name of the given element within the scope of a library
+// document, removing the namespace prefix of the library if present, or
+// return an empty string if the name lies outside of the library namespace.
+string getLibraryLocalName(ConstDocumentPtr library, const string& name)
+{
+    if (!library->hasNamespace())
+    {
+        return name;
+    }
+    const string prefix = library->getNamespace() + NAME_PREFIX_SEPARATOR;
+    if (name.compare(0, prefix.size(), prefix) != 0)
+    {
+        return EMPTY_STRING;
+    }
+    return name.substr(prefix.size());
+}
+
 } // anonymous namespace
 
 //
 // Document factory function
 //
 
-DocumentPtr createDocument()
+DocumentPtr createDocument(bool useArena)
 {
-    return Document::createDocument<Document>();
+    return Document::createDocument<Document>(useArena);
 }
 
 //
@@ -183,14 +258,23 @@ class Document::Cache
 {
   public:
     Cache() :
-        valid(false)
+        valid(false),
+        upToDate(false)
     {
     }
     ~Cache() { }
 
     void refresh()
     {
-        // Thread synchronization for multiple concurrent readers of a single document.
+        // An up-to-date cache is read without locking, so that concurrent
+        // readers of a single document do not serialize on the mutex.
+        if (upToDate.load(std::memory_order_acquire))
+        {
+            return;
+        }
+
+        // Thread synchronization for multiple concurrent readers of a single
+        // document, allowing only one of them to update the cache.
         std::lock_guard<std::mutex> guard(mutex);
 
         if (!valid)
@@ -199,57 +283,189 @@ class Document::Cache
             portElementMap.clear();
             nodeDefMap.clear();
             implementationMap.clear();
+            pendingElements.clear();
 
             // Traverse the document to build a new cache.
             for (ElementPtr elem : doc.lock()->traverseTree())
             {
-                const string& nodeName = elem->getAttribute(PortElement::NODE_NAME_ATTRIBUTE);
-                const string& nodeString = elem->getAttribute(NodeDef::NODE_ATTRIBUTE);
-                const string& nodeDefString = elem->getAttribute(InterfaceElement::NODE_DEF_ATTRIBUTE);
+                addElement(elem);
+            }
 
-                if (!nodeName.empty())
-                {
-                    PortElementPtr portElem = elem->asA<PortElement>();
-                    if (portElem)
-                    {
-                        portElementMap.insert(std::pair<string, PortElementPtr>(
-                            portElem->getQualifiedName(nodeName),
-                            portElem));
-                    }
-                }
-                if (!nodeString.empty())
-                {
-                    NodeDefPtr nodeDef = elem->asA<NodeDef>();
-                    if (nodeDef)
-                    {
-                        nodeDefMap.insert(std::pair<string, NodeDefPtr>(
-                            nodeDef->getQualifiedName(nodeString),
-                            nodeDef));
-                    }
-                }
-                if (!nodeDefString.empty())
+            valid = true;
+        }
+        else if (!pendingElements.empty())
+        {
+            // Re-index only those elements whose content has changed since
+            // the last refresh, skipping any that have left the document.
+            for (ElementPtr elem : pendingElements)
+            {
+                removeElement(elem);
+                if (isInDocument(elem))
                 {
-                    InterfaceElementPtr interface = elem->asA<InterfaceElement>();
-                    if (interface && (interface->isA<Implementation>() || interface->isA<NodeGraph>()))
-                    {
-                        implementationMap.insert(std::pair<string, InterfaceElementPtr>(
-                            interface->getQualifiedName(nodeDefString),
-                            interface));
-                    }
+                    addElement(elem);
                 }
             }
+            pendingElements.clear();
+        }
 
-            valid = true;
+        upToDate.store(true, std::memory_order_release);
+    }
+
+    // Remove the given element from the cache before its content is modified,
+    // deferring its re-indexing until the next refresh.
+    void invalidateElement(ElementPtr elem)
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+        if (valid)
+        {
+            removeElement(elem);
+            pendingElements.push_back(elem);
+            upToDate.store(false, std::memory_order_release);
+        }
+    }
+
+    // Discard all cached entries, deferring a full rebuild until the next refresh.
+    void invalidate()
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+        valid = false;
+        pendingElements.clear();
+        upToDate.store(false, std::memory_order_release);
+    }
+
+    // Apply invalidateElement to the given element and all of its descendants.
+    void invalidateTree(ElementPtr elem)
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+        if (valid)
+        {
+            for (ElementPtr descendant : elem->traverseTree())
+            {
+                removeElement(descendant);
+                pendingElements.push_back(descendant);
+            }
+            upToDate.store(false, std::memory_order_release);
+        }
+    }
+
+    // Remove the given element and all of its descendants from the cache.
+    void removeTree(ElementPtr elem)
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+        if (valid)
+        {
+            for (ElementPtr descendant : elem->traverseTree())
+            {
+                removeElement(descendant);
+            }
+        }
+    }
+
+    // Return true if the given attribute contributes to a cache key.
+    static bool isKeyAttribute(const string& attrib)
+    {
+        return attrib == PortElement::NODE_NAME_ATTRIBUTE ||
+               attrib == NodeDef::NODE_ATTRIBUTE ||
+               attrib == InterfaceElement::NODE_DEF_ATTRIBUTE;
+    }
+
+  private:
+    void addElement(ElementPtr elem)
+    {
+        const string& nodeName = elem->getAttribute(PortElement::NODE_NAME_ATTRIBUTE);
+        const string& nodeString = elem->getAttribute(NodeDef::NODE_ATTRIBUTE);
+        const string& nodeDefString = elem->getAttribute(InterfaceElement::NODE_DEF_ATTRIBUTE);
+
+        if (!nodeName.empty())
+        {
+            PortElementPtr portElem = elem->asA<PortElement>();
+            if (portElem)
+            {
+                portElementMap.insert(std::pair<string, PortElementPtr>(
+                    portElem->getQualifiedName(nodeName),
+                    portElem));
+            }
+        }
+        if (!nodeString.empty())
+        {
+            NodeDefPtr nodeDef = elem->asA<NodeDef>();
+            if (nodeDef)
+            {
+                nodeDefMap.insert(std::pair<string, NodeDefPtr>(
+                    nodeDef->getQualifiedName(nodeString),
+                    nodeDef));
+            }
+        }
+        if (!nodeDefString.empty())
+        {
+            InterfaceElementPtr interface = elem->asA<InterfaceElement>();
+            if (interface && (interface->isA<Implementation>() || interface->isA<NodeGraph>()))
+            {
+                implementationMap.insert(std::pair<string, InterfaceElementPtr>(
+                    interface->getQualifiedName(nodeDefString),
+                    interface));
+            }
+        }
+    }
+
+    // Remove the entries for the given element, using cache keys computed
+    // from its current content.
+    void removeElement(ElementPtr elem)
+    {
+        const string& nodeName = elem->getAttribute(PortElement::NODE_NAME_ATTRIBUTE);
+        const string& nodeString = elem->getAttribute(NodeDef::NODE_ATTRIBUTE);
+        const string& nodeDefString = elem->getAttribute(InterfaceElement::NODE_DEF_ATTRIBUTE);
+
+        if (!nodeName.empty())
+        {
+            eraseEntry(portElementMap, elem->getQualifiedName(nodeName), elem);
+        }
+        if (!nodeString.empty())
+        {
+            eraseEntry(nodeDefMap, elem->getQualifiedName(nodeString), elem);
+        }
+        if (!nodeDefString.empty())
+        {
+            eraseEntry(implementationMap, elem->getQualifiedName(nodeDefString), elem);
+        }
+    }
+
+    template <class T> static void eraseEntry(std::unordered_multimap<string, T>& map, const string& key, ConstElementPtr elem)
+    {
+        auto keyRange = map.equal_range(key);
+        for (auto it = keyRange.first; it != keyRange.second; ++it)
+        {
+            if (it->second == elem)
+            {
+                map.erase(it);
+                return;
+            }
+        }
+    }
+
+    // Return true if the given element is reachable from the root of the document.
+    bool isInDocument(ConstElementPtr elem) const
+    {
+        for (ConstElementPtr parent = elem->getParent(); parent; parent = elem->getParent())
+        {
+            if (parent->getChild(elem->getName()) != elem)
+            {
+                return false;
+            }
+            elem = parent;
         }
+        return elem == doc.lock();
     }
 
   public:
     weak_ptr<Document> doc;
     std::mutex mutex;
     bool valid;
+    std::atomic<bool> upToDate;
     std::unordered_multimap<string, PortElementPtr> portElementMap;
     std::unordered_multimap<string, NodeDefPtr> nodeDefMap;
     std::unordered_multimap<string, InterfaceElementPtr> implementationMap;
+    vector<ElementPtr> pendingElements;
 };
 
 //
@@ -258,7 +474,13 @@ class Document::Cache
 
 Document::Document(ElementPtr parent, const string& name) :
     GraphElement(parent, CATEGORY, name),
-    _cache(std::unique_ptr<Cache>(new Cache))
+    _cache(std::unique_ptr<Cache>(new Cache)),
+    _frozen(false),
+    _nodeDefRevision(0),
+    _nodeDefCacheStatsEnabled(false),
+    _nodeDefCacheHits(0),
+    _nodeDefCacheMisses(0),
+    _geomRevision(0)
 {
 }
 
@@ -274,6 +496,7 @@ void Document::initialize()
     _cache->doc = doc;
 
     clearContent();
+    _libraries.clear();
     setVersionString(DOCUMENT_VERSION_STRING);
 }
 
@@ -299,33 +522,90 @@ void Document::importLibrary(const ConstDocumentPtr& library, const CopyOptions*
         // Create the imported element.
         ElementPtr childCopy = addChildOfCategory(child->getCategory(), childName, !previous);
         childCopy->copyContentFrom(child, copyOptions);
-        if (!childCopy->hasFilePrefix() && library->hasFilePrefix())
-        {
-            childCopy->setFilePrefix(library->getFilePrefix());
-        }
-        if (!childCopy->hasGeomPrefix() && library->hasGeomPrefix())
+        applyLibraryScope(childCopy, library);
+
+        // Check for conflicting elements.
+        if (previous && *previous != *childCopy)
         {
-            childCopy->setGeomPrefix(library->getGeomPrefix());
+            throw Exception("Duplicate element with conflicting content: " + childName);
         }
-        if (!childCopy->hasColorSpace() && library->hasColorSpace())
+    }
+}
+
+void Document::referenceLibrary(const ConstDocumentPtr& library)
+{
+    validateMutable();
+    if (!library)
+    {
+        return;
+    }
+    if (!library->isFrozen())
+    {
+        throw Exception("Referenced library must be frozen: " + library->getSourceUri());
+    }
+
+    _libraries.push_back(library);
+    invalidateAllNodeDefs();
+}
+
+void Document::clearReferencedLibraries()
+{
+    validateMutable();
+    _libraries.clear();
+    invalidateAllNodeDefs();
+}
+
+ElementPtr Document::getReferencedElement(const string& name) const
+{
+    for (const ConstDocumentPtr& library : _libraries)
+    {
+        string localName = getLibraryLocalName(library, name);
+        if (localName.empty())
         {
-            childCopy->setColorSpace(library->getColorSpace());
+            continue;
         }
-        if (!childCopy->hasNamespace() && library->hasNamespace())
+        ElementPtr child = library->getChild(localName);
+        if (!child)
         {
-            childCopy->setNamespace(library->getNamespace());
+            child = library->getReferencedElement(name);
         }
-        if (!childCopy->hasSourceUri() && library->hasSourceUri())
+        if (child)
         {
-            childCopy->setSourceUri(library->getSourceUri());
+            return child;
         }
+    }
+    return nullptr;
+}
 
-        // Check for conflicting elements.
-        if (previous && *previous != *childCopy)
-        {
-            throw Exception("Duplicate element with conflicting content: " + childName);
-        }
+ElementPtr Document::copyReferencedElement(const string& name)
+{
+    ElementPtr local = getChild(name);
+    if (local)
+    {
+        return local;
+    }
+    ElementPtr source = getReferencedElement(name);
+    if (!source)
+    {
+        return nullptr;
     }
+
+    ElementPtr childCopy = addChildOfCategory(source->getCategory(), source->getQualifiedName(source->getName()));
+    childCopy->copyContentFrom(source);
+    applyLibraryScope(childCopy, source->getDocument());
+    return childCopy;
+}
+
+bool Document::isReferenceShadowed(ConstElementPtr elem) const
+{
+    string qualifiedName = elem->getQualifiedName(elem->getName());
+    return getChild(qualifiedName) || getReferencedElement(qualifiedName) != elem;
+}
+
+void Document::freeze()
+{
+    _cache->refresh();
+    _frozen = true;
 }
 
 StringSet Document::getReferencedSourceUris() const
@@ -372,7 +652,7 @@ ValuePtr Document::getGeomPropValue(const string& geomPropName, const string& ge
     ValuePtr value;
     for (GeomInfoPtr geomInfo : getGeomInfos())
     {
-        if (!geomStringsMatch(geom, geomInfo->getActiveGeom()))
+        if (!geomInfo->matchesGeomString(geom))
         {
             continue;
         }
@@ -398,6 +678,19 @@ vector<NodeDefPtr> Document::getMatchingNodeDefs(const string& nodeName) const
         nodeDefs.push_back(it->second);
     }
 
+    // Append matches from referenced libraries that are not shadowed by
+    // elements of this document.
+    for (const ConstDocumentPtr& library : _libraries)
+    {
+        for (const auto& match : library->getMatchingNodeDefs(nodeName))
+        {
+            if (!isReferenceShadowed(match))
+            {
+                nodeDefs.push_back(match);
+            }
+        }
+    }
+
     // Return the matches.
     return nodeDefs;
 }
@@ -415,6 +708,19 @@ vector<InterfaceElementPtr> Document::getMatchingImplementations(const string& n
         implementations.push_back(it->second);
     }
 
+    // Append matches from referenced libraries that are not shadowed by
+    // elements of this document.
+    for (const ConstDocumentPtr& library : _libraries)
+    {
+        for (const auto& match : library->getMatchingImplementations(nodeDef))
+        {
+            if (!isReferenceShadowed(match))
+            {
+                implementations.push_back(match);
+            }
+        }
+    }
+
     // Return the matches.
     return implementations;
 }
@@ -426,6 +732,43 @@ bool Document::validate(string* message) const
     return GraphElement::validate(message) && res;
 }
 
+bool Document::validate(ValidationDiagnosticVec& diagnostics, const ValidationOptions& options) const
+{
+    diagnostics.clear();
+    std::atomic<size_t> errorCount(0);
+
+    // Validate the rules of the document element itself, deferring its
+    // children to the worker threads below.
+    {
+        ValidationCollector collector(diagnostics, errorCount, options.maxErrors);
+        collector.shallowElement = this;
+        validate();
+    }
+
+    // Validate each top-level child on the next available thread, gathering
+    // diagnostics separately for each child to preserve document order.
+    vector<ElementPtr> children = getChildren();
+    vector<ValidationDiagnosticVec> childDiagnostics(children.size());
+    parallelFor(children.size(), options.threadCount, [&](size_t index)
+    {
+        ValidationCollector collector(childDiagnostics[index], errorCount, options.maxErrors);
+        if (!collector.isStopped())
+        {
+            children[index]->validate();
+        }
+    });
+
+    for (ValidationDiagnosticVec& childVec : childDiagnostics)
+    {
+        diagnostics.insert(diagnostics.end(), childVec.begin(), childVec.end());
+    }
+    if (options.maxErrors && diagnostics.size() > options.maxErrors)
+    {
+        diagnostics.erase(diagnostics.begin() + options.maxErrors, diagnostics.end());
+    }
+    return diagnostics.empty();
+}
+
 void Document::upgradeVersion(bool applyFutureUpdates)
 {
     std::pair<int, int> versions = getVersionIntegers();
@@ -438,65 +781,54 @@ void Document::upgradeVersion(bool applyFutureUpdates)
         return;
     }
 
-    // Upgrade from v1.22 to v1.23
-    if (majorVersion == 1 && minorVersion == 22)
+    // The lookup cache is discarded before the upgrade begins, rather than
+    // being maintained through each of its edits.
+    _cache->invalidate();
+
+    // Upgrade from v1.22 to v1.26, applying the element rules of each
+    // version step within a single traversal.
+    if (majorVersion == 1 && minorVersion >= 22 && minorVersion <= 25)
     {
         for (ElementPtr elem : traverseTree())
         {
-            if (elem->isA<TypedElement>())
+            TypedElementPtr typedElem = elem->asA<TypedElement>();
+
+            // Upgrade from v1.22 to v1.23
+            if (minorVersion <= 22 && typedElem)
             {
-                TypedElementPtr typedElem = elem->asA<TypedElement>();
                 if (typedElem->getType() == "vector")
                 {
                     typedElem->setType(getTypeString<Vector3>());
                 }
             }
-        }
-        minorVersion = 23;
-    }
 
-    // Upgrade from v1.23 to v1.24
-    if (majorVersion == 1 && minorVersion == 23)
-    {
-        for (ElementPtr elem : traverseTree())
-        {
-            if (elem->getCategory() == "shader" && elem->hasAttribute("shadername"))
+            // Upgrade from v1.23 to v1.24
+            if (minorVersion <= 23)
             {
-                elem->setAttribute(NodeDef::NODE_ATTRIBUTE, elem->getAttribute("shadername"));
-                elem->removeAttribute("shadername");
-            }
-            vector<ElementPtr> origChildren = elem->getChildren();
-            for (ElementPtr child : origChildren)
-            {
-                if (child->getCategory() == "assign")
+                if (elem->getCategory() == "shader" && elem->hasAttribute("shadername"))
+                {
+                    elem->setAttribute(NodeDef::NODE_ATTRIBUTE, elem->getAttribute("shadername"));
+                    elem->removeAttribute("shadername");
+                }
+                vector<ElementPtr> origChildren = elem->getChildren();
+                for (ElementPtr child : origChildren)
                 {
-                    updateChildSubclass<MaterialAssign>(elem, child);
+                    if (child->getCategory() == "assign")
+                    {
+                        updateChildSubclass<MaterialAssign>(elem, child);
+                    }
                 }
             }
-        }
-        minorVersion = 24;
-    }
 
-    // Upgrade from v1.24 to v1.25
-    if (majorVersion == 1 && minorVersion == 24)
-    {
-        for (ElementPtr elem : traverseTree())
-        {
-            if (elem->isA<Input>() && elem->hasAttribute("graphname"))
+            // Upgrade from v1.24 to v1.25
+            if (minorVersion <= 24 && typedElem && elem->isA<Input>() && elem->hasAttribute("graphname"))
             {
                 elem->setAttribute("opgraph", elem->getAttribute("graphname"));
                 elem->removeAttribute("graphname");
             }
-        }
-        minorVersion = 25;
-    }
 
-    // Upgrade from v1.25 to v1.26
-    if (majorVersion == 1 && minorVersion == 25)
-    {
-        for (ElementPtr elem : traverseTree())
-        {
-            if (elem->getCategory() == "constant")
+            // Upgrade from v1.25 to v1.26
+            if (minorVersion <= 25 && elem->getCategory() == "constant")
             {
                 ElementPtr param = elem->getChild("color");
                 if (param)
@@ -535,7 +867,7 @@ void Document::upgradeVersion(bool applyFutureUpdates)
                         nodeDef->removeAttribute("shaderprogram");
                     }
                 }
-                else if (child->isA<Parameter>())
+                else if (child->getCategory() == Parameter::CATEGORY)
                 {
                     ParameterPtr param = child->asA<Parameter>();
                     if (param->getType() == "opgraphnode")
@@ -654,107 +986,115 @@ void Document::upgradeVersion(bool applyFutureUpdates)
         minorVersion = 34;
     }
 
-    // Upgrade from v1.34 to v1.35
-    if (majorVersion == 1 && minorVersion == 34)
+    // Upgrade from v1.34 to v1.37, applying the element rules of each
+    // version step within a single traversal.  Material overrides and node
+    // conversions are gathered during the traversal and applied afterwards.
+    if (majorVersion == 1 && minorVersion >= 34 && minorVersion <= 36)
     {
+        vector<std::pair<MaterialPtr, ElementPtr>> overrides;
+        vector<NodePtr> nodes;
         for (ElementPtr elem : traverseTree())
         {
-            TypedElementPtr typedElem = elem->asA<TypedElement>();
+            // Subclass casts are shared between version steps, and are
+            // skipped where the category of the element is sufficient.
+            const string& category = elem->getCategory();
             ValueElementPtr valueElem = elem->asA<ValueElement>();
-            MaterialAssignPtr matAssign = elem->asA<MaterialAssign>();
-            if (typedElem && typedElem->getType() == "matrix")
-            {
-                typedElem->setType(getTypeString<Matrix44>());
-            }
-            if (valueElem && valueElem->hasAttribute("default"))
-            {
-                valueElem->setValueString(elem->getAttribute("default"));
-                valueElem->removeAttribute("default");
-            }
-            if (matAssign)
+            TypedElementPtr typedElem = valueElem ? valueElem : elem->asA<TypedElement>();
+
+            // Upgrade from v1.34 to v1.35
+            if (minorVersion <= 34)
             {
-                matAssign->setMaterial(matAssign->getName());
+                if (typedElem && typedElem->getType() == "matrix")
+                {
+                    typedElem->setType(getTypeString<Matrix44>());
+                }
+                if (valueElem && valueElem->hasAttribute("default"))
+                {
+                    valueElem->setValueString(elem->getAttribute("default"));
+                    valueElem->removeAttribute("default");
+                }
+                MaterialAssignPtr matAssign = category == MaterialAssign::CATEGORY ? elem->asA<MaterialAssign>() : nullptr;
+                if (matAssign)
+                {
+                    matAssign->setMaterial(matAssign->getName());
+                }
             }
-        }
-        minorVersion = 35;
-    }
 
-    // Upgrade from v1.35 to v1.36
-    if (majorVersion == 1 && minorVersion == 35)
-    {
-        for (ElementPtr elem : traverseTree())
-        {
-            ValueElementPtr valueElem = elem->asA<ValueElement>();
-            MaterialPtr material = elem->asA<Material>();
-            LookPtr look = elem->asA<Look>();
-            GeomInfoPtr geomInfo = elem->asA<GeomInfo>();
-
-            if (valueElem)
+            // Upgrade from v1.35 to v1.36
+            if (minorVersion <= 35)
             {
-                if (valueElem->getType() == GEOMNAME_TYPE_STRING &&
-                    valueElem->getValueString() == "*")
+                MaterialPtr material = category == Material::CATEGORY ? elem->asA<Material>() : nullptr;
+                LookPtr look = category == Look::CATEGORY ? elem->asA<Look>() : nullptr;
+                if (valueElem)
                 {
-                    valueElem->setValueString(UNIVERSAL_GEOM_NAME);
+                    upgradeTokenValues(valueElem);
                 }
-                if (valueElem->getType() == FILENAME_TYPE_STRING)
+
+                vector<ElementPtr> origChildren = elem->getChildren();
+                for (ElementPtr child : origChildren)
                 {
-                    StringMap stringMap;
-                    stringMap["%UDIM"] = UDIM_TOKEN;
-                    stringMap["%UVTILE"] = UV_TILE_TOKEN;
-                    valueElem->setValueString(replaceSubstrings(valueElem->getValueString(), stringMap));
+                    if (material && child->getCategory() == "override")
+                    {
+                        overrides.emplace_back(material, child);
+                    }
+                    else if (material && child->getCategory() == "materialinherit")
+                    {
+                        elem->setInheritString(child->getAttribute("material"));
+                        elem->removeChild(child->getName());
+                    }
+                    else if (look && child->getCategory() == "lookinherit")
+                    {
+                        elem->setInheritString(child->getAttribute("look"));
+                        elem->removeChild(child->getName());
+                    }
                 }
             }
 
-            vector<ElementPtr> origChildren = elem->getChildren();
-            for (ElementPtr child : origChildren)
+            // Value elements are never nodes.
+            NodePtr node = (typedElem && !valueElem) ? elem->asA<Node>() : nullptr;
+            if (node)
+            {
+                nodes.push_back(node);
+            }
+        }
+
+        // Convert material overrides to bindparams and bindinputs.
+        for (const auto& pair : overrides)
+        {
+            MaterialPtr material = pair.first;
+            ElementPtr overrideElem = pair.second;
+            for (ShaderRefPtr shaderRef : material->getShaderRefs())
             {
-                if (material && child->getCategory() == "override")
+                NodeDefPtr nodeDef = shaderRef->getNodeDef();
+                if (nodeDef)
                 {
-                    for (ShaderRefPtr shaderRef : material->getShaderRefs())
+                    for (ValueElementPtr activeValue : nodeDef->getActiveValueElements())
                     {
-                        NodeDefPtr nodeDef = shaderRef->getNodeDef();
-                        if (nodeDef)
+                        if (activeValue->getAttribute("publicname") == overrideElem->getName() &&
+                            !shaderRef->getChild(overrideElem->getName()))
                         {
-                            for (ValueElementPtr activeValue : nodeDef->getActiveValueElements())
+                            if (activeValue->isA<Parameter>())
+                            {
+                                BindParamPtr bindParam = shaderRef->addBindParam(activeValue->getName(), activeValue->getType());
+                                bindParam->setValueString(overrideElem->getAttribute("value"));
+                                upgradeTokenValues(bindParam);
+                            }
+                            else if (activeValue->isA<Input>())
                             {
-                                if (activeValue->getAttribute("publicname") == child->getName() &&
-                                    !shaderRef->getChild(child->getName()))
-                                {
-                                    if (activeValue->isA<Parameter>())
-                                    {
-                                        BindParamPtr bindParam = shaderRef->addBindParam(activeValue->getName(), activeValue->getType());
-                                        bindParam->setValueString(child->getAttribute("value"));
-                                    }
-                                    else if (activeValue->isA<Input>())
-                                    {
-                                        BindInputPtr bindInput = shaderRef->addBindInput(activeValue->getName(), activeValue->getType());
-                                        bindInput->setValueString(child->getAttribute("value"));
-                                    }
-                                }
+                                BindInputPtr bindInput = shaderRef->addBindInput(activeValue->getName(), activeValue->getType());
+                                bindInput->setValueString(overrideElem->getAttribute("value"));
+                                upgradeTokenValues(bindInput);
                             }
                         }
                     }
-                    elem->removeChild(child->getName());
-                }
-                else if (material && child->getCategory() == "materialinherit")
-                {
-                    elem->setInheritString(child->getAttribute("material"));
-                    elem->removeChild(child->getName());
-                }
-                else if (look && child->getCategory() == "lookinherit")
-                {
-                    elem->setInheritString(child->getAttribute("look"));
-                    elem->removeChild(child->getName());
                 }
             }
+            material->removeChild(overrideElem->getName());
         }
         minorVersion = 36;
-    }
 
-    // Upgrade from 1.36 to 1.37
-    if (majorVersion == 1 && minorVersion == 36)
-    {
-        // Convert type attributes to child outputs.
+        // Upgrade from v1.36 to v1.37, converting nodedef type attributes
+        // to child outputs.
         for (NodeDefPtr nodeDef : getNodeDefs())
         {
             InterfaceElementPtr interfaceElem = std::static_pointer_cast<InterfaceElement>(nodeDef);
@@ -793,14 +1133,10 @@ void Document::upgradeVersion(bool applyFutureUpdates)
                 }
             }
         }
-        for (ElementPtr elem : traverseTree())
-        {
-            NodePtr node = elem->asA<Node>();
-            if (!node)
-            {
-                continue;
-            }
 
+        // Convert deprecated node categories.
+        for (NodePtr node : nodes)
+        {
             if (node->getCategory() == "geomattrvalue")
             {
                 node->setCategory("geompropvalue");
@@ -810,15 +1146,6 @@ void Document::upgradeVersion(bool applyFutureUpdates)
                     node->removeAttribute("attrname");
                 }
             }
-        }
-
-        for (ElementPtr elem : traverseTree())
-        {
-            NodePtr node = elem->asA<Node>();
-            if (!node)
-            {
-                continue;
-            }
             const string& nodeCategory = node->getCategory();
 
             // Change category from "invert to "invertmatrix" for matrix invert nodes
@@ -956,34 +1283,217 @@ void Document::upgradeVersion(bool applyFutureUpdates)
     }
 }
 
-void Document::onAddElement(ElementPtr, ElementPtr)
+void Document::validateMutable() const
+{
+    if (_frozen)
+    {
+        throw ExceptionFrozenDocument("Cannot modify a frozen document");
+    }
+}
+
+DocumentIndex Document::getElementIndex() const
+{
+    // Entries are gathered in traversal order, rather than the arbitrary
+    // order of the cache maps, so that an index restored with
+    // setElementIndex matches a cache built by traversal.
+    _cache->refresh();
+    ElementOrderMap elementOrder;
+    for (ElementPtr elem : getDocument()->traverseTree())
+    {
+        elementOrder.emplace(elem.get(), elementOrder.size());
+    }
+
+    DocumentIndex index;
+    index.portElements.assign(_cache->portElementMap.begin(), _cache->portElementMap.end());
+    index.nodeDefs.assign(_cache->nodeDefMap.begin(), _cache->nodeDefMap.end());
+    index.implementations.assign(_cache->implementationMap.begin(), _cache->implementationMap.end());
+    sortByElementOrder(index.portElements, elementOrder);
+    sortByElementOrder(index.nodeDefs, elementOrder);
+    sortByElementOrder(index.implementations, elementOrder);
+    return index;
+}
+
+void Document::setElementIndex(const DocumentIndex& index)
+{
+    validateMutable();
+    std::lock_guard<std::mutex> guard(_cache->mutex);
+    _cache->portElementMap.clear();
+    _cache->nodeDefMap.clear();
+    _cache->implementationMap.clear();
+    _cache->pendingElements.clear();
+    _cache->portElementMap.insert(index.portElements.begin(), index.portElements.end());
+    _cache->nodeDefMap.insert(index.nodeDefs.begin(), index.nodeDefs.end());
+    _cache->implementationMap.insert(index.implementations.begin(), index.implementations.end());
+    _cache->valid = true;
+    _cache->upToDate.store(true, std::memory_order_release);
+}
+
+NodeDefCacheStats Document::getNodeDefCacheStats() const
+{
+    NodeDefCacheStats stats;
+    stats.hits = _nodeDefCacheHits.load(std::memory_order_relaxed);
+    stats.misses = _nodeDefCacheMisses.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void Document::resetNodeDefCacheStats()
+{
+    _nodeDefCacheHits.store(0, std::memory_order_relaxed);
+    _nodeDefCacheMisses.store(0, std::memory_order_relaxed);
+}
+
+void Document::invalidateNodeDefs(ConstElementPtr elem)
+{
+    for (; elem; elem = elem->getParent())
+    {
+        if (elem->getCategory() == NodeDef::CATEGORY)
+        {
+            invalidateAllNodeDefs();
+            return;
+        }
+        ConstNodePtr node = elem->asA<Node>();
+        if (node)
+        {
+            node->clearNodeDefCache();
+            return;
+        }
+    }
+}
+
+bool Document::isGeomBindingAttribute(const string& attrib)
 {
-    _cache->valid = false;
+    return attrib == GeomElement::GEOM_ATTRIBUTE ||
+           attrib == Collection::INCLUDE_GEOM_ATTRIBUTE ||
+           attrib == Collection::EXCLUDE_GEOM_ATTRIBUTE ||
+           attrib == Collection::INCLUDE_COLLECTION_ATTRIBUTE ||
+           attrib == GEOM_PREFIX_ATTRIBUTE ||
+           attrib == NAME_ATTRIBUTE ||
+           attrib == NAMESPACE_ATTRIBUTE;
+}
+
+void Document::onAddElement(ElementPtr parent, ElementPtr elem)
+{
+    // New elements carry no content, and are indexed as their attributes are set.
+    validateMutable();
+    if (elem->getCategory() == Collection::CATEGORY)
+    {
+        invalidateGeomBindings();
+    }
+    if (elem->getCategory() == NodeDef::CATEGORY)
+    {
+        invalidateAllNodeDefs();
+    }
+    else
+    {
+        invalidateNodeDefs(parent);
+    }
 }
 
-void Document::onRemoveElement(ElementPtr, ElementPtr)
+void Document::onRemoveElement(ElementPtr parent, ElementPtr elem)
 {
-    _cache->valid = false;
+    validateMutable();
+    _cache->removeTree(elem);
+    if (elem->getCategory() == Collection::CATEGORY)
+    {
+        invalidateGeomBindings();
+    }
+    if (elem->getCategory() == NodeDef::CATEGORY)
+    {
+        invalidateAllNodeDefs();
+    }
+    else
+    {
+        invalidateNodeDefs(parent);
+    }
 }
 
-void Document::onSetAttribute(ElementPtr, const string&, const string&)
+void Document::onSetAttribute(ElementPtr elem, const string& attrib, const string& value)
 {
-    _cache->valid = false;
+    validateMutable();
+    if (elem->getAttribute(attrib) != value)
+    {
+        if (attrib == NAMESPACE_ATTRIBUTE)
+        {
+            invalidateAllNodeDefs();
+        }
+        else
+        {
+            invalidateNodeDefs(elem);
+        }
+        if (isGeomBindingAttribute(attrib))
+        {
+            invalidateGeomBindings();
+        }
+    }
+    if (Cache::isKeyAttribute(attrib))
+    {
+        if (elem->getAttribute(attrib) != value)
+        {
+            _cache->invalidateElement(elem);
+        }
+    }
+    else if (attrib == NAMESPACE_ATTRIBUTE)
+    {
+        if (elem->getAttribute(attrib) != value)
+        {
+            _cache->invalidateTree(elem);
+        }
+    }
 }
 
-void Document::onRemoveAttribute(ElementPtr, const string&)
+void Document::onRemoveAttribute(ElementPtr elem, const string& attrib)
 {
-    _cache->valid = false;
+    validateMutable();
+    if (attrib == NAMESPACE_ATTRIBUTE)
+    {
+        invalidateAllNodeDefs();
+    }
+    else
+    {
+        invalidateNodeDefs(elem);
+    }
+    if (isGeomBindingAttribute(attrib))
+    {
+        invalidateGeomBindings();
+    }
+    if (Cache::isKeyAttribute(attrib))
+    {
+        _cache->invalidateElement(elem);
+    }
+    else if (attrib == NAMESPACE_ATTRIBUTE)
+    {
+        _cache->invalidateTree(elem);
+    }
 }
 
-void Document::onCopyContent(ElementPtr)
+void Document::onCopyContent(ElementPtr elem)
 {
-    _cache->valid = false;
+    validateMutable();
+    _cache->invalidateTree(elem);
+    invalidateGeomBindings();
+    if (elem == getSelf())
+    {
+        invalidateAllNodeDefs();
+    }
+    else
+    {
+        invalidateNodeDefs(elem);
+    }
 }
 
-void Document::onClearContent(ElementPtr)
+void Document::onClearContent(ElementPtr elem)
 {
-    _cache->valid = false;
+    validateMutable();
+    _cache->invalidateTree(elem);
+    invalidateGeomBindings();
+    if (elem == getSelf())
+    {
+        invalidateAllNodeDefs();
+    }
+    else
+    {
+        invalidateNodeDefs(elem);
+    }
 }
 
 } // namespace MaterialX
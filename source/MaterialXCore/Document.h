@@ -14,10 +14,15 @@
 #include <MaterialXCore/Look.h>
 #include <MaterialXCore/Node.h>
 
+#include <atomic>
+
 namespace MaterialX
 {
 
 class Document;
+class DocumentIndex;
+class NodeDefCacheStats;
+class ValidationOptions;
 
 /// A shared pointer to a Document
 using DocumentPtr = shared_ptr<Document>;
@@ -29,6 +34,12 @@ using ConstDocumentPtr = shared_ptr<const Document>;
 /// MaterialX ownership hierarchy.
 ///
 /// Use the factory function createDocument() to create a Document instance.
+///
+/// Queries such as getMatchingNodeDefs may be called concurrently from
+/// multiple threads, as long as the document is not modified while they run.
+/// Once the internal lookup cache is up to date, these queries do not take
+/// any locks.  Calling freeze() makes this contract explicit, by building all
+/// lookup data up front and rejecting any further modification.
 class Document : public GraphElement
 {
   public:
@@ -36,9 +47,18 @@ class Document : public GraphElement
     virtual ~Document();
 
     /// Create a new document of the given subclass.
-    template <class T> static shared_ptr<T> createDocument()
-    {
-        shared_ptr<T> doc = std::make_shared<T>(ElementPtr(), EMPTY_STRING);
+    /// @param useArena If true, then the document and all of its elements are
+    ///    allocated from a shared Arena, whose memory is released in a single
+    ///    step once the document and its elements have been destroyed.  This
+    ///    reduces allocation overhead for documents that are loaded and
+    ///    discarded as a unit.  Defaults to false.
+    template <class T> static shared_ptr<T> createDocument(bool useArena = false)
+    {
+        ArenaPtr arena = useArena ? std::make_shared<Arena>() : nullptr;
+        shared_ptr<T> doc = arena ?
+            std::allocate_shared<T>(ArenaAllocator<T>(arena), ElementPtr(), EMPTY_STRING) :
+            std::make_shared<T>(ElementPtr(), EMPTY_STRING);
+        doc->_arena = arena;
         doc->initialize();
         return doc;
     }
@@ -49,8 +69,12 @@ class Document : public GraphElement
     /// Create a deep copy of the document.
     virtual DocumentPtr copy() const
     {
-        DocumentPtr doc = createDocument<Document>();
+        DocumentPtr doc = createDocument<Document>(_arena != nullptr);
         doc->copyContentFrom(getSelf());
+        for (const ConstDocumentPtr& library : _libraries)
+        {
+            doc->referenceLibrary(library);
+        }
         return doc;
     }
 
@@ -63,9 +87,92 @@ class Document : public GraphElement
     ///    import function.  Defaults to a null pointer.
     void importLibrary(const ConstDocumentPtr& library, const CopyOptions* copyOptions = nullptr);
 
+    /// @name Library References
+    /// @{
+
+    /// Reference the given library document from this document, sharing its
+    /// content rather than copying it.
+    ///
+    /// The top-level definition elements of a referenced library, including
+    /// its nodedefs, implementations, nodegraphs, typedefs, geompropdefs,
+    /// unitdefs and unittypedefs, are returned by the corresponding queries
+    /// of this document, and are used to resolve references from its
+    /// elements, as if the library had been imported.  Elements of this
+    /// document take precedence over library elements with the same name,
+    /// and earlier references take precedence over later ones.
+    ///
+    /// Referenced elements remain children of the library document, so they
+    /// are not traversed, validated or written as part of this document, and
+    /// their own queries are resolved against the library.  To edit a
+    /// referenced element, first create a local copy with
+    /// copyReferencedElement.
+    ///
+    /// The cost of a reference is independent of the size of the library,
+    /// and a single library may be shared by any number of documents across
+    /// threads.
+    /// @param library The library document to be referenced, which must be
+    ///    frozen.
+    /// @throws Exception if the library document is not frozen.
+    void referenceLibrary(const ConstDocumentPtr& library);
+
+    /// Return the library documents referenced by this document.
+    const vector<ConstDocumentPtr>& getReferencedLibraries() const
+    {
+        return _libraries;
+    }
+
+    /// Remove all library references from this document.
+    void clearReferencedLibraries();
+
+    /// Return the top-level element with the given name from the libraries
+    /// referenced by this document, if any.  Elements of this document itself
+    /// are not considered.
+    ElementPtr getReferencedElement(const string& name) const;
+
+    /// Copy the referenced library element with the given name into this
+    /// document, where it may be edited and takes precedence over the shared
+    /// library element.  If this document already contains an element with
+    /// the given name, then that element is returned unchanged.
+    /// @return The local copy of the element, or an empty shared pointer if
+    ///    no element with the given name is found.
+    ElementPtr copyReferencedElement(const string& name);
+
+    /// @}
+
     /// Get a list of source URI's referenced by the document
     StringSet getReferencedSourceUris() const;
 
+    /// Return the allocation arena of the document, or an empty shared
+    /// pointer if the document uses the default allocator.
+    const ArenaPtr& getArena() const
+    {
+        return _arena;
+    }
+
+    /// @name Freezing
+    /// @{
+
+    /// Freeze the document, precomputing all name-resolution data and making
+    /// the document immutable.  Subsequent calls that modify the document or
+    /// its elements throw an ExceptionFrozenDocument.
+    ///
+    /// All const methods of a frozen document and its elements may be called
+    /// concurrently from multiple threads without locking.  In particular,
+    /// concurrent ShaderGenerator::generate calls against a frozen document
+    /// are safe, provided that each thread uses its own GenContext.
+    ///
+    /// A frozen document cannot be unfrozen, but an editable deep copy may be
+    /// created with Document::copy.
+    void freeze();
+
+    /// Return true if the document has been frozen.
+    bool isFrozen() const
+    {
+        return _frozen;
+    }
+
+    /// @}
+
     /// @name NodeGraph Elements
     /// @{
 
@@ -82,13 +189,13 @@ class Document : public GraphElement
     /// Return the NodeGraph, if any, with the given name.
     NodeGraphPtr getNodeGraph(const string& name) const
     {
-        return getChildOfType<NodeGraph>(name);
+        return getLibraryChildOfType<NodeGraph>(name);
     }
 
     /// Return a vector of all NodeGraph elements in the document.
     vector<NodeGraphPtr> getNodeGraphs() const
     {
-        return getChildrenOfType<NodeGraph>();
+        return getLibraryChildrenOfType<NodeGraph>();
     }
 
     /// Remove the NodeGraph, if any, with the given name.
@@ -206,13 +313,13 @@ class Document : public GraphElement
     /// Return the GeomPropDef, if any, with the given name.
     GeomPropDefPtr getGeomPropDef(const string& name) const
     {
-        return getChildOfType<GeomPropDef>(name);
+        return getLibraryChildOfType<GeomPropDef>(name);
     }
 
     /// Return a vector of all GeomPropDef elements in the document.
     vector<GeomPropDefPtr> getGeomPropDefs() const
     {
-        return getChildrenOfType<GeomPropDef>();
+        return getLibraryChildrenOfType<GeomPropDef>();
     }
 
     /// Remove the GeomPropDef, if any, with the given name.
@@ -334,13 +441,13 @@ class Document : public GraphElement
     /// Return the TypeDef, if any, with the given name.
     TypeDefPtr getTypeDef(const string& name) const
     {
-        return getChildOfType<TypeDef>(name);
+        return getLibraryChildOfType<TypeDef>(name);
     }
 
     /// Return a vector of all TypeDef elements in the document.
     vector<TypeDefPtr> getTypeDefs() const
     {
-        return getChildrenOfType<TypeDef>();
+        return getLibraryChildrenOfType<TypeDef>();
     }
 
     /// Remove the TypeDef, if any, with the given name.
@@ -381,13 +488,13 @@ class Document : public GraphElement
     /// Return the NodeDef, if any, with the given name.
     NodeDefPtr getNodeDef(const string& name) const
     {
-        return getChildOfType<NodeDef>(name);
+        return getLibraryChildOfType<NodeDef>(name);
     }
 
     /// Return a vector of all NodeDef elements in the document.
     vector<NodeDefPtr> getNodeDefs() const
     {
-        return getChildrenOfType<NodeDef>();
+        return getLibraryChildrenOfType<NodeDef>();
     }
 
     /// Remove the NodeDef, if any, with the given name.
@@ -480,13 +587,13 @@ class Document : public GraphElement
     /// Return the Implementation, if any, with the given name.
     ImplementationPtr getImplementation(const string& name) const
     {
-        return getChildOfType<Implementation>(name);
+        return getLibraryChildOfType<Implementation>(name);
     }
 
     /// Return a vector of all Implementation elements in the document.
     vector<ImplementationPtr> getImplementations() const
     {
-        return getChildrenOfType<Implementation>();
+        return getLibraryChildrenOfType<Implementation>();
     }
 
     /// Remove the Implementation, if any, with the given name.
@@ -516,13 +623,13 @@ class Document : public GraphElement
     /// Return the UnitDef, if any, with the given name.
     UnitDefPtr getUnitDef(const string& name) const
     {
-        return getChildOfType<UnitDef>(name);
+        return getLibraryChildOfType<UnitDef>(name);
     }
 
     /// Return a vector of all Member elements in the TypeDef.
     vector<UnitDefPtr> getUnitDefs() const
     {
-        return getChildrenOfType<UnitDef>();
+        return getLibraryChildrenOfType<UnitDef>();
     }
 
     /// Remove the UnitDef, if any, with the given name.
@@ -547,13 +654,13 @@ class Document : public GraphElement
     /// Return the UnitTypeDef, if any, with the given name.
     UnitTypeDefPtr getUnitTypeDef(const string& name) const
     {
-        return getChildOfType<UnitTypeDef>(name);
+        return getLibraryChildOfType<UnitTypeDef>(name);
     }
 
     /// Return a vector of all UnitTypeDef elements in the document.
     vector<UnitTypeDefPtr> getUnitTypeDefs() const
     {
-        return getChildrenOfType<UnitTypeDef>();
+        return getLibraryChildrenOfType<UnitTypeDef>();
     }
 
     /// Remove the UnitTypeDef, if any, with the given name.
@@ -619,6 +726,49 @@ class Document : public GraphElement
         return getAttribute(CMS_CONFIG_ATTRIBUTE);
     }
 
+    /// @}
+    /// @name Element Index
+    /// @{
+
+    /// Return the entries of the lookup cache of this document, which are
+    /// built on demand by traversing the document.
+    DocumentIndex getElementIndex() const;
+
+    /// Replace the entries of the lookup cache of this document with the
+    /// given index, in place of the traversal that would otherwise be
+    /// performed on the next lookup.  This is intended for readers of
+    /// serialized formats that store a prebuilt index, and the given index
+    /// must match the current content of the document.  An exception is
+    /// thrown if the document is frozen.
+    void setElementIndex(const DocumentIndex& index);
+
+    /// @}
+    /// @name NodeDef Resolution Cache
+    /// @{
+
+    /// Enable or disable the recording of hit and miss counts for the cache
+    /// of resolved nodedefs that is maintained by Node::getNodeDef.  Counts
+    /// are shared by all threads that query the document, so they are only
+    /// recorded when enabled.  Defaults to false.
+    void setNodeDefCacheStatsEnabled(bool enabled)
+    {
+        _nodeDefCacheStatsEnabled.store(enabled, std::memory_order_relaxed);
+    }
+
+    /// Return true if nodedef cache statistics are being recorded.
+    bool isNodeDefCacheStatsEnabled() const
+    {
+        return _nodeDefCacheStatsEnabled.load(std::memory_order_relaxed);
+    }
+
+    /// Return hit and miss counts for the cache of resolved nodedefs that is
+    /// maintained by Node::getNodeDef, recorded while statistics were
+    /// enabled.
+    NodeDefCacheStats getNodeDefCacheStats() const;
+
+    /// Reset the hit and miss counts of the nodedef resolution cache.
+    void resetNodeDefCacheStats();
+
     /// @}
     /// @name Validation
     /// @{
@@ -630,6 +780,20 @@ class Document : public GraphElement
     /// @return True if the document passes all tests, false otherwise.
     bool validate(string* message = nullptr) const override;
 
+    /// Validate that the given document is consistent with the MaterialX
+    /// specification, gathering a structured diagnostic for each error.
+    ///
+    /// The top-level children of the document are validated concurrently
+    /// when the given options request more than one thread.  Diagnostics for
+    /// the document element itself are listed first, followed by those of
+    /// each top-level child in document order.
+    /// @param diagnostics The output vector of diagnostics, which is cleared
+    ///    before validation begins.
+    /// @param options The validation options, including the thread count and
+    ///    an optional limit on the number of errors to gather.
+    /// @return True if the document passes all tests, false otherwise.
+    bool validate(ValidationDiagnosticVec& diagnostics, const ValidationOptions& options) const;
+
     /// @}
     /// @name Callbacks
     /// @{
@@ -677,9 +841,177 @@ class Document : public GraphElement
     static const string CMS_ATTRIBUTE;
     static const string CMS_CONFIG_ATTRIBUTE;
 
+  private:
+    // Throw an ExceptionFrozenDocument if the document is frozen.
+    void validateMutable() const;
+
+    friend class Element;
+
+    // Invalidate any cached nodedef resolutions that may depend on the given
+    // element.  Changes within a node clear the cache of that node, while
+    // changes within a nodedef invalidate the caches of all nodes.
+    void invalidateNodeDefs(ConstElementPtr elem);
+
+    // Invalidate the cached nodedef resolutions of all nodes.
+    void invalidateAllNodeDefs()
+    {
+        _nodeDefRevision.fetch_add(1, std::memory_order_release);
+    }
+
+    friend class Node;
+
+    // Invalidate the compiled geometry strings of all geometric elements and
+    // collections.
+    void invalidateGeomBindings()
+    {
+        _geomRevision.fetch_add(1, std::memory_order_release);
+    }
+
+    // Return true if the given attribute contributes to the compiled geometry
+    // strings of geometric elements and collections.
+    static bool isGeomBindingAttribute(const string& attrib);
+
+    friend class GeomElement;
+    friend class Collection;
+
+    // Return the child of the given type and name from this document or its
+    // referenced libraries.
+    template <class T> shared_ptr<T> getLibraryChildOfType(const string& name) const
+    {
+        shared_ptr<T> child = getChildOfType<T>(name);
+        if (child || _libraries.empty())
+        {
+            return child;
+        }
+        return std::dynamic_pointer_cast<T>(getReferencedElement(name));
+    }
+
+    // Return all children of the given type from this document and its
+    // referenced libraries, omitting library elements that are shadowed by
+    // an element of the same name.
+    template <class T> vector<shared_ptr<T>> getLibraryChildrenOfType() const
+    {
+        vector<shared_ptr<T>> children = getChildrenOfType<T>();
+        if (_libraries.empty())
+        {
+            return children;
+        }
+        StringSet names;
+        for (const ElementPtr& child : getChildren())
+        {
+            names.insert(child->getName());
+        }
+        for (const ConstDocumentPtr& library : _libraries)
+        {
+            for (const shared_ptr<T>& child : library->getLibraryChildrenOfType<T>())
+            {
+                if (names.insert(child->getQualifiedName(child->getName())).second)
+                {
+                    children.push_back(child);
+                }
+            }
+        }
+        return children;
+    }
+
+    // Return true if the given library element is shadowed by an element of
+    // this document or an earlier library reference.
+    bool isReferenceShadowed(ConstElementPtr elem) const;
+
   private:
     class Cache;
     std::unique_ptr<Cache> _cache;
+    ArenaPtr _arena;
+    vector<ConstDocumentPtr> _libraries;
+    bool _frozen;
+
+    std::atomic<size_t> _nodeDefRevision;
+    std::atomic<bool> _nodeDefCacheStatsEnabled;
+    mutable std::atomic<size_t> _nodeDefCacheHits;
+    mutable std::atomic<size_t> _nodeDefCacheMisses;
+
+    std::atomic<size_t> _geomRevision;
+};
+
+/// @class ValidationOptions
+/// A set of options for controlling the behavior of document validation.
+class ValidationOptions
+{
+  public:
+    ValidationOptions() :
+        threadCount(1),
+        maxErrors(0)
+    {
+    }
+    ~ValidationOptions() { }
+
+    /// The number of threads across which the top-level children of the
+    /// document are validated.  A value of zero selects the hardware
+    /// concurrency of the system.  Defaults to one.
+    unsigned int threadCount;
+
+    /// If non-zero, validation stops early once this many errors have been
+    /// found, and no more than this many diagnostics are returned.  When
+    /// validating on multiple threads, the errors that are found before
+    /// stopping may vary between runs.  Defaults to zero.
+    size_t maxErrors;
+};
+
+/// @class DocumentIndex
+/// The entries of the lookup cache of a Document, each of which maps a
+/// qualified name to an element that references it.  Entries are listed in
+/// the order of a depth-first traversal of the document.
+class DocumentIndex
+{
+  public:
+    DocumentIndex() { }
+    ~DocumentIndex() { }
+
+    /// Port elements, keyed by the qualified names of their connected nodes.
+    vector<std::pair<string, PortElementPtr>> portElements;
+
+    /// Nodedefs, keyed by their qualified node strings.
+    vector<std::pair<string, NodeDefPtr>> nodeDefs;
+
+    /// Implementations and nodegraphs, keyed by their qualified nodedef
+    /// strings.
+    vector<std::pair<string, InterfaceElementPtr>> implementations;
+};
+
+/// @class NodeDefCacheStats
+/// Hit and miss counts for the nodedef resolution cache of a Document.
+class NodeDefCacheStats
+{
+  public:
+    NodeDefCacheStats() :
+        hits(0),
+        misses(0)
+    {
+    }
+    ~NodeDefCacheStats() { }
+
+    /// Return the fraction of nodedef lookups that were served from the
+    /// cache, or zero if no lookups have been made.
+    double getHitRate() const
+    {
+        size_t total = hits + misses;
+        return total ? (double) hits / (double) total : 0.0;
+    }
+
+    /// The number of nodedef lookups that were served from the cache.
+    size_t hits;
+
+    /// The number of nodedef lookups that required a full resolution.
+    size_t misses;
+};
+
+/// @class ExceptionFrozenDocument
+/// An exception that is thrown when an attempt is made to modify a frozen
+/// Document.
+class ExceptionFrozenDocument : public Exception
+{
+  public:
+    using Exception::Exception;
 };
 
 /// @class ScopedUpdate
@@ -727,8 +1059,10 @@ class ScopedDisableCallbacks
 };
 
 /// Create a new Document.
+/// @param useArena If true, then the document and its elements are allocated
+///    from a shared Arena.  Defaults to false.
 /// @relates Document
-DocumentPtr createDocument();
+DocumentPtr createDocument(bool useArena = false);
 
 } // namespace MaterialX
 
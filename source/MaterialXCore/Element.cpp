@@ -9,7 +9,10 @@
 #include <MaterialXCore/Node.h>
 #include <MaterialXCore/Util.h>
 
+#include <mutex>
 #include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace MaterialX
 {
@@ -44,6 +47,58 @@ const string ValueElement::UNITTYPE_ATTRIBUTE = "unittype";
 
 Element::CreatorMap Element::_creatorMap;
 
+namespace {
+
+// A process-wide table of interned attribute name vectors.  The table is
+// divided into shards, each with its own lock, so that concurrent loads
+// rarely contend for the same lock.
+class AttributeNameTable
+{
+  public:
+    const StringVec* intern(const StringVec& names)
+    {
+        Shard& shard = _shards[(hashNames(names) >> 16) % SHARD_COUNT];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        return &*shard.names.insert(names).first;
+    }
+
+  private:
+    static size_t hashNames(const StringVec& names)
+    {
+        size_t hash = names.size();
+        for (const string& name : names)
+        {
+            hash = hash * 31 + std::hash<string>()(name);
+        }
+        return hash;
+    }
+
+    struct NamesHash
+    {
+        size_t operator()(const StringVec& names) const
+        {
+            return hashNames(names);
+        }
+    };
+
+    static const size_t SHARD_COUNT = 16;
+
+    struct alignas(64) Shard
+    {
+        std::mutex mutex;
+        std::unordered_set<StringVec, NamesHash> names;
+    };
+    Shard _shards[SHARD_COUNT];
+};
+
+AttributeNameTable& getAttributeNameTable()
+{
+    static AttributeNameTable table;
+    return table;
+}
+
+} // anonymous namespace
+
 //
 // Element methods
 //
@@ -57,12 +112,10 @@ bool Element::operator==(const Element& rhs) const
     }
 
     // Compare attributes.
-    if (getAttributeNames() != rhs.getAttributeNames())
-        return false;
-    for (const string& attr : rhs.getAttributeNames())
+    if (_attributeNames != rhs._attributeNames ||
+        _attributeValues != rhs._attributeValues)
     {
-        if (getAttribute(attr) != rhs.getAttribute(attr))
-            return false;
+        return false;
     }
 
     // Compare children.
@@ -172,6 +225,18 @@ void Element::registerChildElement(ElementPtr child)
 
     _childMap[child->getName()] = child;
     _childOrder.push_back(child);
+
+    const Element& childRef = *child;
+    std::type_index type(typeid(childRef));
+    for (auto& entry : _childTypeIndex)
+    {
+        if (entry.first == type)
+        {
+            entry.second.push_back(child);
+            return;
+        }
+    }
+    _childTypeIndex.emplace_back(type, vector<ElementPtr>(1, child));
 }
 
 void Element::unregisterChildElement(ElementPtr child)
@@ -182,9 +247,26 @@ void Element::unregisterChildElement(ElementPtr child)
     ScopedUpdate update(doc);
     doc->onRemoveElement(getSelf(), child);
 
+    // Search from the back of each vector, since recently added children
+    // are the most likely to be removed.
     _childMap.erase(child->getName());
     _childOrder.erase(
-        std::find(_childOrder.begin(), _childOrder.end(), child));
+        std::find(_childOrder.rbegin(), _childOrder.rend(), child).base() - 1);
+
+    const Element& childRef = *child;
+    std::type_index type(typeid(childRef));
+    for (auto it = _childTypeIndex.begin(); it != _childTypeIndex.end(); ++it)
+    {
+        if (it->first == type)
+        {
+            it->second.erase(std::find(it->second.rbegin(), it->second.rend(), child).base() - 1);
+            if (it->second.empty())
+            {
+                _childTypeIndex.erase(it);
+            }
+            break;
+        }
+    }
 }
 
 int Element::getChildIndex(const string& name) const
@@ -200,6 +282,8 @@ int Element::getChildIndex(const string& name) const
 
 void Element::setChildIndex(const string& name, int index)
 {
+    getDocument()->validateMutable();
+
     ElementPtr child = getChild(name);
     vector<ElementPtr>::iterator it = std::find(_childOrder.begin(), _childOrder.end(), child);
     if (it == _childOrder.end())
@@ -214,6 +298,55 @@ void Element::setChildIndex(const string& name, int index)
 
     _childOrder.erase(it);
     _childOrder.insert(_childOrder.begin() + (size_t) index, child);
+
+    reindexChildren();
+}
+
+void Element::setChildOrder(const vector<ElementPtr>& order)
+{
+    getDocument()->validateMutable();
+
+    if (order.size() != _childOrder.size())
+    {
+        throw Exception("Invalid child order");
+    }
+    StringSet names;
+    for (const ElementPtr& child : order)
+    {
+        if (!child || getChild(child->getName()) != child || !names.insert(child->getName()).second)
+        {
+            throw Exception("Invalid child order");
+        }
+    }
+    _childOrder = order;
+    reindexChildren();
+}
+
+void Element::setSourceUri(const string& sourceUri)
+{
+    getDocument()->validateMutable();
+    _sourceUri = sourceUri;
+}
+
+void Element::reindexChildren()
+{
+    for (auto& entry : _childTypeIndex)
+    {
+        entry.second.clear();
+    }
+    for (const ElementPtr& child : _childOrder)
+    {
+        const Element& childRef = *child;
+        std::type_index type(typeid(childRef));
+        for (auto& entry : _childTypeIndex)
+        {
+            if (entry.first == type)
+            {
+                entry.second.push_back(child);
+                break;
+            }
+        }
+    }
 }
 
 void Element::removeChild(const string& name)
@@ -227,7 +360,7 @@ void Element::removeChild(const string& name)
     unregisterChildElement(it->second);
 }
 
-void Element::setAttribute(const string& attrib, const string& value)
+void Element::setAttribute(const string& attrib, string&& value)
 {
     DocumentPtr doc = getDocument();
 
@@ -235,17 +368,23 @@ void Element::setAttribute(const string& attrib, const string& value)
     ScopedUpdate update(doc);
     doc->onSetAttribute(getSelf(), attrib, value);
 
-    if (!_attributeMap.count(attrib))
+    size_t index = findAttribute(attrib);
+    if (index != string::npos)
+    {
+        _attributeValues[index] = std::move(value);
+    }
+    else
     {
-        _attributeOrder.push_back(attrib);
+        _attributeNames = appendAttributeName(_attributeNames, attrib);
+        _attributeValues.push_back(std::move(value));
     }
-    _attributeMap[attrib] = value;
+    onAttributeChange(attrib);
 }
 
 void Element::removeAttribute(const string& attrib)
 {
-    StringMap::iterator it = _attributeMap.find(attrib);
-    if (it != _attributeMap.end())
+    size_t index = findAttribute(attrib);
+    if (index != string::npos)
     {
         DocumentPtr doc = getDocument();
 
@@ -253,12 +392,45 @@ void Element::removeAttribute(const string& attrib)
         ScopedUpdate update(doc);
         doc->onRemoveAttribute(getSelf(), attrib);
 
-        _attributeMap.erase(it);
-        _attributeOrder.erase(
-            std::find(_attributeOrder.begin(), _attributeOrder.end(), attrib));
+        _attributeNames = removeAttributeName(_attributeNames, index);
+        _attributeValues.erase(_attributeValues.begin() + index);
+        onAttributeChange(attrib);
     }
 }
 
+ArenaPtr Element::getArena() const
+{
+    return getDocument()->getArena();
+}
+
+const StringVec* Element::getEmptyAttributeNames()
+{
+    static const StringVec* emptyNames = getAttributeNameTable().intern(StringVec());
+    return emptyNames;
+}
+
+const StringVec* Element::appendAttributeName(const StringVec* names, const string& attrib)
+{
+    // Cache the transitions between interned vectors on each thread, so that
+    // elements with common attributes are built without taking a lock.
+    thread_local std::unordered_map<const StringVec*, std::unordered_map<string, const StringVec*>> transitions;
+    const StringVec*& appended = transitions[names][attrib];
+    if (!appended)
+    {
+        StringVec newNames = *names;
+        newNames.push_back(attrib);
+        appended = getAttributeNameTable().intern(newNames);
+    }
+    return appended;
+}
+
+const StringVec* Element::removeAttributeName(const StringVec* names, size_t index)
+{
+    StringVec newNames = *names;
+    newNames.erase(newNames.begin() + index);
+    return getAttributeNameTable().intern(newNames);
+}
+
 template<class T> shared_ptr<T> Element::asA()
 {
     return std::dynamic_pointer_cast<T>(getSelf());
@@ -313,6 +485,19 @@ ElementPtr Element::addChildOfCategory(const string& category,
     return child;
 }
 
+void Element::attachChild(ElementPtr child)
+{
+    if (child->getParent() != getSelf())
+    {
+        throw Exception("Element is not a child of " + getName() + ": " + child->getName());
+    }
+    if (_childMap.count(child->getName()))
+    {
+        throw Exception("Child name is not unique: " + child->getName());
+    }
+    registerChildElement(child);
+}
+
 ElementPtr Element::getRoot()
 {
     ElementPtr root = _root.lock();
@@ -368,6 +553,11 @@ GraphIterator Element::traverseGraph(ConstMaterialPtr material) const
     return GraphIterator(getSelfNonConst(), material);
 }
 
+GraphIterator Element::traverseGraphUnique(ConstMaterialPtr material) const
+{
+    return GraphIterator(getSelfNonConst(), material, true);
+}
+
 Edge Element::getUpstreamEdge(ConstMaterialPtr, size_t) const
 {
     return NULL_EDGE;
@@ -393,8 +583,9 @@ void Element::copyContentFrom(const ConstElementPtr& source, const CopyOptions*
     doc->onCopyContent(getSelf());
 
     _sourceUri = source->_sourceUri;
-    _attributeMap = source->_attributeMap;
-    _attributeOrder = source->_attributeOrder;
+    _attributeNames = source->_attributeNames;
+    _attributeValues = source->_attributeValues;
+    onAttributeChange(EMPTY_STRING);
 
     for (const ConstElementPtr& child : source->getChildren())
     {
@@ -428,8 +619,9 @@ void Element::clearContent()
     doc->onClearContent(getSelf());
 
     _sourceUri = EMPTY_STRING;
-    _attributeMap.clear();
-    _attributeOrder.clear();
+    _attributeNames = getEmptyAttributeNames();
+    _attributeValues.clear();
+    onAttributeChange(EMPTY_STRING);
 
     vector<ElementPtr> children = getChildren();
     for (ElementPtr child : children)
@@ -447,9 +639,17 @@ bool Element::validate(string* message) const
         bool validInherit = getInheritsFrom() && getInheritsFrom()->getCategory() == getCategory();
         validateRequire(validInherit, res, message, "Invalid element inheritance");
     }
-    for (ElementPtr child : getChildren())
+    ValidationCollector* collector = ValidationCollector::getActive();
+    if (!collector || collector->shallowElement != this)
     {
-        res = child->validate(message) && res;
+        for (ElementPtr child : getChildren())
+        {
+            if (collector && collector->isStopped())
+            {
+                break;
+            }
+            res = child->validate(message) && res;
+        }
     }
     validateRequire(!hasInheritanceCycle(), res, message, "Cycle in element inheritance chain");
     return res;
@@ -471,7 +671,7 @@ StringResolverPtr Element::createStringResolver(const string& geom,
     {
         for (GeomInfoPtr geomInfo : getDocument()->getGeomInfos())
         {
-            if (!geomStringsMatch(geom, geomInfo->getActiveGeom()))
+            if (!geomInfo->matchesGeomString(geom))
                 continue;
             for (TokenPtr token : geomInfo->getTokens())
             {
@@ -515,6 +715,17 @@ string Element::asString() const
     return res;
 }
 
+ElementPtr Element::resolveReferencedName(const string& name) const
+{
+    ConstDocumentPtr doc = getRoot()->asA<Document>();
+    if (!doc || doc->getReferencedLibraries().empty())
+    {
+        return nullptr;
+    }
+    ElementPtr elem = doc->getReferencedElement(getQualifiedName(name));
+    return elem ? elem : doc->getReferencedElement(name);
+}
+
 void Element::validateRequire(bool expression, bool& res, string* message, string errorDesc) const
 {
     if (!expression)
@@ -524,9 +735,52 @@ void Element::validateRequire(bool expression, bool& res, string* message, strin
         {
             *message += errorDesc + ": " + asString() + "\n";
         }
+        ValidationCollector* collector = ValidationCollector::getActive();
+        if (collector)
+        {
+            collector->report(*this, errorDesc);
+        }
     }
 }
 
+//
+// Element::ValidationCollector methods
+//
+
+Element::ValidationCollector::ValidationCollector(ValidationDiagnosticVec& diagnostics,
+                                                  std::atomic<size_t>& errorCount,
+                                                  size_t maxErrors) :
+    shallowElement(nullptr),
+    _diagnostics(diagnostics),
+    _errorCount(errorCount),
+    _maxErrors(maxErrors),
+    _previous(getActive())
+{
+    getActiveSlot() = this;
+}
+
+Element::ValidationCollector::~ValidationCollector()
+{
+    getActiveSlot() = _previous;
+}
+
+void Element::ValidationCollector::report(const Element& elem, const string& rule)
+{
+    _diagnostics.emplace_back(elem.getNamePath(), rule, rule + ": " + elem.asString());
+    _errorCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+Element::ValidationCollector* Element::ValidationCollector::getActive()
+{
+    return getActiveSlot();
+}
+
+Element::ValidationCollector*& Element::ValidationCollector::getActiveSlot()
+{
+    static thread_local ValidationCollector* active = nullptr;
+    return active;
+}
+
 //
 // TypedElement methods
 //
@@ -553,6 +807,32 @@ string ValueElement::getResolvedValueString(StringResolverPtr resolver) const
     return resolver->resolve(getValueString(), getType());
 }
 
+ConstValuePtr ValueElement::getCachedValue() const
+{
+    // The cached value may be read by concurrent queries of a shared
+    // document, so it is accessed atomically.
+    ConstValuePtr value = std::atomic_load(&_cachedValue);
+    if (!value && hasValue())
+    {
+        value = Value::createValueFromStrings(getValueString(), getType());
+        std::atomic_store(&_cachedValue, value);
+    }
+    return value;
+}
+
+ValuePtr ValueElement::getResolvedValue(StringResolverPtr resolver) const
+{
+    if (!hasValue())
+    {
+        return ValuePtr();
+    }
+    if (!StringResolver::isResolvedType(getType()))
+    {
+        return getValue();
+    }
+    return Value::createValueFromStrings(getResolvedValueString(resolver), getType());
+}
+
 ValuePtr ValueElement::getBoundValue(ConstMaterialPtr material) const
 {
     ElementPtr upstreamElem = getUpstreamElement(material);
@@ -592,6 +872,14 @@ ValuePtr ValueElement::getDefaultValue() const
     return ValuePtr();
 }
 
+void ValueElement::onAttributeChange(const string& attrib)
+{
+    if (attrib.empty() || attrib == VALUE_ATTRIBUTE || attrib == TYPE_ATTRIBUTE)
+    {
+        std::atomic_store(&_cachedValue, ConstValuePtr());
+    }
+}
+
 const string& ValueElement::getActiveUnit() const
 {
     // Return the unit, if any, stored in our declaration.
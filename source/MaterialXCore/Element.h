@@ -11,6 +11,11 @@
 
 #include <MaterialXCore/Library.h>
 
+#include <MaterialXCore/Arena.h>
+
+#include <atomic>
+#include <typeindex>
+
 #include <MaterialXCore/Traversal.h>
 #include <MaterialXCore/Util.h>
 #include <MaterialXCore/Value.h>
@@ -26,6 +31,7 @@ class StringResolver;
 class Document;
 class Material;
 class CopyOptions;
+class ValidationDiagnostic;
 
 /// A shared pointer to an Element
 using ElementPtr = shared_ptr<Element>;
@@ -53,9 +59,23 @@ using StringResolverPtr = shared_ptr<StringResolver>;
 /// A hash map from strings to elements
 using ElementMap = std::unordered_map<string, ElementPtr>;
 
+/// A vector of validation diagnostics
+using ValidationDiagnosticVec = vector<ValidationDiagnostic>;
+
 /// A standard function taking an ElementPtr and returning a boolean.
 using ElementPredicate = std::function<bool(ConstElementPtr)>;
 
+/// A type trait that is true for concrete Element subclasses, which declare
+/// a static CATEGORY string.
+template <class T> class IsConcreteElement
+{
+    template <class U> static char test(decltype(&U::CATEGORY));
+    template <class U> static long test(...);
+
+  public:
+    static const bool value = sizeof(test<T>(nullptr)) == sizeof(char);
+};
+
 /// @class Element
 /// The base class for MaterialX elements.
 ///
@@ -67,6 +87,7 @@ class Element : public std::enable_shared_from_this<Element>
     Element(ElementPtr parent, const string& category, const string& name) :
         _category(category),
         _name(name),
+        _attributeNames(getEmptyAttributeNames()),
         _parent(parent),
         _root(parent ? parent->getRoot() : nullptr)
     {
@@ -461,6 +482,13 @@ class Element : public std::enable_shared_from_this<Element>
                                   string name = EMPTY_STRING,
                                   bool registerChild = true);
 
+    /// Register a child element that was created by addChildOfCategory with
+    /// registerChild set to false, making it a member of this element tree.
+    /// @throws Exception if the given element was not created as a child of
+    ///     this element, or if a child of this element already possesses its
+    ///     name.
+    void attachChild(ElementPtr child);
+
     /// Return the child element, if any, with the given name.
     ElementPtr getChild(const string& name) const
     {
@@ -490,7 +518,22 @@ class Element : public std::enable_shared_from_this<Element>
     template<class T> vector< shared_ptr<T> > getChildrenOfType(const string& category = EMPTY_STRING) const
     {
         vector< shared_ptr<T> > children;
-        for (ElementPtr child : _childOrder)
+        if (IsConcreteElement<T>::value)
+        {
+            // Concrete subclasses are looked up in the child type index.
+            const vector<ElementPtr>* indexed = getIndexedChildren(typeid(T));
+            if (!indexed)
+                return children;
+            children.reserve(indexed->size());
+            for (const ElementPtr& child : *indexed)
+            {
+                if (!category.empty() && child->getCategory() != category)
+                    continue;
+                children.push_back(std::static_pointer_cast<T>(child));
+            }
+            return children;
+        }
+        for (const ElementPtr& child : _childOrder)
         {
             shared_ptr<T> instance = child->asA<T>();
             if (!instance)
@@ -502,10 +545,38 @@ class Element : public std::enable_shared_from_this<Element>
         return children;
     }
 
+    /// Return the number of child elements that are instances of the given
+    /// concrete subclass.
+    template<class T> size_t getChildCountOfType() const
+    {
+        static_assert(IsConcreteElement<T>::value, "A concrete Element subclass is required");
+        const vector<ElementPtr>* indexed = getIndexedChildren(typeid(T));
+        return indexed ? indexed->size() : 0;
+    }
+
+    /// Return the child element at the given index among those that are
+    /// instances of the given concrete subclass, in the order in which they
+    /// were added.  If the index is out of range, then an empty shared
+    /// pointer is returned.
+    template<class T> shared_ptr<T> getChildOfTypeAtIndex(size_t index) const
+    {
+        static_assert(IsConcreteElement<T>::value, "A concrete Element subclass is required");
+        const vector<ElementPtr>* indexed = getIndexedChildren(typeid(T));
+        if (!indexed || index >= indexed->size())
+            return shared_ptr<T>();
+        return std::static_pointer_cast<T>((*indexed)[index]);
+    }
+
     /// Set the index of the child, if any, with the given name.
     /// If the given index is out of bounds, then an exception is thrown.
     void setChildIndex(const string& name, int index);
 
+    /// Replace the order of the children of this element with the given
+    /// order, in a single pass.
+    /// @throws Exception if the given order does not contain exactly the
+    ///    current children of this element.
+    void setChildOrder(const vector<ElementPtr>& order);
+
     /// Return the index of the child, if any, with the given name.
     /// If no child with the given name is found, then -1 is returned.
     int getChildIndex(const string& name) const;
@@ -527,26 +598,35 @@ class Element : public std::enable_shared_from_this<Element>
     /// @{
 
     /// Set the value string of the given attribute.
-    void setAttribute(const string& attrib, const string& value);
+    void setAttribute(const string& attrib, const string& value)
+    {
+        setAttribute(attrib, string(value));
+    }
+
+    /// Set the value string of the given attribute, moving the given string
+    /// into the element rather than copying it.
+    void setAttribute(const string& attrib, string&& value);
 
     /// Return true if the given attribute is present.
     bool hasAttribute(const string& attrib) const
     {
-        return _attributeMap.count(attrib) != 0;
+        return findAttribute(attrib) != string::npos;
     }
 
     /// Return the value string of the given attribute.  If the given attribute
     /// is not present, then an empty string is returned.
     const string& getAttribute(const string& attrib) const
     {
-        StringMap::const_iterator it = _attributeMap.find(attrib);
-        return (it != _attributeMap.end()) ? it->second : EMPTY_STRING;
+        size_t index = findAttribute(attrib);
+        return (index != string::npos) ? _attributeValues[index] : EMPTY_STRING;
     }
 
     /// Return a vector of stored attribute names, in the order they were set.
+    /// The vector is shared by all elements with the same attribute names,
+    /// and remains valid for the lifetime of the process.
     const StringVec& getAttributeNames() const
     {
-        return _attributeOrder;
+        return *_attributeNames;
     }
 
     /// Set the value of an implicitly typed attribute.  Since an attribute
@@ -687,6 +767,18 @@ class Element : public std::enable_shared_from_this<Element>
     /// @sa getUpstreamElement
     GraphIterator traverseGraph(ConstMaterialPtr material = nullptr) const;
 
+    /// Traverse the dataflow graph from the given element to each of its
+    /// upstream sources in depth-first order, visiting each edge of the graph
+    /// exactly once.  Unlike traverseGraph, the subgraph of an element that is
+    /// reachable through several paths is traversed only on its first visit,
+    /// so the cost of the traversal is linear in the size of the graph.
+    /// @param material An optional material element, whose data bindings will
+    ///    be applied to the traversal.
+    /// @throws ExceptionFoundCycle if a cycle is encountered.
+    /// @return A GraphIterator object.
+    /// @sa traverseGraph
+    GraphIterator traverseGraphUnique(ConstMaterialPtr material = nullptr) const;
+
     /// Return the Edge with the given index that lies directly upstream from
     /// this element in the dataflow graph.
     /// @param material An optional material element, whose data bindings will
@@ -738,10 +830,7 @@ class Element : public std::enable_shared_from_this<Element>
     ///    this element originates.  This string may be used by serialization
     ///    and deserialization routines to maintain hierarchies of include
     ///    references.
-    void setSourceUri(const string& sourceUri)
-    {
-        _sourceUri = sourceUri;
-    }
+    void setSourceUri(const string& sourceUri);
 
     /// Return true if this element has a source URI.
     bool hasSourceUri() const
@@ -838,13 +927,63 @@ class Element : public std::enable_shared_from_this<Element>
     {
         ConstElementPtr root = getRoot();
         shared_ptr<T> child = root->getChildOfType<T>(getQualifiedName(name));
-        return child ? child : root->getChildOfType<T>(name);
+        if (!child)
+        {
+            child = root->getChildOfType<T>(name);
+        }
+        return child ? child : std::dynamic_pointer_cast<T>(resolveReferencedName(name));
     }
 
+    // Resolve a reference to a named element within the libraries referenced
+    // by this document, taking the namespace at the scope of this element
+    // into account.
+    ElementPtr resolveReferencedName(const string& name) const;
+
     // Enforce a requirement within a validate method, updating the validation
     // state and optional output text if the requirement is not met.
     void validateRequire(bool expression, bool& res, string* message, string errorDesc) const;
 
+    // A collector of structured diagnostics, which receives the failures
+    // reported by validateRequire on the current thread for as long as it
+    // remains in scope.  Collectors on separate threads may share an error
+    // count, allowing validation to stop early once a limit is reached.
+    class ValidationCollector
+    {
+      public:
+        ValidationCollector(ValidationDiagnosticVec& diagnostics,
+                            std::atomic<size_t>& errorCount,
+                            size_t maxErrors);
+        ~ValidationCollector();
+        ValidationCollector(const ValidationCollector&) = delete;
+        ValidationCollector& operator=(const ValidationCollector&) = delete;
+
+        // Record a failure of the given rule at the given element.
+        void report(const Element& elem, const string& rule);
+
+        // Return true if the shared error limit has been reached.
+        bool isStopped() const
+        {
+            return _maxErrors && _errorCount.load(std::memory_order_relaxed) >= _maxErrors;
+        }
+
+        // Return the active collector for the current thread, if any.
+        static ValidationCollector* getActive();
+
+      public:
+        // An element whose own rules are validated, but whose children are
+        // skipped, allowing them to be validated separately.
+        const Element* shallowElement;
+
+      private:
+        static ValidationCollector*& getActiveSlot();
+
+      private:
+        ValidationDiagnosticVec& _diagnostics;
+        std::atomic<size_t>& _errorCount;
+        size_t _maxErrors;
+        ValidationCollector* _previous;
+    };
+
   public:
     static const string NAME_ATTRIBUTE;
     static const string FILE_PREFIX_ATTRIBUTE;
@@ -861,6 +1000,10 @@ class Element : public std::enable_shared_from_this<Element>
     virtual void registerChildElement(ElementPtr child);
     virtual void unregisterChildElement(ElementPtr child);
 
+    // Called after the given attribute has been set or removed.  An empty
+    // attribute name indicates that all attributes may have changed.
+    virtual void onAttributeChange(const string&) { }
+
     // Return a non-const copy of our self pointer, for use in constructing
     // graph traversal objects that require non-const storage.
     ElementPtr getSelfNonConst() const
@@ -868,6 +1011,68 @@ class Element : public std::enable_shared_from_this<Element>
         return std::const_pointer_cast<Element>(shared_from_this());
     }
 
+  protected:
+    // Return the index of the given attribute in the name and value vectors,
+    // or string::npos if the attribute is not present.  Names taken from
+    // getAttributeNames match by address, without a string comparison.
+    size_t findAttribute(const string& attrib) const
+    {
+        const StringVec& names = *_attributeNames;
+        for (size_t i = 0; i < names.size(); i++)
+        {
+            if (&names[i] == &attrib || names[i] == attrib)
+                return i;
+        }
+        return string::npos;
+    }
+
+    // Return the interned, empty vector of attribute names.
+    static const StringVec* getEmptyAttributeNames();
+
+    // Return the interned vector of attribute names formed by appending the
+    // given name to an interned vector.
+    static const StringVec* appendAttributeName(const StringVec* names, const string& attrib);
+
+    // Return the interned vector of attribute names formed by removing the
+    // name at the given index from an interned vector.
+    static const StringVec* removeAttributeName(const StringVec* names, size_t index);
+
+    // Children are additionally indexed by their concrete subclass, in the
+    // order in which they were added, so that typed queries visit only
+    // the matching children.
+    using ChildTypeIndex = vector<std::pair<std::type_index, vector<ElementPtr>>>;
+
+    // Return the indexed children of the given concrete subclass, or a null
+    // pointer if no such children are present.
+    const vector<ElementPtr>* getIndexedChildren(std::type_index type) const
+    {
+        for (const auto& entry : _childTypeIndex)
+        {
+            if (entry.first == type)
+                return &entry.second;
+        }
+        return nullptr;
+    }
+
+    // Rebuild the child type index from the current child order.
+    void reindexChildren();
+
+    // Return the allocation arena of our document, or an empty shared
+    // pointer if the document uses the default allocator.
+    ArenaPtr getArena() const;
+
+    // Allocate a new element of the given subclass, drawing its memory from
+    // the arena of the parent's document if present.
+    template <class T> static shared_ptr<T> allocateElement(ElementPtr parent, const string& name)
+    {
+        ArenaPtr arena = parent->getArena();
+        if (arena)
+        {
+            return std::allocate_shared<T>(ArenaAllocator<T>(arena), parent, name);
+        }
+        return std::make_shared<T>(parent, name);
+    }
+
   protected:
     string _category;
     string _name;
@@ -875,9 +1080,13 @@ class Element : public std::enable_shared_from_this<Element>
 
     ElementMap _childMap;
     vector<ElementPtr> _childOrder;
+    ChildTypeIndex _childTypeIndex;
 
-    StringMap _attributeMap;
-    StringVec _attributeOrder;
+    // Attribute values are stored in the order in which they were set, and
+    // their names in a vector interned in a process-wide table, so that
+    // elements with the same attributes share a single copy of their names.
+    const StringVec* _attributeNames;
+    StringVec _attributeValues;
 
     weak_ptr<Element> _parent;
     weak_ptr<Element> _root;
@@ -885,7 +1094,7 @@ class Element : public std::enable_shared_from_this<Element>
   private:
     template <class T> static ElementPtr createElement(ElementPtr parent, const string& name)
     {
-        return std::make_shared<T>(parent, name);
+        return allocateElement<T>(parent, name);
     }
 
   private:
@@ -1062,15 +1271,23 @@ class ValueElement : public TypedElement
     /// Return the typed value of an element as a generic value object, which
     /// may be queried to access its data.
     ///
-    /// @return A shared pointer to the typed value of this element, or an
-    ///    empty shared pointer if no value is present.
+    /// @return A shared pointer to a copy of the typed value of this element,
+    ///    or an empty shared pointer if no value is present.
     ValuePtr getValue() const
     {
-        if (!hasValue())
-            return ValuePtr();
-        return Value::createValueFromStrings(getValueString(), getType());
+        ConstValuePtr value = getCachedValue();
+        return value ? value->copy() : ValuePtr();
     }
 
+    /// Return the typed value of an element as a shared, immutable value
+    /// object.  The value string is parsed on first access, and the result
+    /// is cached until the value or type of the element is changed, so that
+    /// repeated queries require no parsing or allocation.
+    ///
+    /// @return A shared pointer to the typed value of this element, or an
+    ///    empty shared pointer if no value is present.
+    ConstValuePtr getCachedValue() const;
+
     /// Return the resolved value of an element as a generic value object, which
     /// may be queried to access its data.
     ///
@@ -1079,12 +1296,7 @@ class ValueElement : public TypedElement
     ///    will be created at this scope and applied to the return value.
     /// @return A shared pointer to the typed value of this element, or an
     ///    empty shared pointer if no value is present.
-    ValuePtr getResolvedValue(StringResolverPtr resolver = nullptr) const
-    {
-        if (!hasValue())
-            return ValuePtr();
-        return Value::createValueFromStrings(getResolvedValueString(resolver), getType());
-    }
+    ValuePtr getResolvedValue(StringResolverPtr resolver = nullptr) const;
 
     /// @}
     /// @name Bound Value
@@ -1168,6 +1380,12 @@ class ValueElement : public TypedElement
 
     /// @}
 
+  protected:
+    void onAttributeChange(const string& attrib) override;
+
+  private:
+    mutable ConstValuePtr _cachedValue;
+
   public:
     static const string VALUE_ATTRIBUTE;
     static const string INTERFACE_NAME_ATTRIBUTE;
@@ -1372,6 +1590,31 @@ class CopyOptions
     bool skipConflictingElements;
 };
 
+/// @class ValidationDiagnostic
+/// A single validation failure, recording the element at which a rule of
+/// the MaterialX specification was not met.
+class ValidationDiagnostic
+{
+  public:
+    ValidationDiagnostic(const string& elementPath, const string& rule, const string& message) :
+        elementPath(elementPath),
+        rule(rule),
+        message(message)
+    {
+    }
+    ~ValidationDiagnostic() { }
+
+    /// The name path of the element that failed validation.
+    string elementPath;
+
+    /// A description of the rule that was not met.
+    string rule;
+
+    /// The full text of the diagnostic, in the format used by the message
+    /// string of Element::validate.
+    string message;
+};
+
 /// @class ExceptionOrphanedElement
 /// An exception that is thrown when an ElementPtr is used after its owning
 /// Document has gone out of scope.
@@ -1392,7 +1635,7 @@ template<class T> shared_ptr<T> Element::addChild(const string& name)
     if (_childMap.count(childName))
         throw Exception("Child name is not unique: " + childName);
 
-    shared_ptr<T> child = std::make_shared<T>(getSelf(), childName);
+    shared_ptr<T> child = allocateElement<T>(getSelf(), childName);
     registerChildElement(child);
 
     return child;
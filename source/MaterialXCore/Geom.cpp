@@ -7,6 +7,9 @@
 
 #include <MaterialXCore/Document.h>
 
+#include <algorithm>
+#include <set>
+
 namespace MaterialX
 {
 
@@ -25,27 +28,250 @@ const string Collection::INCLUDE_GEOM_ATTRIBUTE = "includegeom";
 const string Collection::EXCLUDE_GEOM_ATTRIBUTE = "excludegeom";
 const string Collection::INCLUDE_COLLECTION_ATTRIBUTE = "includecollection";
 
-bool geomStringsMatch(const string& geom1, const string& geom2, bool contains)
+// The compiled active geometry string of a geometric element, valid for a
+// single geometry revision of its document.
+class GeomElement::CompiledGeom
+{
+  public:
+    CompiledGeom(size_t revision, const string& geom) :
+        revision(revision),
+        geom(geom)
+    {
+    }
+
+    size_t revision;
+    GeomPathMatcher geom;
+};
+
+// The compiled include and exclude geometry strings of a collection and of
+// every collection that it includes, directly or indirectly.  A geometry
+// matches the collection if it is not excluded by the collection itself, and
+// it is included either by the collection or by any included collection that
+// does not exclude it.
+class Collection::CompiledGeom
 {
-    vector<GeomPath> paths1;
-    for (const string& name1 : splitString(geom1, ARRAY_VALID_SEPARATORS))
+  public:
+    struct Geom
+    {
+        explicit Geom(const Collection& collection) :
+            include(collection.getActiveIncludeGeom()),
+            exclude(collection.getActiveExcludeGeom())
+        {
+        }
+
+        bool matches(const string& geom) const
+        {
+            return !exclude.matches(geom, true) && include.matches(geom);
+        }
+
+        GeomPathMatcher include;
+        GeomPathMatcher exclude;
+    };
+
+    CompiledGeom(size_t revision, const Collection& collection) :
+        revision(revision),
+        own(collection)
     {
-        paths1.emplace_back(name1);
     }
-    for (const string& name2 : splitString(geom2, ARRAY_VALID_SEPARATORS))
+
+    bool matches(const string& geom) const
     {
-        GeomPath path2(name2);
-        for (const GeomPath& path1 : paths1)
+        if (own.exclude.matches(geom, true))
         {
-            if (path1.isMatching(path2, contains))
+            return false;
+        }
+        if (own.include.matches(geom))
+        {
+            return true;
+        }
+        for (const Geom& includedGeom : included)
+        {
+            if (includedGeom.matches(geom))
             {
                 return true;
             }
         }
+        return false;
+    }
+
+    size_t revision;
+    Geom own;
+    vector<Geom> included;
+};
+
+namespace {
+
+bool isArraySeparator(char c)
+{
+    return c == ',' || c == ' ';
+}
+
+// Call the given function with the bounds of each geom name in the given
+// geometry string, stopping early if the function returns true.
+template <class F> bool anyGeomName(const string& geom, F func)
+{
+    const char* pos = geom.data();
+    const char* end = pos + geom.size();
+    while (pos != end)
+    {
+        if (isArraySeparator(*pos))
+        {
+            pos++;
+            continue;
+        }
+        const char* nameEnd = pos;
+        while (nameEnd != end && !isArraySeparator(*nameEnd))
+        {
+            nameEnd++;
+        }
+        if (func(pos, nameEnd))
+        {
+            return true;
+        }
+        pos = nameEnd;
     }
     return false;
 }
 
+// Advance the given segment bounds to the next segment of a geom name,
+// skipping empty segments.  Returns false if no segments remain.
+bool nextGeomSegment(const char*& begin, const char*& end, const char* nameEnd)
+{
+    begin = end;
+    while (begin != nameEnd && *begin == GEOM_PATH_SEPARATOR[0])
+    {
+        begin++;
+    }
+    if (begin == nameEnd)
+    {
+        return false;
+    }
+    end = begin;
+    while (end != nameEnd && *end != GEOM_PATH_SEPARATOR[0])
+    {
+        end++;
+    }
+    return true;
+}
+
+// Return true if the two given geom names match, with the semantics of
+// GeomPath::isMatching.
+bool geomNamesMatch(const char* name1, const char* nameEnd1,
+                    const char* name2, const char* nameEnd2,
+                    bool contains)
+{
+    const char* begin1 = name1;
+    const char* end1 = name1;
+    const char* begin2 = name2;
+    const char* end2 = name2;
+    while (true)
+    {
+        bool more1 = nextGeomSegment(begin1, end1, nameEnd1);
+        bool more2 = nextGeomSegment(begin2, end2, nameEnd2);
+        if (!more1 || !more2)
+        {
+            return !contains || !more1;
+        }
+        if (end1 - begin1 != end2 - begin2 ||
+            !std::equal(begin1, end1, begin2))
+        {
+            return false;
+        }
+    }
+}
+
+} // anonymous namespace
+
+bool geomStringsMatch(const string& geom1, const string& geom2, bool contains)
+{
+    return anyGeomName(geom2, [&geom1, contains](const char* name2, const char* nameEnd2)
+    {
+        return anyGeomName(geom1, [name2, nameEnd2, contains](const char* name1, const char* nameEnd1)
+        {
+            return geomNamesMatch(name1, nameEnd1, name2, nameEnd2, contains);
+        });
+    });
+}
+
+//
+// GeomPathMatcher methods
+//
+
+GeomPathMatcher::GeomPathMatcher() :
+    _nodes(1),
+    _empty(true)
+{
+}
+
+GeomPathMatcher::GeomPathMatcher(const string& geom) :
+    _nodes(1),
+    _empty(true)
+{
+    string segment;
+    anyGeomName(geom, [this, &segment](const char* name, const char* nameEnd)
+    {
+        size_t index = 0;
+        const char* begin = name;
+        const char* end = name;
+        while (nextGeomSegment(begin, end, nameEnd))
+        {
+            segment.assign(begin, end);
+            auto it = _nodes[index].children.find(segment);
+            if (it != _nodes[index].children.end())
+            {
+                index = it->second;
+            }
+            else
+            {
+                size_t child = _nodes.size();
+                _nodes[index].children[segment] = child;
+                _nodes.emplace_back();
+                index = child;
+            }
+        }
+        _nodes[index].terminal = true;
+        _empty = false;
+        return false;
+    });
+}
+
+bool GeomPathMatcher::matches(const string& geom, bool contains) const
+{
+    if (_empty)
+    {
+        return false;
+    }
+    string segment;
+    return anyGeomName(geom, [this, contains, &segment](const char* name, const char* nameEnd)
+    {
+        return matchesPath(name, nameEnd, contains, segment);
+    });
+}
+
+bool GeomPathMatcher::matchesPath(const char* name, const char* nameEnd, bool contains, string& segment) const
+{
+    // A compiled path matches if it is a prefix of the given path, or if the
+    // given path is a prefix of it and containment is not required.
+    size_t index = 0;
+    const char* begin = name;
+    const char* end = name;
+    while (!_nodes[index].terminal)
+    {
+        if (!nextGeomSegment(begin, end, nameEnd))
+        {
+            return !contains;
+        }
+        segment.assign(begin, end);
+        auto it = _nodes[index].children.find(segment);
+        if (it == _nodes[index].children.end())
+        {
+            return false;
+        }
+        index = it->second;
+    }
+    return true;
+}
+
 //
 // GeomElement methods
 //
@@ -62,6 +288,23 @@ void GeomElement::setCollection(ConstCollectionPtr collection)
     }
 }
 
+bool GeomElement::matchesGeomString(const string& geom) const
+{
+    return getCompiledGeom()->geom.matches(geom);
+}
+
+vector<bool> GeomElement::matchesGeomStrings(const StringVec& geoms) const
+{
+    CompiledGeomPtr compiled = getCompiledGeom();
+    vector<bool> results;
+    results.reserve(geoms.size());
+    for (const string& geom : geoms)
+    {
+        results.push_back(compiled->geom.matches(geom));
+    }
+    return results;
+}
+
 CollectionPtr GeomElement::getCollection() const
 {
     return resolveRootNameReference<Collection>(getCollectionString());
@@ -77,6 +320,26 @@ bool GeomElement::validate(string* message) const
     return Element::validate(message) && res;
 }
 
+GeomElement::CompiledGeomPtr GeomElement::getCompiledGeom() const
+{
+    // Return the compiled geometry if it is still valid.
+    ConstDocumentPtr doc = getDocument();
+    size_t revision = doc ? doc->_geomRevision.load(std::memory_order_acquire) : 0;
+    CompiledGeomPtr compiled = std::atomic_load(&_compiledGeom);
+    if (doc && compiled && compiled->revision == revision)
+    {
+        return compiled;
+    }
+
+    // Otherwise compile the active geometry string.
+    compiled = std::make_shared<CompiledGeom>(revision, getActiveGeom());
+    if (doc)
+    {
+        std::atomic_store(&_compiledGeom, compiled);
+    }
+    return compiled;
+}
+
 //
 // Collection methods
 //
@@ -139,15 +402,34 @@ bool Collection::hasIncludeCycle() const
 
 bool Collection::matchesGeomString(const string& geom) const
 {
-    if (geomStringsMatch(getActiveExcludeGeom(), geom, true))
+    return getCompiledGeom()->matches(geom);
+}
+
+vector<bool> Collection::matchesGeomStrings(const StringVec& geoms) const
+{
+    CompiledGeomPtr compiled = getCompiledGeom();
+    vector<bool> results;
+    results.reserve(geoms.size());
+    for (const string& geom : geoms)
     {
-        return false;
+        results.push_back(compiled->matches(geom));
     }
-    if (geomStringsMatch(getActiveIncludeGeom(), geom))
+    return results;
+}
+
+Collection::CompiledGeomPtr Collection::getCompiledGeom() const
+{
+    // Return the compiled geometry if it is still valid.
+    ConstDocumentPtr doc = getDocument();
+    size_t revision = doc ? doc->_geomRevision.load(std::memory_order_acquire) : 0;
+    CompiledGeomPtr compiled = std::atomic_load(&_compiledGeom);
+    if (doc && compiled && compiled->revision == revision)
     {
-        return true;
+        return compiled;
     }
 
+    // Otherwise gather all collections included by this one, directly or
+    // indirectly, and compile their geometry strings.
     std::set<CollectionPtr> includedSet;
     vector<CollectionPtr> includedVec = getIncludeCollections();
     for (size_t i = 0; i < includedVec.size(); i++)
@@ -161,15 +443,17 @@ bool Collection::matchesGeomString(const string& geom) const
         vector<CollectionPtr> appendVec = collection->getIncludeCollections();
         includedVec.insert(includedVec.end(), appendVec.begin(), appendVec.end());
     }
-    for (ConstCollectionPtr collection : includedSet)
+    std::shared_ptr<CompiledGeom> newCompiled = std::make_shared<CompiledGeom>(revision, *this);
+    for (ConstCollectionPtr collection : includedVec)
     {
-        if (collection->matchesGeomString(geom))
-        {
-            return true;
-        }
+        newCompiled->included.emplace_back(*collection);
     }
 
-    return false;
+    if (doc)
+    {
+        std::atomic_store(&_compiledGeom, CompiledGeomPtr(newCompiled));
+    }
+    return newCompiled;
 }
 
 bool Collection::validate(string* message) const
@@ -13,6 +13,8 @@
 
 #include <MaterialXCore/Element.h>
 
+#include <unordered_map>
+
 namespace MaterialX
 {
 
@@ -147,6 +149,54 @@ class GeomPath
     bool _empty;
 };
 
+/// @class GeomPathMatcher
+/// A compiled form of a geometry string, storing its geom names as a prefix
+/// tree over path segments.  Queries against a matcher follow the semantics
+/// of geomStringsMatch, with a cost proportional to the depth of the queried
+/// paths rather than the number of names in the compiled string.
+class GeomPathMatcher
+{
+  public:
+    GeomPathMatcher();
+    ~GeomPathMatcher() { }
+
+    /// Construct a matcher from a geometry string, containing an array of
+    /// geom names.
+    explicit GeomPathMatcher(const string& geom);
+
+    /// Return true if the compiled geometry string and the given geometry
+    /// string have any geometries in common.
+    /// @param geom A geometry string, containing an array of geom names.
+    /// @param contains If true, then we require that a geom path in the
+    ///    compiled string completely contains a geom path in the given string.
+    bool matches(const string& geom, bool contains = false) const;
+
+    /// Return true if the compiled geometry string contains no geom names,
+    /// and therefore matches no geometries.
+    bool isEmpty() const
+    {
+        return _empty;
+    }
+
+  private:
+    bool matchesPath(const char* begin, const char* end, bool contains, string& segment) const;
+
+  private:
+    struct Node
+    {
+        Node() :
+            terminal(false)
+        {
+        }
+
+        std::unordered_map<string, size_t> children;
+        bool terminal;
+    };
+
+    vector<Node> _nodes;
+    bool _empty;
+};
+
 /// @class GeomElement
 /// The base class for geometric elements, which support bindings to geometries
 /// and geometric collections.
@@ -190,6 +240,17 @@ class GeomElement : public Element
                EMPTY_STRING;
     }
 
+    /// Return true if the active geometry string of this element and the
+    /// given geometry string have any geometries in common.
+    ///
+    /// The active geometry string is compiled on first use, and the compiled
+    /// form is reused until the geometry bindings of the document are edited.
+    bool matchesGeomString(const string& geom) const;
+
+    /// Match each of the given geometry strings against the active geometry
+    /// string of this element, returning a vector of results in the same order.
+    vector<bool> matchesGeomStrings(const StringVec& geoms) const;
+
     /// @}
     /// @name Collection
     /// @{
@@ -231,6 +292,15 @@ class GeomElement : public Element
   public:
     static const string GEOM_ATTRIBUTE;
     static const string COLLECTION_ATTRIBUTE;
+
+  private:
+    class CompiledGeom;
+    using CompiledGeomPtr = shared_ptr<const CompiledGeom>;
+
+    CompiledGeomPtr getCompiledGeom() const;
+
+  private:
+    mutable CompiledGeomPtr _compiledGeom;
 };
 
 /// @class GeomInfo
@@ -554,9 +624,18 @@ class Collection : public Element
 
     /// Return true if this collection and the given geometry string have any
     /// geometries in common.
+    ///
+    /// The geometry strings of this collection and its included collections
+    /// are compiled on first use, and the compiled form is reused until the
+    /// geometry bindings of the document are edited.
     /// @throws ExceptionFoundCycle if a cycle is encountered.
     bool matchesGeomString(const string& geom) const;
 
+    /// Match each of the given geometry strings against this collection,
+    /// returning a vector of results in the same order.
+    /// @throws ExceptionFoundCycle if a cycle is encountered.
+    vector<bool> matchesGeomStrings(const StringVec& geoms) const;
+
     /// @}
     /// @name Validation
     /// @{
@@ -572,6 +651,15 @@ class Collection : public Element
     static const string INCLUDE_GEOM_ATTRIBUTE;
     static const string EXCLUDE_GEOM_ATTRIBUTE;
     static const string INCLUDE_COLLECTION_ATTRIBUTE;
+
+  private:
+    class CompiledGeom;
+    using CompiledGeomPtr = shared_ptr<const CompiledGeom>;
+
+    CompiledGeomPtr getCompiledGeom() const;
+
+  private:
+    mutable CompiledGeomPtr _compiledGeom;
 };
 
 template<class T> GeomPropPtr GeomInfo::setGeomPropValue(const string& name,
@@ -398,7 +398,7 @@ bool Output::hasUpstreamCycle() const
 {
     try
     {
-        for (Edge edge : traverseGraph()) { }
+        for (Edge edge : traverseGraphUnique()) { }
     }
     catch (ExceptionFoundCycle&)
     {
@@ -69,7 +69,7 @@ vector<MaterialAssignPtr> Material::getGeometryBindings(const string& geom) cons
         {
             if (matAssign->getReferencedMaterial() == getSelf())
             {
-                if (geomStringsMatch(geom, matAssign->getActiveGeom()))
+                if (matAssign->matchesGeomString(geom))
                 {
                     matAssigns.push_back(matAssign);
                     continue;
@@ -296,7 +296,7 @@ Edge ShaderRef::getUpstreamEdge(ConstMaterialPtr material, size_t index) const
 {
     if (index < getUpstreamEdgeCount())
     {
-        BindInputPtr input = getBindInputs()[index];
+        BindInputPtr input = getChildOfTypeAtIndex<BindInput>(index);
         ElementPtr upstreamOutput = input->getConnectedOutput();
         if (upstreamOutput)
         {
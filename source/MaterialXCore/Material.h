@@ -559,7 +559,7 @@ class ShaderRef : public TypedElement
     /// Return the number of queriable upstream edges for this element.
     size_t getUpstreamEdgeCount() const override
     {
-        return getBindInputs().size();
+        return getChildCountOfType<BindInput>();
     }
 
     /// @}
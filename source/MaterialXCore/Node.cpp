@@ -9,6 +9,7 @@
 #include <MaterialXCore/Material.h>
 
 #include <deque>
+#include <unordered_set>
 
 namespace MaterialX
 {
@@ -66,6 +67,52 @@ string Node::getConnectedNodeName(const string& inputName) const
 }
 
 NodeDefPtr Node::getNodeDef(const string& target) const
+{
+    ConstDocumentPtr doc = getDocument();
+    size_t revision = doc->_nodeDefRevision.load(std::memory_order_acquire);
+    shared_ptr<const NodeDefCache> cache = std::atomic_load(&_nodeDefCache);
+
+    // Return a cached resolution if it is still valid.
+    if (cache)
+    {
+        for (const NodeDefCacheEntry& entry : *cache)
+        {
+            if (entry.target == target && entry.revision == revision && entry.category == getCategory())
+            {
+                if (doc->isNodeDefCacheStatsEnabled())
+                {
+                    doc->_nodeDefCacheHits.fetch_add(1, std::memory_order_relaxed);
+                }
+                return entry.nodeDef;
+            }
+        }
+    }
+
+    // Otherwise resolve the nodedef and publish an updated snapshot.  If
+    // another thread publishes a snapshot concurrently, then one of the two
+    // resolutions is dropped and will be recomputed on its next query.
+    if (doc->isNodeDefCacheStatsEnabled())
+    {
+        doc->_nodeDefCacheMisses.fetch_add(1, std::memory_order_relaxed);
+    }
+    NodeDefPtr nodeDef = resolveNodeDef(target);
+    std::shared_ptr<NodeDefCache> newCache = std::make_shared<NodeDefCache>();
+    if (cache)
+    {
+        for (const NodeDefCacheEntry& entry : *cache)
+        {
+            if (entry.target != target)
+            {
+                newCache->push_back(entry);
+            }
+        }
+    }
+    newCache->push_back({ target, getCategory(), revision, nodeDef });
+    std::atomic_store(&_nodeDefCache, shared_ptr<const NodeDefCache>(newCache));
+    return nodeDef;
+}
+
+NodeDefPtr Node::resolveNodeDef(const string& target) const
 {
     if (hasNodeDefString())
     {
@@ -86,11 +133,16 @@ NodeDefPtr Node::getNodeDef(const string& target) const
     return NodeDefPtr();
 }
 
+void Node::clearNodeDefCache() const
+{
+    std::atomic_store(&_nodeDefCache, shared_ptr<const NodeDefCache>());
+}
+
 Edge Node::getUpstreamEdge(ConstMaterialPtr material, size_t index) const
 {
     if (index < getUpstreamEdgeCount())
     {
-        InputPtr input = getInputs()[index];
+        InputPtr input = getChildOfTypeAtIndex<Input>(index);
         ElementPtr upstreamNode = input->getConnectedNode();
         if (upstreamNode)
         {
@@ -194,46 +246,109 @@ bool Node::validate(string* message) const
 // GraphElement methods
 //
 
-void GraphElement::flattenSubgraphs(const string& target)
+void GraphElement::flattenSubgraphs(const string& target, FlattenStats* stats)
 {
-    vector<NodePtr> processNodeVec = getNodes();
-    while (!processNodeVec.empty())
+    // Flatten the graph against a local index of downstream ports, which is
+    // updated as nodes are instantiated and rewired, so that no document-level
+    // queries are required.
+    //
+    // Running time: O(numNodes + numEdges) for the flattened graph.
+
+    using PortElementVec = vector<PortElementPtr>;
+    using PortIndex = std::unordered_map<string, PortElementVec>;
+
+    // Index all ports within the given graph by the node they connect to.
+    auto indexPort = [](ElementPtr elem, PortIndex& portIndex)
     {
-        // Precompute graph implementations and downstream ports for this node vector.
-        using PortElementVec = vector<PortElementPtr>;
-        std::unordered_map<NodePtr, NodeGraphPtr> graphImplMap;
-        std::unordered_map<NodePtr, PortElementVec> downstreamPortMap;
-        for (NodePtr cacheNode : processNodeVec)
+        PortElementPtr port = elem->asA<PortElement>();
+        if (port && port->hasNodeName())
         {
-            InterfaceElementPtr implement = cacheNode->getImplementation(target);
-            if (!implement || !implement->isA<NodeGraph>())
+            portIndex[port->getNodeName()].push_back(port);
+        }
+    };
+    auto indexPorts = [&indexPort](ConstGraphElementPtr graph, PortIndex& portIndex)
+    {
+        for (const ElementPtr& child : graph->getChildren())
+        {
+            if (!child->isA<Node>())
             {
+                indexPort(child, portIndex);
                 continue;
             }
-            NodeGraphPtr subNodeGraph = implement->asA<NodeGraph>();
-            graphImplMap[cacheNode] = subNodeGraph;
-            downstreamPortMap[cacheNode] = cacheNode->getDownstreamPorts();
-            for (NodePtr subNode : subNodeGraph->getNodes())
+            for (const ElementPtr& nodeChild : child->getChildren())
+            {
+                indexPort(nodeChild, portIndex);
+            }
+        }
+    };
+
+    PortIndex portIndex;
+    indexPorts(getSelf()->asA<GraphElement>(), portIndex);
+    std::unordered_map<NodeGraphPtr, PortIndex> subgraphPortIndices;
+    std::unordered_map<NodePtr, vector<NodePtr>> replacementMap;
+    std::unordered_set<ElementPtr> replacedNodes;
+    vector<NodePtr> replacedNodeVec;
+
+    // Return the indexed ports that are still connected to the given node.
+    auto getDownstreamPorts = [&portIndex, &replacedNodes](NodePtr node)
+    {
+        PortElementVec ports;
+        for (PortElementPtr port : portIndex[node->getName()])
+        {
+            if (port->getNodeName() == node->getName() && !replacedNodes.count(port->getParent()))
             {
-                downstreamPortMap[subNode] = subNode->getDownstreamPorts();
+                ports.push_back(port);
             }
         }
-        processNodeVec.clear();
+        return ports;
+    };
+
+    // Return a unique child name for a new subnode.  Since no children are
+    // removed until flattening is complete, the search for each base name
+    // resumes from the last name that was assigned.
+    StringMap lastChildNames;
+    auto createSubNodeName = [this, &lastChildNames](const string& baseName)
+    {
+        string validName = createValidName(baseName);
+        auto it = lastChildNames.find(validName);
+        string name = (it != lastChildNames.end()) ? it->second : validName;
+        while (getChild(name))
+        {
+            name = incrementName(name);
+        }
+        lastChildNames[validName] = name;
+        return name;
+    };
 
-        // Iterate through nodes with graph implementations.
-        for (const auto& pair : graphImplMap)
+    vector<NodePtr> processNodeVec = getNodes();
+    for (size_t depth = 1; !processNodeVec.empty(); depth++)
+    {
+        vector<NodePtr> nextNodeVec;
+        for (NodePtr processNode : processNodeVec)
         {
-            NodePtr processNode = pair.first;
-            NodeGraphPtr sourceSubGraph = pair.second;
-            std::unordered_map<NodePtr, NodePtr> subNodeMap;
+            InterfaceElementPtr implement = processNode->getImplementation(target);
+            if (!implement || !implement->isA<NodeGraph>())
+            {
+                continue;
+            }
+            NodeGraphPtr sourceSubGraph = implement->asA<NodeGraph>();
+            auto subgraphIt = subgraphPortIndices.find(sourceSubGraph);
+            if (subgraphIt == subgraphPortIndices.end())
+            {
+                subgraphIt = subgraphPortIndices.emplace(sourceSubGraph, PortIndex()).first;
+                indexPorts(sourceSubGraph, subgraphIt->second);
+            }
+            PortIndex& subgraphPortIndex = subgraphIt->second;
 
             // Create a new instance of each original subnode.
-            for (NodePtr sourceSubNode : sourceSubGraph->getNodes())
+            vector<NodePtr> sourceSubNodes = sourceSubGraph->getNodes();
+            vector<NodePtr>& destSubNodes = replacementMap[processNode];
+            std::unordered_map<ElementPtr, NodePtr> subNodeMap;
+            for (NodePtr sourceSubNode : sourceSubNodes)
             {
-                string destName = createValidChildName(sourceSubGraph->getName() + "_" + sourceSubNode->getName());
+                string destName = createSubNodeName(sourceSubGraph->getName() + "_" + sourceSubNode->getName());
                 NodePtr destSubNode = addNode(sourceSubNode->getCategory(), destName);
                 destSubNode->copyContentFrom(sourceSubNode);
-                setChildIndex(destSubNode->getName(), getChildIndex(processNode->getName()));
 
                 // Transfer interface properties from the reference node to the new subnode.
                 for (ValueElementPtr destValue : destSubNode->getChildrenOfType<ValueElement>())
@@ -257,6 +372,7 @@ void GraphElement::flattenSubgraphs(const string& target)
                             if (refInput->hasNodeName())
                             {
                                 newInput->setNodeName(refInput->getNodeName());
+                                portIndex[newInput->getNodeName()].push_back(newInput);
                             }
                             if (refInput->hasOutputString())
                             {
@@ -269,39 +385,94 @@ void GraphElement::flattenSubgraphs(const string& target)
 
                 // Store the mapping between subgraphs.
                 subNodeMap[sourceSubNode] = destSubNode;
+                destSubNodes.push_back(destSubNode);
 
                 // Add the subnode to the queue, allowing processing of nested subgraphs.
-                processNodeVec.push_back(destSubNode);
+                nextNodeVec.push_back(destSubNode);
             }
 
             // Transfer internal connections between subgraphs.
-            for (const auto& subNodePair : subNodeMap)
+            PortElementVec processNodePorts = getDownstreamPorts(processNode);
+            for (NodePtr sourceSubNode : sourceSubNodes)
             {
-                NodePtr sourceSubNode = subNodePair.first;
-                NodePtr destSubNode = subNodePair.second;
-                for (PortElementPtr sourcePort : downstreamPortMap[sourceSubNode])
+                NodePtr destSubNode = subNodeMap[sourceSubNode];
+                for (PortElementPtr sourcePort : subgraphPortIndex[sourceSubNode->getName()])
                 {
                     if (sourcePort->isA<Input>())
                     {
-                        auto it = subNodeMap.find(sourcePort->getParent()->asA<Node>());
+                        auto it = subNodeMap.find(sourcePort->getParent());
                         if (it != subNodeMap.end())
                         {
                             it->second->setConnectedNode(sourcePort->getName(), destSubNode);
+                            portIndex[destSubNode->getName()].push_back(it->second->getInput(sourcePort->getName()));
                         }
                     }
                     else if (sourcePort->isA<Output>())
                     {
-                        for (PortElementPtr processNodePort : downstreamPortMap[processNode])
+                        for (PortElementPtr processNodePort : processNodePorts)
                         {
                             processNodePort->setConnectedNode(destSubNode);
+                            portIndex[destSubNode->getName()].push_back(processNodePort);
                         }
                     }
                 }
             }
 
-            // The processed node has been replaced, so remove it from the graph.
-            removeNode(processNode->getName());
+            // The processed node has been replaced, and will be removed once
+            // flattening is complete.
+            replacedNodes.insert(processNode);
+            replacedNodeVec.push_back(processNode);
+            if (stats)
+            {
+                stats->flattenedNodeCount++;
+                stats->instantiatedNodeCount += destSubNodes.size();
+                stats->nestingDepth = std::max(stats->nestingDepth, depth);
+            }
         }
+        processNodeVec = nextNodeVec;
+    }
+
+    if (replacedNodeVec.empty())
+    {
+        return;
+    }
+
+    // Place each set of new subnodes at the position of the node it replaces,
+    // and move replaced nodes to the end of the child order.
+    vector<ElementPtr> childOrder;
+    childOrder.reserve(getChildren().size());
+    std::function<void(ElementPtr)> appendChild = [&](ElementPtr child)
+    {
+        auto it = replacementMap.find(child->asA<Node>());
+        if (it == replacementMap.end())
+        {
+            childOrder.push_back(child);
+            return;
+        }
+        for (NodePtr destSubNode : it->second)
+        {
+            appendChild(destSubNode);
+        }
+    };
+    std::unordered_set<ElementPtr> destSubNodes;
+    for (const auto& pair : replacementMap)
+    {
+        destSubNodes.insert(pair.second.begin(), pair.second.end());
+    }
+    for (const ElementPtr& child : getChildren())
+    {
+        if (!destSubNodes.count(child))
+        {
+            appendChild(child);
+        }
+    }
+    childOrder.insert(childOrder.end(), replacedNodeVec.rbegin(), replacedNodeVec.rend());
+    setChildOrder(childOrder);
+
+    // Remove replaced nodes, starting from the end of the child order.
+    for (NodePtr replacedNode : replacedNodeVec)
+    {
+        removeNode(replacedNode->getName());
     }
 }
 
@@ -422,7 +593,7 @@ string GraphElement::asStringDot() const
     StringSet processedInterfaces;
     for (OutputPtr output : getOutputs())
     {
-        for (Edge edge : output->traverseGraph())
+        for (Edge edge : output->traverseGraphUnique())
         {
             if (!processedEdges.count(edge))
             {
@@ -20,6 +20,7 @@ class Node;
 class GraphElement;
 class NodeGraph;
 class Backdrop;
+class FlattenStats;
 
 /// A shared pointer to a Node
 using NodePtr = shared_ptr<Node>;
@@ -81,6 +82,11 @@ class Node : public InterfaceElement
 
     /// Return the first NodeDef that declares this node, optionally filtered
     /// by the given target name.
+    ///
+    /// Resolved nodedefs are cached on the node for each target, and the
+    /// cache is invalidated automatically as the node or the nodedefs of its
+    /// document are modified.  Cache statistics may be enabled through
+    /// Document::setNodeDefCacheStatsEnabled.
     /// @param target An optional target name, which will be used to filter
     ///    the nodedefs that are considered.
     /// @return A NodeDef for this node, or an empty shared pointer if none
@@ -156,6 +162,31 @@ class Node : public InterfaceElement
 
   public:
     static const string CATEGORY;
+
+  private:
+    // Resolve the nodedef for the given target, bypassing the cache.
+    NodeDefPtr resolveNodeDef(const string& target) const;
+
+    // Clear all cached nodedef resolutions for this node.
+    void clearNodeDefCache() const;
+
+    friend class Document;
+
+  private:
+    // A nodedef resolution for a specific target, which remains valid while
+    // the node category and the nodedef revision of the document are unchanged.
+    struct NodeDefCacheEntry
+    {
+        string target;
+        string category;
+        size_t revision;
+        NodeDefPtr nodeDef;
+    };
+
+    // The cached resolutions of a node are published as an immutable snapshot,
+    // which is replaced rather than modified when a resolution is added.
+    using NodeDefCache = vector<NodeDefCacheEntry>;
+    mutable shared_ptr<const NodeDefCache> _nodeDefCache;
 };
 
 /// @class GraphElement
@@ -265,7 +296,11 @@ class GraphElement : public InterfaceElement
 
     /// Flatten any references to graph-based node definitions within this
     /// node graph, replacing each reference with the equivalent node network.
-    void flattenSubgraphs(const string& target = EMPTY_STRING);
+    /// @param target An optional target name, which will be used to filter
+    ///    the graph implementations that are flattened.
+    /// @param stats An optional pointer to a FlattenStats object.  If provided,
+    ///    then it will be filled with statistics about the operation.
+    void flattenSubgraphs(const string& target = EMPTY_STRING, FlattenStats* stats = nullptr);
 
     /// Return a vector of all children (nodes and outputs) sorted in
     /// topological order.
@@ -433,6 +468,29 @@ class Backdrop : public Element
     static const string HEIGHT_ATTRIBUTE;
 };
 
+/// @class FlattenStats
+/// Statistics reported by GraphElement::flattenSubgraphs.
+class FlattenStats
+{
+  public:
+    FlattenStats() :
+        flattenedNodeCount(0),
+        instantiatedNodeCount(0),
+        nestingDepth(0)
+    {
+    }
+    ~FlattenStats() { }
+
+    /// The number of graph-based nodes that were replaced by their node networks.
+    size_t flattenedNodeCount;
+
+    /// The number of nodes that were instantiated from graph implementations.
+    size_t instantiatedNodeCount;
+
+    /// The deepest level of nested graph implementations that was flattened.
+    size_t nestingDepth;
+};
+
 } // namespace MaterialX
 
 #endif
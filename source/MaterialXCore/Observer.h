@@ -141,8 +141,12 @@ class ObservedDocument : public Document
 
     DocumentPtr copy() const override
     {
-        DocumentPtr doc = createDocument<ObservedDocument>();
+        DocumentPtr doc = createDocument<ObservedDocument>(getArena() != nullptr);
         doc->copyContentFrom(getSelf());
+        for (const ConstDocumentPtr& library : getReferencedLibraries())
+        {
+            doc->referenceLibrary(library);
+        }
         return doc;
     }
 
@@ -197,6 +201,7 @@ class ObservedDocument : public Document
 
     void onCopyContent(ElementPtr elem) override
     {
+        Document::onCopyContent(elem);
         if (_callbacksEnabled)
         {
             for (auto& item : _observerMap)
@@ -208,6 +213,7 @@ class ObservedDocument : public Document
 
     void onClearContent(ElementPtr elem) override
     {
+        Document::onClearContent(elem);
         if (_callbacksEnabled)
         {
             for (auto& item : _observerMap)
@@ -109,7 +109,12 @@ GraphIterator& GraphIterator::operator++()
         return *this;
     }
 
-    if (!_prune && _upstreamElem && _upstreamElem->getUpstreamEdgeCount())
+    // In a unique traversal, the upstream edges of each element are
+    // traversed only once, and elements are recorded as visited only when
+    // their subgraphs are not pruned.
+    bool visited = _unique && !_prune && _upstreamElem && !_visitedElems.insert(_upstreamElem).second;
+
+    if (!_prune && !visited && _upstreamElem && _upstreamElem->getUpstreamEdgeCount())
     {
         // Traverse to the first upstream edge of this element.
         _stack.emplace_back(_upstreamElem, 0);
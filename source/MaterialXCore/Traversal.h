@@ -190,14 +190,24 @@ class TreeIterator
 /// @class GraphIterator
 /// An iterator object representing the state of an upstream graph traversal.
 ///
+/// By default, every path through the upstream graph is traversed, so an
+/// element that is reachable through several paths is visited once per
+/// path.  In a unique traversal, the upstream edges of each element are
+/// traversed only once, so that each edge of the graph is visited exactly
+/// once, at a cost that is linear in the size of the graph.  Elements that
+/// have already been traversed are still returned as the upstream elements
+/// of later edges, but their subgraphs are skipped.
+///
 /// @sa Element::traverseGraph
+/// @sa Element::traverseGraphUnique
 class GraphIterator
 {
   public:
-    explicit GraphIterator(ElementPtr elem, ConstMaterialPtr material = nullptr):
+    explicit GraphIterator(ElementPtr elem, ConstMaterialPtr material = nullptr, bool unique = false):
         _upstreamElem(elem),
         _material(material),
         _prune(false),
+        _unique(unique),
         _holdCount(0)
     {
         _pathElems.insert(elem);
@@ -295,6 +305,17 @@ class GraphIterator
         return _prune;
     }
 
+    /// @}
+    /// @name Uniqueness
+    /// @{
+
+    /// Return true if this is a unique traversal, in which the upstream
+    /// edges of each element are traversed only once.
+    bool isUnique() const
+    {
+        return _unique;
+    }
+
     /// @}
     /// @name Range Methods
     /// @{
@@ -326,9 +347,11 @@ class GraphIterator
     ElementPtr _upstreamElem;
     ElementPtr _connectingElem;
     ElementSet _pathElems;
+    ElementSet _visitedElems;
     ConstMaterialPtr _material;
     vector<StackFrame> _stack;
     bool _prune;
+    bool _unique;
     size_t _holdCount;
 };
 
@@ -5,6 +5,14 @@
 
 #include <MaterialXCore/Types.h>
 
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+    #include <xmmintrin.h>
+    #define MATERIALX_SIMD_SSE
+#elif defined(__ARM_NEON)
+    #include <arm_neon.h>
+    #define MATERIALX_SIMD_NEON
+#endif
+
 namespace MaterialX
 {
 
@@ -36,6 +44,73 @@ const Matrix44 Matrix44::IDENTITY(1, 0, 0, 0,
                                   0, 0, 1, 0,
                                   0, 0, 0, 1);
 
+namespace {
+
+// A vector of four floats, mapped to a SIMD register where supported by the
+// target architecture.
+#if defined(MATERIALX_SIMD_SSE)
+
+using Float4 = __m128;
+
+Float4 loadFloat4(const float* src) { return _mm_loadu_ps(src); }
+void storeFloat4(float* dst, Float4 v) { _mm_storeu_ps(dst, v); }
+Float4 splatFloat4(float s) { return _mm_set1_ps(s); }
+Float4 addFloat4(Float4 a, Float4 b) { return _mm_add_ps(a, b); }
+Float4 mulFloat4(Float4 a, Float4 b) { return _mm_mul_ps(a, b); }
+
+#elif defined(MATERIALX_SIMD_NEON)
+
+using Float4 = float32x4_t;
+
+Float4 loadFloat4(const float* src) { return vld1q_f32(src); }
+void storeFloat4(float* dst, Float4 v) { vst1q_f32(dst, v); }
+Float4 splatFloat4(float s) { return vdupq_n_f32(s); }
+Float4 addFloat4(Float4 a, Float4 b) { return vaddq_f32(a, b); }
+Float4 mulFloat4(Float4 a, Float4 b) { return vmulq_f32(a, b); }
+
+#else
+
+class Float4
+{
+  public:
+    float v[4];
+};
+
+Float4 loadFloat4(const float* src) { return { { src[0], src[1], src[2], src[3] } }; }
+void storeFloat4(float* dst, Float4 v) { std::copy(v.v, v.v + 4, dst); }
+Float4 splatFloat4(float s) { return { { s, s, s, s } }; }
+Float4 addFloat4(Float4 a, Float4 b) { return { { a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3] } }; }
+Float4 mulFloat4(Float4 a, Float4 b) { return { { a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3] } }; }
+
+#endif
+
+// Return the sum of the rows of the given row-major 4x4 matrix, weighted by
+// the given scalars.  Products are accumulated in row order, matching the
+// rounding of the scalar matrix and vector products.
+inline Float4 combineRows(const float* m, float x, float y, float z, float w)
+{
+    Float4 res = mulFloat4(splatFloat4(x), loadFloat4(m));
+    res = addFloat4(res, mulFloat4(splatFloat4(y), loadFloat4(m + 4)));
+    res = addFloat4(res, mulFloat4(splatFloat4(z), loadFloat4(m + 8)));
+    return addFloat4(res, mulFloat4(splatFloat4(w), loadFloat4(m + 12)));
+}
+
+// Transform an array of 3D vectors by the given row-major 4x4 matrix, with
+// the given homogeneous coordinate.
+void transformVector3Array(const float* m, const float* src, float* dst, size_t count, float w)
+{
+    float res[4];
+    for (size_t i = 0; i < count; i++, src += 3, dst += 3)
+    {
+        storeFloat4(res, combineRows(m, src[0], src[1], src[2], w));
+        dst[0] = res[0];
+        dst[1] = res[1];
+        dst[2] = res[2];
+    }
+}
+
+} // anonymous namespace
+
 //
 // Matrix33 methods
 //
@@ -193,13 +268,76 @@ template <> Matrix44 MatrixN<Matrix44, float, 4>::getAdjugate() const
         _arr[0][0]*_arr[2][1]*_arr[1][2] - _arr[1][0]*_arr[0][1]*_arr[2][2] - _arr[2][0]*_arr[1][1]*_arr[0][2]);
 }
 
+template <> Matrix44 MatrixN<Matrix44, float, 4>::operator*(const Matrix44& rhs) const
+{
+    Matrix44 res(Uninit{});
+    for (size_t i = 0; i < 4; i++)
+    {
+        storeFloat4(res._arr[i].data(), combineRows(rhs.data(), _arr[i][0], _arr[i][1], _arr[i][2], _arr[i][3]));
+    }
+    return res;
+}
+
+template <> Matrix44 MatrixN<Matrix44, float, 4>::getInverse() const
+{
+    // Compute the inverse by Laplace expansion over the 2x2 sub-determinants
+    // of the upper and lower row pairs, which requires far fewer products
+    // than the full adjugate.
+    const RowArray& r0 = _arr[0];
+    const RowArray& r1 = _arr[1];
+    const RowArray& r2 = _arr[2];
+    const RowArray& r3 = _arr[3];
+
+    float s0 = r0[0]*r1[1] - r1[0]*r0[1];
+    float s1 = r0[0]*r1[2] - r1[0]*r0[2];
+    float s2 = r0[0]*r1[3] - r1[0]*r0[3];
+    float s3 = r0[1]*r1[2] - r1[1]*r0[2];
+    float s4 = r0[1]*r1[3] - r1[1]*r0[3];
+    float s5 = r0[2]*r1[3] - r1[2]*r0[3];
+
+    float c5 = r2[2]*r3[3] - r3[2]*r2[3];
+    float c4 = r2[1]*r3[3] - r3[1]*r2[3];
+    float c3 = r2[1]*r3[2] - r3[1]*r2[2];
+    float c2 = r2[0]*r3[3] - r3[0]*r2[3];
+    float c1 = r2[0]*r3[2] - r3[0]*r2[2];
+    float c0 = r2[0]*r3[1] - r3[0]*r2[1];
+
+    float det = s0*c5 - s1*c4 + s2*c3 + s3*c2 - s4*c1 + s5*c0;
+
+    Matrix44 adj( r1[1]*c5 - r1[2]*c4 + r1[3]*c3,
+                 -r0[1]*c5 + r0[2]*c4 - r0[3]*c3,
+                  r3[1]*s5 - r3[2]*s4 + r3[3]*s3,
+                 -r2[1]*s5 + r2[2]*s4 - r2[3]*s3,
+
+                 -r1[0]*c5 + r1[2]*c2 - r1[3]*c1,
+                  r0[0]*c5 - r0[2]*c2 + r0[3]*c1,
+                 -r3[0]*s5 + r3[2]*s2 - r3[3]*s1,
+                  r2[0]*s5 - r2[2]*s2 + r2[3]*s1,
+
+                  r1[0]*c4 - r1[1]*c2 + r1[3]*c0,
+                 -r0[0]*c4 + r0[1]*c2 - r0[3]*c0,
+                  r3[0]*s4 - r3[1]*s2 + r3[3]*s0,
+                 -r2[0]*s4 + r2[1]*s2 - r2[3]*s0,
+
+                 -r1[0]*c3 + r1[1]*c1 - r1[2]*c0,
+                  r0[0]*c3 - r0[1]*c1 + r0[2]*c0,
+                 -r3[0]*s3 + r3[1]*s1 - r3[2]*s0,
+                  r2[0]*s3 - r2[1]*s1 + r2[2]*s0);
+
+    Float4 invDet = splatFloat4(1.0f / det);
+    for (size_t i = 0; i < 4; i++)
+    {
+        float* row = adj._arr[i].data();
+        storeFloat4(row, mulFloat4(loadFloat4(row), invDet));
+    }
+    return adj;
+}
+
 Vector4 Matrix44::multiply(const Vector4& v) const
 {
-    return Vector4(
-      v[0]*_arr[0][0] + v[1]*_arr[1][0] + v[2]*_arr[2][0] + v[3]*_arr[3][0],
-      v[0]*_arr[0][1] + v[1]*_arr[1][1] + v[2]*_arr[2][1] + v[3]*_arr[3][1],
-      v[0]*_arr[0][2] + v[1]*_arr[1][2] + v[2]*_arr[2][2] + v[3]*_arr[3][2],
-      v[0]*_arr[0][3] + v[1]*_arr[1][3] + v[2]*_arr[2][3] + v[3]*_arr[3][3]);
+    Vector4 res(Uninit{});
+    storeFloat4(res.data(), combineRows(data(), v[0], v[1], v[2], v[3]));
+    return res;
 }
 
 Vector3 Matrix44::transformPoint(const Vector3& v) const
@@ -219,6 +357,22 @@ Vector3 Matrix44::transformNormal(const Vector3& v) const
     return getInverse().getTranspose().transformVector(v);
 }
 
+void Matrix44::transformPoints(const float* src, float* dst, size_t count) const
+{
+    transformVector3Array(data(), src, dst, count, 1.0f);
+}
+
+void Matrix44::transformVectors(const float* src, float* dst, size_t count) const
+{
+    transformVector3Array(data(), src, dst, count, 0.0f);
+}
+
+void Matrix44::transformNormals(const float* src, float* dst, size_t count) const
+{
+    Matrix44 normalMatrix = getInverse().getTranspose();
+    transformVector3Array(normalMatrix.data(), src, dst, count, 0.0f);
+}
+
 Matrix44 Matrix44::createTranslation(const Vector3& v)
 {
     return Matrix44(1.0f, 0.0f, 0.0f, 0.0f,
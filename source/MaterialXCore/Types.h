@@ -97,7 +97,7 @@ template <class V, class S, size_t N> class VectorN : public VectorBase
     {
         V res(Uninit{});
         for (size_t i = 0; i < N; i++)
-            res[i] = _arr[i] + rhs[i];
+            res._arr[i] = _arr[i] + rhs._arr[i];
         return res;
     }
 
@@ -105,7 +105,7 @@ template <class V, class S, size_t N> class VectorN : public VectorBase
     VectorN& operator+=(const V& rhs)
     {
         for (size_t i = 0; i < N; i++)
-            _arr[i] += rhs[i];
+            _arr[i] += rhs._arr[i];
         return *this;
     }
 
@@ -114,7 +114,7 @@ template <class V, class S, size_t N> class VectorN : public VectorBase
     {
         V res(Uninit{});
         for (size_t i = 0; i < N; i++)
-            res[i] = _arr[i] - rhs[i];
+            res._arr[i] = _arr[i] - rhs._arr[i];
         return res;
     }
 
@@ -122,7 +122,7 @@ template <class V, class S, size_t N> class VectorN : public VectorBase
     VectorN& operator-=(const V& rhs)
     {
         for (size_t i = 0; i < N; i++)
-            _arr[i] -= rhs[i];
+            _arr[i] -= rhs._arr[i];
         return *this;
     }
 
@@ -131,7 +131,7 @@ template <class V, class S, size_t N> class VectorN : public VectorBase
     {
         V res(Uninit{});
         for (size_t i = 0; i < N; i++)
-            res[i] = _arr[i] * rhs[i];
+            res._arr[i] = _arr[i] * rhs._arr[i];
         return res;
     }
 
@@ -139,7 +139,7 @@ template <class V, class S, size_t N> class VectorN : public VectorBase
     VectorN& operator*=(const V& rhs)
     {
         for (size_t i = 0; i < N; i++)
-            _arr[i] *= rhs[i];
+            _arr[i] *= rhs._arr[i];
         return *this;
     }
 
@@ -148,7 +148,7 @@ template <class V, class S, size_t N> class VectorN : public VectorBase
     {
         V res(Uninit{});
         for (size_t i = 0; i < N; i++)
-            res[i] = _arr[i] / rhs[i];
+            res._arr[i] = _arr[i] / rhs._arr[i];
         return res;
     }
 
@@ -156,7 +156,7 @@ template <class V, class S, size_t N> class VectorN : public VectorBase
     VectorN& operator/=(const V& rhs)
     {
         for (size_t i = 0; i < N; i++)
-            _arr[i] /= rhs[i];
+            _arr[i] /= rhs._arr[i];
         return *this;
     }
 
@@ -165,7 +165,7 @@ template <class V, class S, size_t N> class VectorN : public VectorBase
     {
         V res(Uninit{});
         for (size_t i = 0; i < N; i++)
-            res[i] = _arr[i] * s;
+            res._arr[i] = _arr[i] * s;
         return res;
     }
 
@@ -182,7 +182,7 @@ template <class V, class S, size_t N> class VectorN : public VectorBase
     {
         V res(Uninit{});
         for (size_t i = 0; i < N; i++)
-            res[i] = _arr[i] / s;
+            res._arr[i] = _arr[i] / s;
         return res;
     }
 
@@ -227,7 +227,7 @@ template <class V, class S, size_t N> class VectorN : public VectorBase
     {
         S res{};
         for (size_t i = 0; i < N; i++)
-            res += _arr[i] * rhs[i];
+            res += _arr[i] * rhs._arr[i];
         return res;
     }
 
@@ -512,7 +512,7 @@ template <class M, class S, size_t N> class MatrixN : public MatrixBase
         for (size_t i = 0; i < N; i++)
             for (size_t j = 0; j < N; j++)
                 for (size_t k = 0; k < N; k++)
-                    res[i][j] += _arr[i][k] * rhs[k][j];
+                    res._arr[i][j] += _arr[i][k] * rhs._arr[k][j];
         return res;
     }
 
@@ -677,6 +677,18 @@ class Matrix44 : public MatrixN<Matrix44, float, 4>
     /// Transform the given 3D normal vector.
     Vector3 transformNormal(const Vector3& v) const;
 
+    /// Transform an array of 3D points, stored as consecutive triples of
+    /// floats.  The source and destination arrays may be identical.
+    void transformPoints(const float* src, float* dst, size_t count) const;
+
+    /// Transform an array of 3D direction vectors, stored as consecutive
+    /// triples of floats.  The source and destination arrays may be identical.
+    void transformVectors(const float* src, float* dst, size_t count) const;
+
+    /// Transform an array of 3D normal vectors, stored as consecutive triples
+    /// of floats.  The source and destination arrays may be identical.
+    void transformNormals(const float* src, float* dst, size_t count) const;
+
     /// Create a translation matrix.
     static Matrix44 createTranslation(const Vector3& v);
 
@@ -701,6 +713,11 @@ class Matrix44 : public MatrixN<Matrix44, float, 4>
     static const Matrix44 IDENTITY;
 };
 
+// Matrix44 products and inverses are specialized with SIMD kernels where
+// supported by the target architecture.
+template <> Matrix44 MatrixN<Matrix44, float, 4>::operator*(const Matrix44& rhs) const;
+template <> Matrix44 MatrixN<Matrix44, float, 4>::getInverse() const;
+
 } // namespace MaterialX
 
 #endif
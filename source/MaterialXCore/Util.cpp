@@ -5,7 +5,10 @@
 
 #include <MaterialXCore/Util.h>
 
+#include <atomic>
 #include <cctype>
+#include <mutex>
+#include <thread>
 
 namespace MaterialX
 {
@@ -126,4 +129,67 @@ bool stringEndsWith(const string& str, const string& suffix)
     return false;
 }
 
+void parallelFor(size_t count, unsigned int threadCount, const std::function<void(size_t)>& func)
+{
+    if (!threadCount)
+    {
+        threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    if (threadCount == 1 || count <= 1)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            func(i);
+        }
+        return;
+    }
+
+    std::atomic<size_t> nextIndex(0);
+    std::atomic<bool> failed(false);
+    std::mutex exceptionMutex;
+    std::exception_ptr exception;
+    size_t exceptionIndex = count;
+    auto worker = [&]()
+    {
+        while (!failed.load(std::memory_order_relaxed))
+        {
+            size_t index = nextIndex.fetch_add(1);
+            if (index >= count)
+            {
+                break;
+            }
+            try
+            {
+                func(index);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> guard(exceptionMutex);
+                if (index < exceptionIndex)
+                {
+                    exception = std::current_exception();
+                    exceptionIndex = index;
+                }
+                failed = true;
+            }
+        }
+    };
+
+    vector<std::thread> threads;
+    size_t workerCount = std::min((size_t) threadCount, count);
+    for (size_t i = 1; i < workerCount; i++)
+    {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    if (exception)
+    {
+        std::rethrow_exception(exception);
+    }
+}
+
 } // namespace MaterialX
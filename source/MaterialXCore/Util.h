@@ -45,6 +45,20 @@ string stringToLower(string str);
 /// Return true if the given string ends with the given suffix.
 bool stringEndsWith(const string& str, const string& suffix);
 
+/// Call the given function once for each index in the range [0, count),
+/// distributing the calls across the given number of threads.  Indices are
+/// handed out in increasing order, and the calling thread takes part in the
+/// work.
+/// @param count The number of indices to process.
+/// @param threadCount The number of threads to use, including the calling
+///    thread.  A value of zero selects the hardware concurrency of the
+///    system, and a value of one processes all indices on the calling thread.
+/// @param func The function to call for each index.
+/// @throws The exception thrown by the function for the lowest index, if
+///    any.  Once an exception has been thrown, no further indices are handed
+///    out, so all lower indices will have been processed, as in a serial loop.
+void parallelFor(size_t count, unsigned int threadCount, const std::function<void(size_t)>& func);
+
 /// Combine the hash of a value with an existing seed.
 template<typename T> void hashCombine(size_t& seed, const T& value)
 {
@@ -7,7 +7,11 @@
 
 #include <MaterialXCore/Util.h>
 
-#include <iomanip>
+#include <cfloat>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <locale>
 #include <sstream>
 #include <type_traits>
 
@@ -15,8 +19,9 @@ namespace MaterialX
 {
 
 Value::CreatorMap Value::_creatorMap;
-Value::FloatFormat Value::_floatFormat = Value::FloatFormatDefault;
-int Value::_floatPrecision = 6;
+thread_local Value::FloatFormat Value::_floatFormat = Value::FloatFormatDefault;
+thread_local int Value::_floatPrecision = 6;
+thread_local size_t Value::_parseCount = 0;
 
 namespace {
 
@@ -30,102 +35,422 @@ template <class T> class is_std_vector< vector<T> > : public std::true_type { };
 template <class T> using enable_if_std_vector_t =
     typename std::enable_if<is_std_vector<T>::value, T>::type;
 
-template <class T> void stringToData(const string& str, T& data)
+const double POWERS_OF_TEN[] =
+{
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+// The limits within which a decimal mantissa and power-of-ten exponent can
+// be converted to a floating-point type by a single, correctly rounded
+// multiplication or division, as both operands are exactly representable.
+template <class T> class FastFloatLimits;
+
+template <> class FastFloatLimits<float>
+{
+  public:
+    static const uint64_t MAX_MANTISSA = (uint64_t) 1 << 24;
+    static const int MAX_EXPONENT = 10;
+};
+
+template <> class FastFloatLimits<double>
+{
+  public:
+    static const uint64_t MAX_MANTISSA = (uint64_t) 1 << 53;
+    static const int MAX_EXPONENT = 22;
+};
+
+bool isSpace(char c)
+{
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+bool isDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+// Parse an integer from the start of the given range of characters, with the
+// leading whitespace and trailing characters accepted by a stream.  Returns
+// false if the range does not start with an integer that is parsed by the
+// fast path, which excludes integers with more than digits10 digits.
+template <class T> bool parseInteger(const char* pos, const char* end, T& data)
+{
+    while (pos != end && isSpace(*pos))
+    {
+        pos++;
+    }
+    bool negative = pos != end && *pos == '-';
+    if (pos != end && (*pos == '-' || *pos == '+'))
+    {
+        pos++;
+    }
+
+    const char* digitsBegin = pos;
+    int64_t value = 0;
+    while (pos != end && isDigit(*pos))
+    {
+        value = value * 10 + (*pos++ - '0');
+        if (pos - digitsBegin > std::numeric_limits<T>::digits10)
+        {
+            return false;
+        }
+    }
+    if (pos == digitsBegin)
+    {
+        return false;
+    }
+
+    data = (T) (negative ? -value : value);
+    return true;
+}
+
+// Parse a floating-point number from the start of the given range of
+// characters, with the leading whitespace and trailing characters accepted
+// by a stream.  Returns false if the range does not start with a number
+// that can be parsed with correct rounding by the fast path.
+template <class T> bool parseFloat(const char* pos, const char* end, T& data)
+{
+#if FLT_EVAL_METHOD == 0
+    while (pos != end && isSpace(*pos))
+    {
+        pos++;
+    }
+    bool negative = pos != end && *pos == '-';
+    if (pos != end && (*pos == '-' || *pos == '+'))
+    {
+        pos++;
+    }
+
+    // Read the significant digits into an integer mantissa.
+    uint64_t mantissa = 0;
+    int exponent = 0;
+    int significantDigits = 0;
+    bool foundDigits = false;
+    while (pos != end && isDigit(*pos))
+    {
+        foundDigits = true;
+        if (mantissa || *pos != '0')
+        {
+            if (++significantDigits > 19)
+            {
+                return false;
+            }
+            mantissa = mantissa * 10 + (uint64_t) (*pos - '0');
+        }
+        pos++;
+    }
+    if (pos != end && *pos == '.')
+    {
+        pos++;
+        while (pos != end && isDigit(*pos))
+        {
+            foundDigits = true;
+            if (mantissa || *pos != '0')
+            {
+                if (++significantDigits > 19)
+                {
+                    return false;
+                }
+                mantissa = mantissa * 10 + (uint64_t) (*pos - '0');
+            }
+            exponent--;
+            pos++;
+        }
+    }
+    if (!foundDigits)
+    {
+        return false;
+    }
+
+    // Read the exponent, deferring to the stream parser for incomplete
+    // exponents.
+    if (pos != end && (*pos == 'e' || *pos == 'E'))
+    {
+        pos++;
+        bool negativeExponent = pos != end && *pos == '-';
+        if (pos != end && (*pos == '-' || *pos == '+'))
+        {
+            pos++;
+        }
+        if (pos == end || !isDigit(*pos))
+        {
+            return false;
+        }
+        int explicitExponent = 0;
+        while (pos != end && isDigit(*pos))
+        {
+            if (explicitExponent > 10000)
+            {
+                return false;
+            }
+            explicitExponent = explicitExponent * 10 + (*pos++ - '0');
+        }
+        exponent += negativeExponent ? -explicitExponent : explicitExponent;
+    }
+
+    // Remove trailing zeros from the mantissa.
+    while (mantissa && mantissa % 10 == 0)
+    {
+        mantissa /= 10;
+        exponent++;
+    }
+
+    if (mantissa > FastFloatLimits<T>::MAX_MANTISSA ||
+        exponent > FastFloatLimits<T>::MAX_EXPONENT ||
+        exponent < -FastFloatLimits<T>::MAX_EXPONENT)
+    {
+        return mantissa == 0 ? (data = negative ? -T(0) : T(0), true) : false;
+    }
+
+    T value = (T) mantissa;
+    if (exponent < 0)
+    {
+        value /= (T) POWERS_OF_TEN[-exponent];
+    }
+    else
+    {
+        value *= (T) POWERS_OF_TEN[exponent];
+    }
+    data = negative ? -value : value;
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool parseNumber(const char* begin, const char* end, int& data)
+{
+    return parseInteger(begin, end, data);
+}
+
+bool parseNumber(const char* begin, const char* end, long& data)
+{
+    return parseInteger(begin, end, data);
+}
+
+bool parseNumber(const char* begin, const char* end, float& data)
+{
+    return parseFloat(begin, end, data);
+}
+
+bool parseNumber(const char* begin, const char* end, double& data)
 {
-    std::stringstream ss(str);
-    if (!(ss >> data))
+    return parseFloat(begin, end, data);
+}
+
+// Parse a value from the given range of characters.  Numbers are parsed by
+// a locale-independent fast path where possible, and otherwise by a stream
+// in the classic locale.
+template <class T> void tokenToData(const char* begin, const char* end, T& data)
+{
+    if (!parseNumber(begin, end, data))
     {
-        throw ExceptionTypeError("Type mismatch in generic stringToData: " + str);
+        std::istringstream ss(string(begin, end));
+        ss.imbue(std::locale::classic());
+        if (!(ss >> data))
+        {
+            throw ExceptionTypeError("Type mismatch in generic stringToData: " + string(begin, end));
+        }
     }
 }
 
-template <> void stringToData(const string& str, bool& data)
+template <> void tokenToData(const char* begin, const char* end, bool& data)
 {
-    if (str == VALUE_STRING_TRUE)
+    size_t length = (size_t) (end - begin);
+    if (!VALUE_STRING_TRUE.compare(0, string::npos, begin, length))
         data = true;
-    else if (str == VALUE_STRING_FALSE)
+    else if (!VALUE_STRING_FALSE.compare(0, string::npos, begin, length))
         data = false;
     else
-        throw ExceptionTypeError("Type mismatch in boolean stringToData: " + str);
+        throw ExceptionTypeError("Type mismatch in boolean stringToData: " + string(begin, end));
 }
 
-template <> void stringToData(const string& str, string& data)
+template <> void tokenToData(const char* begin, const char* end, string& data)
 {
-    data = str;
+    data.assign(begin, end);
+}
+
+// Invoke the given function for each token of the given array string, with
+// the same tokenization as splitString, but without intermediate strings.
+template <class F> void forEachToken(const string& str, F func)
+{
+    const char* pos = str.data();
+    const char* end = pos + str.size();
+    auto isSeparator = [](char c)
+    {
+        return ARRAY_VALID_SEPARATORS.find(c) != string::npos;
+    };
+    while (true)
+    {
+        while (pos != end && isSeparator(*pos))
+        {
+            pos++;
+        }
+        if (pos == end)
+        {
+            return;
+        }
+        const char* tokenBegin = pos;
+        while (pos != end && !isSeparator(*pos))
+        {
+            pos++;
+        }
+        func(tokenBegin, pos);
+    }
+}
+
+size_t getTokenCount(const string& str)
+{
+    size_t count = 0;
+    forEachToken(str, [&count](const char*, const char*) { count++; });
+    return count;
+}
+
+template <class T> void stringToData(const string& str, T& data)
+{
+    tokenToData(str.data(), str.data() + str.size(), data);
 }
 
 template <class T> void stringToData(const string& str, enable_if_mx_vector_t<T>& data)
 {
-    StringVec tokens = splitString(str, ARRAY_VALID_SEPARATORS);
-    if (tokens.size() != data.numElements())
+    if (getTokenCount(str) != data.numElements())
     {
         throw ExceptionTypeError("Type mismatch in vector stringToData: " + str);
     }
-    for (size_t i = 0; i < data.numElements(); i++)
+    size_t index = 0;
+    forEachToken(str, [&data, &index](const char* begin, const char* end)
     {
-        stringToData(tokens[i], data[i]);
-    }
+        tokenToData(begin, end, data[index++]);
+    });
 }
 
 template <class T> void stringToData(const string& str, enable_if_mx_matrix_t<T>& data)
 {
-    StringVec tokens = splitString(str, ARRAY_VALID_SEPARATORS);
-    if (tokens.size() != data.numRows() * data.numColumns())
+    if (getTokenCount(str) != data.numRows() * data.numColumns())
     {
         throw ExceptionTypeError("Type mismatch in matrix stringToData: " + str);
     }
-    for (size_t i = 0; i < data.numRows(); i++)
+    size_t index = 0;
+    forEachToken(str, [&data, &index](const char* begin, const char* end)
     {
-        for (size_t j = 0; j < data.numColumns(); j++)
-        {
-            stringToData(tokens[i * data.numRows() + j], data[i][j]);
-        }
-    }
+        tokenToData(begin, end, data[index / data.numColumns()][index % data.numColumns()]);
+        index++;
+    });
 }
 
 template <class T> void stringToData(const string& str, enable_if_std_vector_t<T>& data)
 {
-    for (const string& token : splitString(str, ARRAY_VALID_SEPARATORS))
+    forEachToken(str, [&data](const char* begin, const char* end)
     {
         typename T::value_type val;
-        stringToData(token, val);
+        tokenToData(begin, end, val);
         data.push_back(val);
-    }
+    });
 }
 
-template <class T> void dataToString(const T& data, string& str)
+// Append an integer to the given string.
+template <class T> void appendInteger(T data, string& str)
 {
-    std::stringstream ss;
+    char buffer[24];
+    char* pos = buffer + sizeof(buffer);
+    unsigned long long value = data < 0 ? 0ull - (unsigned long long) data : (unsigned long long) data;
+    do
+    {
+        *--pos = (char) ('0' + value % 10);
+        value /= 10;
+    } while (value);
+    if (data < 0)
+    {
+        *--pos = '-';
+    }
+    str.append(pos, buffer + sizeof(buffer));
+}
 
-    // Set float format and precision for the stream
+// Append a floating-point number to the given string, in the current float
+// format and precision of the Value class.  Numbers are formatted as by a
+// stream in the classic locale.
+void appendFloat(double data, string& str)
+{
     const Value::FloatFormat fmt = Value::getFloatFormat();
-    ss.setf(std::ios_base::fmtflags(
-            (fmt == Value::FloatFormatFixed ? std::ios_base::fixed :
-            (fmt == Value::FloatFormatScientific ? std::ios_base::scientific : 0))),
-        std::ios_base::floatfield);
-    ss.precision(Value::getFloatPrecision());
+    const char* format = fmt == Value::FloatFormatFixed ? "%.*f" :
+                         fmt == Value::FloatFormatScientific ? "%.*e" : "%.*g";
+    int precision = Value::getFloatPrecision();
+    if (precision < 0)
+    {
+        precision = 6;
+    }
+
+    char buffer[64];
+    size_t start = str.size();
+    int length = std::snprintf(buffer, sizeof(buffer), format, precision, data);
+    if (length < 0)
+    {
+        return;
+    }
+    if ((size_t) length < sizeof(buffer))
+    {
+        str.append(buffer, (size_t) length);
+    }
+    else
+    {
+        str.resize(start + (size_t) length + 1);
+        std::snprintf(&str[start], (size_t) length + 1, format, precision, data);
+        str.resize(start + (size_t) length);
+    }
 
-    ss << data;
-    str = ss.str();
+    // Replace the decimal point of the C locale, if it differs from that of
+    // the classic locale.
+    for (size_t i = start; i < str.size(); i++)
+    {
+        char c = str[i];
+        if (!isDigit(c) && c != '-' && c != '+' && !(c >= 'a' && c <= 'z') && !(c >= 'A' && c <= 'Z'))
+        {
+            str[i] = '.';
+        }
+    }
+}
+
+void appendData(int data, string& str)
+{
+    appendInteger(data, str);
 }
 
-template <> void dataToString(const bool& data, string& str)
+void appendData(long data, string& str)
 {
-    str = data ? VALUE_STRING_TRUE : VALUE_STRING_FALSE;
+    appendInteger(data, str);
 }
 
-template <> void dataToString(const string& data, string& str)
+void appendData(float data, string& str)
+{
+    appendFloat((double) data, str);
+}
+
+void appendData(double data, string& str)
+{
+    appendFloat(data, str);
+}
+
+void appendData(bool data, string& str)
+{
+    str += data ? VALUE_STRING_TRUE : VALUE_STRING_FALSE;
+}
+
+void appendData(const string& data, string& str)
+{
+    str += data;
+}
+
+template <class T> void dataToString(const T& data, string& str)
 {
-    str = data;
+    appendData(data, str);
 }
 
 template <class T> void dataToString(const enable_if_mx_vector_t<T>& data, string& str)
 {
     for (size_t i = 0; i < data.numElements(); i++)
     {
-        string token;
-        dataToString(data[i], token);
-        str += token;
+        appendData(data[i], str);
         if (i + 1 < data.numElements())
         {
             str += ARRAY_PREFERRED_SEPARATOR;
@@ -139,9 +464,7 @@ template <class T> void dataToString(const enable_if_mx_matrix_t<T>& data, strin
     {
         for (size_t j = 0; j < data.numColumns(); j++)
         {
-            string token;
-            dataToString(data[i][j], token);
-            str += token;
+            appendData(data[i][j], str);
             if (i + 1 < data.numRows() ||
                 j + 1 < data.numColumns())
             {
@@ -155,9 +478,8 @@ template <class T> void dataToString(const enable_if_std_vector_t<T>& data, stri
 {
     for (size_t i = 0; i < data.size(); i++)
     {
-        string token;
-        dataToString<typename T::value_type>(data[i], token);
-        str += token;
+        const typename T::value_type& value = data[i];
+        appendData(value, str);
         if (i + 1 < data.size())
         {
             str += ARRAY_PREFERRED_SEPARATOR;
@@ -222,6 +544,7 @@ template <class T> ValuePtr TypedValue<T>::createFromString(const string& value)
 
 ValuePtr Value::createValueFromStrings(const string& value, const string& type)
 {
+    _parseCount++;
     CreatorMap::iterator it = _creatorMap.find(type);
     if (it != _creatorMap.end())
         return it->second(value);
@@ -68,6 +68,13 @@ class Value
     ///    if the conversion to the given data type cannot be performed.
     static ValuePtr createValueFromStrings(const string& value, const string& type);
 
+    /// Return the number of values that have been created from value and
+    /// type strings on the calling thread, for use in profiling.
+    static size_t getParseCount()
+    {
+        return _parseCount;
+    }
+
     /// Create a deep copy of the value.
     virtual ValuePtr copy() const = 0;
 
@@ -91,6 +98,8 @@ class Value
     /// Set float formatting for converting values to strings.
     /// Formats to use are FloatFormatFixed, FloatFormatScientific 
     /// or FloatFormatDefault to set default format.
+    /// Float formatting is stored per thread, and only affects values
+    /// converted on the calling thread.
     static void setFloatFormat(FloatFormat format)
     {
         _floatFormat = format;
@@ -122,8 +131,9 @@ class Value
 
   private:
     static CreatorMap _creatorMap;
-    static FloatFormat _floatFormat;
-    static int _floatPrecision;
+    static thread_local FloatFormat _floatFormat;
+    static thread_local int _floatPrecision;
+    static thread_local size_t _parseCount;
 };
 
 /// The class template for typed subclasses of Value
@@ -0,0 +1,379 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#include <MaterialXFormat/BinaryIo.h>
+
+#include <MaterialXFormat/Environ.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <unordered_map>
+
+namespace MaterialX
+{
+
+const string MTLX_BINARY_EXTENSION = "mtlxb";
+
+namespace {
+
+const char BINARY_MAGIC[8] = { 'M', 'T', 'L', 'X', 'B', 'I', 'N', '\0' };
+const uint64_t BINARY_FORMAT_VERSION = 1;
+
+const uint64_t FLAG_ELEMENT_INDEX = 1 << 0;
+
+// Append an unsigned integer to the given buffer, encoded as a sequence of
+// seven-bit groups with a continuation bit.
+void appendInteger(string& buffer, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        buffer.push_back((char) ((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    buffer.push_back((char) value);
+}
+
+// A writer that encodes a document into the binary format.
+class BinaryWriter
+{
+  public:
+    BinaryWriter()
+    {
+        // The empty string is always the first entry of the string table.
+        intern(EMPTY_STRING);
+    }
+
+    string write(DocumentPtr doc, bool writeElementIndex)
+    {
+        writeElement(doc);
+
+        string index;
+        if (writeElementIndex)
+        {
+            DocumentIndex docIndex = doc->getElementIndex();
+            writeIndexEntries(index, docIndex.portElements);
+            writeIndexEntries(index, docIndex.nodeDefs);
+            writeIndexEntries(index, docIndex.implementations);
+        }
+
+        string output(BINARY_MAGIC, sizeof(BINARY_MAGIC));
+        appendInteger(output, BINARY_FORMAT_VERSION);
+        appendInteger(output, writeElementIndex ? FLAG_ELEMENT_INDEX : 0);
+        appendInteger(output, _strings.size());
+        for (const string* str : _strings)
+        {
+            appendInteger(output, str->size());
+            output += *str;
+        }
+        output += _elements;
+        output += index;
+        return output;
+    }
+
+  private:
+    uint64_t intern(const string& str)
+    {
+        auto it = _stringIndices.find(str);
+        if (it != _stringIndices.end())
+        {
+            return it->second;
+        }
+        uint64_t index = _strings.size();
+        it = _stringIndices.emplace(str, index).first;
+        _strings.push_back(&it->first);
+        return index;
+    }
+
+    void writeString(string& buffer, const string& str)
+    {
+        appendInteger(buffer, intern(str));
+    }
+
+    void writeElement(ConstElementPtr elem)
+    {
+        _elementOrder.emplace(elem.get(), _elementOrder.size());
+
+        writeString(_elements, elem->getCategory());
+        writeString(_elements, elem->getName());
+        writeString(_elements, elem->getSourceUri());
+
+        const StringVec& attrNames = elem->getAttributeNames();
+        appendInteger(_elements, attrNames.size());
+        for (const string& attrName : attrNames)
+        {
+            writeString(_elements, attrName);
+            writeString(_elements, elem->getAttribute(attrName));
+        }
+
+        const vector<ElementPtr>& children = elem->getChildren();
+        appendInteger(_elements, children.size());
+        for (const ElementPtr& child : children)
+        {
+            writeElement(child);
+        }
+    }
+
+    template <class T> void writeIndexEntries(string& buffer, const vector<std::pair<string, T>>& entries)
+    {
+        appendInteger(buffer, entries.size());
+        for (const auto& entry : entries)
+        {
+            appendInteger(buffer, _elementOrder.at(entry.second.get()));
+            writeString(buffer, entry.first);
+        }
+    }
+
+  private:
+    std::unordered_map<string, uint64_t> _stringIndices;
+    vector<const string*> _strings;
+    std::unordered_map<const Element*, uint64_t> _elementOrder;
+    string _elements;
+};
+
+// A reader that decodes a document from the binary format.
+class BinaryReader
+{
+  public:
+    BinaryReader(const char* data, size_t size) :
+        _pos(data),
+        _end(data + size)
+    {
+    }
+
+    void read(DocumentPtr doc, const BinaryReadOptions* readOptions)
+    {
+        if ((size_t) (_end - _pos) < sizeof(BINARY_MAGIC) ||
+            std::memcmp(_pos, BINARY_MAGIC, sizeof(BINARY_MAGIC)))
+        {
+            throw ExceptionParseError("Binary data is not a MaterialX document");
+        }
+        _pos += sizeof(BINARY_MAGIC);
+        uint64_t version = readInteger();
+        if (version != BINARY_FORMAT_VERSION)
+        {
+            throw ExceptionParseError("Unsupported binary format version: " + std::to_string(version));
+        }
+        uint64_t flags = readInteger();
+
+        uint64_t stringCount = readInteger();
+        _strings.reserve((size_t) std::min<uint64_t>(stringCount, (uint64_t) (_end - _pos)));
+        for (uint64_t i = 0; i < stringCount; i++)
+        {
+            uint64_t length = readInteger();
+            if (length > (uint64_t) (_end - _pos))
+            {
+                error();
+            }
+            _strings.emplace_back(_pos, (size_t) length);
+            _pos += length;
+        }
+
+        bool applyFutureUpdates = readOptions ? readOptions->applyFutureUpdates : false;
+        bool readElementIndex = readOptions ? readOptions->readElementIndex : true;
+
+        // The stored index describes only the content of the binary data, so
+        // it is only applied to a document that was empty before the read.
+        if (!doc->getChildren().empty())
+        {
+            readElementIndex = false;
+        }
+        {
+            ScopedUpdate update(doc);
+            doc->onRead();
+
+            // Read the document element and its descendants.
+            const string& category = readString();
+            if (category != Document::CATEGORY)
+            {
+                throw ExceptionParseError("Binary data has an invalid document element: " + category);
+            }
+            readString();
+            readElementContent(doc);
+
+            // The stored index is only applied if the document is not
+            // modified by a version upgrade.
+            string versionString = doc->getVersionString();
+            doc->upgradeVersion(applyFutureUpdates);
+            if (applyFutureUpdates || doc->getVersionString() != versionString)
+            {
+                readElementIndex = false;
+            }
+        }
+
+        if ((flags & FLAG_ELEMENT_INDEX) && readElementIndex)
+        {
+            DocumentIndex index;
+            readIndexEntries(index.portElements);
+            readIndexEntries(index.nodeDefs);
+            readIndexEntries(index.implementations);
+            doc->setElementIndex(index);
+        }
+    }
+
+  private:
+    uint64_t readInteger()
+    {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7)
+        {
+            if (_pos == _end)
+            {
+                error();
+            }
+            unsigned char byte = (unsigned char) *_pos++;
+            value |= (uint64_t) (byte & 0x7F) << shift;
+            if (!(byte & 0x80))
+            {
+                return value;
+            }
+        }
+        error();
+        return 0;
+    }
+
+    const string& readString()
+    {
+        uint64_t index = readInteger();
+        if (index >= _strings.size())
+        {
+            error();
+        }
+        return _strings[(size_t) index];
+    }
+
+    void readElementContent(ElementPtr elem)
+    {
+        _elements.push_back(elem);
+
+        const string& sourceUri = readString();
+        if (!sourceUri.empty())
+        {
+            elem->setSourceUri(sourceUri);
+        }
+
+        uint64_t attrCount = readInteger();
+        for (uint64_t i = 0; i < attrCount; i++)
+        {
+            const string& attrName = readString();
+            const string& attrValue = readString();
+            elem->setAttribute(attrName, attrValue);
+        }
+
+        uint64_t childCount = readInteger();
+        for (uint64_t i = 0; i < childCount; i++)
+        {
+            const string& category = readString();
+            const string& name = readString();
+            ElementPtr child = elem->addChildOfCategory(category, name);
+            readElementContent(child);
+        }
+    }
+
+    template <class T> void readIndexEntries(vector<std::pair<string, shared_ptr<T>>>& entries)
+    {
+        uint64_t entryCount = readInteger();
+        entries.reserve((size_t) std::min<uint64_t>(entryCount, _elements.size()));
+        for (uint64_t i = 0; i < entryCount; i++)
+        {
+            uint64_t elementIndex = readInteger();
+            shared_ptr<T> elem = elementIndex < _elements.size() ? _elements[(size_t) elementIndex]->asA<T>() : nullptr;
+            if (!elem)
+            {
+                throw ExceptionParseError("Binary data has an invalid element index");
+            }
+            entries.emplace_back(readString(), elem);
+        }
+    }
+
+    void error() const
+    {
+        throw ExceptionParseError("Unexpected end of binary data");
+    }
+
+  private:
+    const char* _pos;
+    const char* _end;
+    StringVec _strings;
+    vector<ElementPtr> _elements;
+};
+
+} // anonymous namespace
+
+//
+// BinaryReadOptions methods
+//
+
+BinaryReadOptions::BinaryReadOptions() :
+    readElementIndex(true),
+    applyFutureUpdates(false)
+{
+}
+
+//
+// BinaryWriteOptions methods
+//
+
+BinaryWriteOptions::BinaryWriteOptions() :
+    writeElementIndex(true)
+{
+}
+
+//
+// Reading
+//
+
+void readFromBinaryBuffer(DocumentPtr doc, const char* buffer, size_t size, const BinaryReadOptions* readOptions)
+{
+    BinaryReader(buffer, size).read(doc, readOptions);
+}
+
+void readFromBinaryStream(DocumentPtr doc, std::istream& stream, const BinaryReadOptions* readOptions)
+{
+    string buffer((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+    readFromBinaryBuffer(doc, buffer.data(), buffer.size(), readOptions);
+}
+
+void readFromBinaryFile(DocumentPtr doc, const FilePath& filename, const FileSearchPath& searchPath, const BinaryReadOptions* readOptions)
+{
+    FileSearchPath fullSearchPath = searchPath;
+    fullSearchPath.append(getEnvironmentPath());
+    FilePath resolvedFilename = fullSearchPath.find(filename);
+
+    std::ifstream stream(resolvedFilename.asString(), std::ios_base::in | std::ios_base::binary);
+    if (!stream)
+    {
+        throw ExceptionFileMissing("Failed to open file for reading: " + resolvedFilename.asString());
+    }
+
+    doc->setSourceUri(filename);
+    readFromBinaryStream(doc, stream, readOptions);
+}
+
+//
+// Writing
+//
+
+void writeToBinaryStream(DocumentPtr doc, std::ostream& stream, const BinaryWriteOptions* writeOptions)
+{
+    stream << writeToBinaryString(doc, writeOptions);
+}
+
+void writeToBinaryFile(DocumentPtr doc, const FilePath& filename, const BinaryWriteOptions* writeOptions)
+{
+    std::ofstream stream(filename.asString(), std::ios_base::out | std::ios_base::binary);
+    writeToBinaryStream(doc, stream, writeOptions);
+}
+
+string writeToBinaryString(DocumentPtr doc, const BinaryWriteOptions* writeOptions)
+{
+    bool writeElementIndex = writeOptions ? writeOptions->writeElementIndex : true;
+    return BinaryWriter().write(doc, writeElementIndex);
+}
+
+} // namespace MaterialX
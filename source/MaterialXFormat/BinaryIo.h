@@ -0,0 +1,132 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#ifndef MATERIALX_BINARYIO_H
+#define MATERIALX_BINARYIO_H
+
+/// @file
+/// Support for a compact binary serialization of MaterialX documents
+///
+/// A binary file consists of a fixed header, holding a magic number, a
+/// format version and a set of flags, followed by a table of the unique
+/// strings of the document and a depth-first encoding of its elements, in
+/// which each category, name and attribute is stored as an index into the
+/// string table.  Files may optionally include a prebuilt element index,
+/// allowing the lookup cache of a document to be restored without a
+/// traversal.  All integers are stored as variable-length unsigned values.
+
+#include <MaterialXCore/Library.h>
+
+#include <MaterialXCore/Document.h>
+
+#include <MaterialXFormat/XmlIo.h>
+
+namespace MaterialX
+{
+
+extern const string MTLX_BINARY_EXTENSION;
+
+/// @class BinaryReadOptions
+/// A set of options for controlling the behavior of binary read functions.
+class BinaryReadOptions
+{
+  public:
+    BinaryReadOptions();
+    ~BinaryReadOptions() { }
+
+    /// If true, then the element index stored in the binary data, if any,
+    /// is used to restore the lookup cache of the document.  The index is
+    /// only applied to documents that are empty before the read, and other
+    /// documents build their cache by traversal.  Defaults to true.
+    bool readElementIndex;
+
+    /// Apply updates that test prototype functionality for future versions
+    /// of MaterialX.  Defaults to false.
+    bool applyFutureUpdates;
+};
+
+/// @class BinaryWriteOptions
+/// A set of options for controlling the behavior of binary write functions.
+class BinaryWriteOptions
+{
+  public:
+    BinaryWriteOptions();
+    ~BinaryWriteOptions() { }
+
+    /// If true, then the entries of the document's lookup cache are stored
+    /// alongside its elements.  Defaults to true.
+    bool writeElementIndex;
+};
+
+/// @name Read Functions
+/// @{
+
+/// Read a Document in binary format from the given buffer.
+/// @param doc The Document into which data is read.
+/// @param buffer The buffer from which data is read.
+/// @param size The size in bytes of the buffer.
+/// @param readOptions An optional pointer to a BinaryReadOptions object.
+///    If provided, then the given options will affect the behavior of the
+///    read function.  Defaults to a null pointer.
+/// @throws ExceptionParseError if the data cannot be parsed.
+void readFromBinaryBuffer(DocumentPtr doc, const char* buffer, size_t size, const BinaryReadOptions* readOptions = nullptr);
+
+/// Read a Document in binary format from the given input stream.
+/// @param doc The Document into which data is read.
+/// @param stream The input stream from which data is read.
+/// @param readOptions An optional pointer to a BinaryReadOptions object.
+///    If provided, then the given options will affect the behavior of the
+///    read function.  Defaults to a null pointer.
+/// @throws ExceptionParseError if the data cannot be parsed.
+void readFromBinaryStream(DocumentPtr doc, std::istream& stream, const BinaryReadOptions* readOptions = nullptr);
+
+/// Read a Document in binary format from the given filename.
+/// @param doc The Document into which data is read.
+/// @param filename The filename from which data is read.
+/// @param searchPath An optional sequence of file paths that will be applied
+///    in order when searching for the given file.
+/// @param readOptions An optional pointer to a BinaryReadOptions object.
+///    If provided, then the given options will affect the behavior of the
+///    read function.  Defaults to a null pointer.
+/// @throws ExceptionParseError if the data cannot be parsed.
+/// @throws ExceptionFileMissing if the file cannot be opened.
+void readFromBinaryFile(DocumentPtr doc,
+                        const FilePath& filename,
+                        const FileSearchPath& searchPath = FileSearchPath(),
+                        const BinaryReadOptions* readOptions = nullptr);
+
+/// @}
+/// @name Write Functions
+/// @{
+
+/// Write a Document in binary format to the given output stream.
+/// @param doc The Document to be written.
+/// @param stream The output stream to which data is written.
+/// @param writeOptions An optional pointer to a BinaryWriteOptions object.
+///    If provided, then the given options will affect the behavior of the
+///    write function.  Defaults to a null pointer.
+void writeToBinaryStream(DocumentPtr doc, std::ostream& stream, const BinaryWriteOptions* writeOptions = nullptr);
+
+/// Write a Document in binary format to the given filename.
+/// @param doc The Document to be written.
+/// @param filename The filename to which data is written.
+/// @param writeOptions An optional pointer to a BinaryWriteOptions object.
+///    If provided, then the given options will affect the behavior of the
+///    write function.  Defaults to a null pointer.
+void writeToBinaryFile(DocumentPtr doc, const FilePath& filename, const BinaryWriteOptions* writeOptions = nullptr);
+
+/// Write a Document in binary format to a new string, returned by value.
+/// @param doc The Document to be written.
+/// @param writeOptions An optional pointer to a BinaryWriteOptions object.
+///    If provided, then the given options will affect the behavior of the
+///    write function.  Defaults to a null pointer.
+/// @return The output string, returned by value
+string writeToBinaryString(DocumentPtr doc, const BinaryWriteOptions* writeOptions = nullptr);
+
+/// @}
+
+} // namespace MaterialX
+
+#endif
@@ -22,9 +22,13 @@
 #endif
 
 #include <array>
+#include <atomic>
 #include <cctype>
 #include <cerrno>
+#include <chrono>
 #include <cstring>
+#include <mutex>
+#include <unordered_map>
 
 namespace MaterialX
 {
@@ -142,6 +146,42 @@ bool FilePath::isDirectory() const
 #endif
 }
 
+long long FilePath::getModificationTime() const
+{
+#if defined(_WIN32)
+    WIN32_FILE_ATTRIBUTE_DATA data;
+    if (!GetFileAttributesEx(asString().c_str(), GetFileExInfoStandard, &data))
+        return 0;
+    ULARGE_INTEGER time;
+    time.LowPart = data.ftLastWriteTime.dwLowDateTime;
+    time.HighPart = data.ftLastWriteTime.dwHighDateTime;
+    return (long long) ((time.QuadPart - 116444736000000000ULL) / 10000000ULL);
+#else
+    struct stat sb;
+    if (stat(asString().c_str(), &sb))
+        return 0;
+    return (long long) sb.st_mtime;
+#endif
+}
+
+size_t FilePath::getFileSize() const
+{
+#if defined(_WIN32)
+    WIN32_FILE_ATTRIBUTE_DATA data;
+    if (!GetFileAttributesEx(asString().c_str(), GetFileExInfoStandard, &data))
+        return 0;
+    ULARGE_INTEGER size;
+    size.LowPart = data.nFileSizeLow;
+    size.HighPart = data.nFileSizeHigh;
+    return (size_t) size.QuadPart;
+#else
+    struct stat sb;
+    if (stat(asString().c_str(), &sb))
+        return 0;
+    return (size_t) sb.st_size;
+#endif
+}
+
 FilePathVec FilePath::getFilesInDirectory(const string& extension) const
 {
     FilePathVec files;
@@ -326,6 +366,126 @@ FilePath FilePath::getModulePath()
 #endif
 }
 
+//
+// FileResolutionCache methods
+//
+
+class FileResolutionCache::Data
+{
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    Data() :
+        timeToLive(0.0),
+        hitCount(0),
+        missCount(0)
+    {
+    }
+    ~Data() { }
+
+    // A cached resolution, with the time at which it was resolved.
+    struct Entry
+    {
+        FilePath resolvedPath;
+        Clock::time_point resolveTime;
+    };
+
+    std::mutex mutex;
+    std::unordered_map<string, Entry> entries;
+    double timeToLive;
+    std::atomic<size_t> hitCount;
+    std::atomic<size_t> missCount;
+};
+
+FileResolutionCache::FileResolutionCache() :
+    _data(new Data)
+{
+}
+
+FileResolutionCache::~FileResolutionCache()
+{
+}
+
+FilePath FileResolutionCache::find(const FileSearchPath& searchPath, const FilePath& filename)
+{
+    // Entries are keyed by each path of the sequence and the filename,
+    // separated by null characters.
+    string key;
+    for (const FilePath& path : searchPath)
+    {
+        key += path.asString();
+        key += '\0';
+    }
+    key += filename.asString();
+
+    Data::Clock::time_point now = Data::Clock::now();
+    {
+        std::lock_guard<std::mutex> guard(_data->mutex);
+        auto it = _data->entries.find(key);
+        if (it != _data->entries.end())
+        {
+            std::chrono::duration<double> age = now - it->second.resolveTime;
+            if (_data->timeToLive <= 0.0 || age.count() < _data->timeToLive)
+            {
+                _data->hitCount++;
+                return it->second.resolvedPath;
+            }
+        }
+    }
+
+    // Resolve the filename on the file system, outside of the lock.
+    FileSearchPath uncachedPath(searchPath);
+    uncachedPath.setResolutionCache(nullptr);
+    FilePath resolvedPath = uncachedPath.find(filename);
+    _data->missCount++;
+
+    std::lock_guard<std::mutex> guard(_data->mutex);
+    Data::Entry& entry = _data->entries[key];
+    entry.resolvedPath = resolvedPath;
+    entry.resolveTime = now;
+    return resolvedPath;
+}
+
+void FileResolutionCache::setTimeToLive(double seconds)
+{
+    std::lock_guard<std::mutex> guard(_data->mutex);
+    _data->timeToLive = seconds;
+}
+
+double FileResolutionCache::getTimeToLive() const
+{
+    std::lock_guard<std::mutex> guard(_data->mutex);
+    return _data->timeToLive;
+}
+
+size_t FileResolutionCache::getHitCount() const
+{
+    return _data->hitCount;
+}
+
+size_t FileResolutionCache::getMissCount() const
+{
+    return _data->missCount;
+}
+
+size_t FileResolutionCache::getEntryCount() const
+{
+    std::lock_guard<std::mutex> guard(_data->mutex);
+    return _data->entries.size();
+}
+
+void FileResolutionCache::resetCounters()
+{
+    _data->hitCount = 0;
+    _data->missCount = 0;
+}
+
+void FileResolutionCache::clear()
+{
+    std::lock_guard<std::mutex> guard(_data->mutex);
+    _data->entries.clear();
+}
+
 FileSearchPath getEnvironmentPath(const string& sep)
 {
     string searchPathEnv = getEnviron(MATERIALX_SEARCH_PATH_ENV_VAR);
@@ -15,8 +15,13 @@ namespace MaterialX
 {
 
 class FilePath;
+class FileSearchPath;
+class FileResolutionCache;
 using FilePathVec = vector<FilePath>;
 
+/// A shared pointer to a FileResolutionCache
+using FileResolutionCachePtr = shared_ptr<FileResolutionCache>;
+
 extern const string PATH_LIST_SEPARATOR;
 extern const string MATERIALX_SEARCH_PATH_ENV_VAR;
 
@@ -164,6 +169,14 @@ class FilePath
     /// Return true if the given path is a directory on the file system.
     bool isDirectory() const;
 
+    /// Return the time at which the file at the given path was last modified,
+    /// in seconds since the epoch, or zero if the file does not exist.
+    long long getModificationTime() const;
+
+    /// Return the size in bytes of the file at the given path, or zero if the
+    /// file does not exist.
+    size_t getFileSize() const;
+
     /// Return a vector of all files in the given directory with the given extension.
     FilePathVec getFilesInDirectory(const string& extension) const;
 
@@ -186,6 +199,61 @@ class FilePath
     Type _type;
 };
 
+/// @class FileResolutionCache
+/// A thread-safe cache of the results of FileSearchPath::find.
+///
+/// Each entry maps a sequence of search paths and a filename to the path
+/// that was found on the file system, and filenames that could not be found
+/// are cached as well.  Entries do not observe later changes to the file
+/// system, so the cache should be cleared when files are added or removed,
+/// or given a time-to-live after which entries are resolved again.
+class FileResolutionCache
+{
+  public:
+    FileResolutionCache();
+    ~FileResolutionCache();
+    FileResolutionCache(const FileResolutionCache&) = delete;
+    FileResolutionCache& operator=(const FileResolutionCache&) = delete;
+
+    /// Create a new resolution cache.
+    static FileResolutionCachePtr create()
+    {
+        return std::make_shared<FileResolutionCache>();
+    }
+
+    /// Return the result of searchPath.find(filename), resolving it on the
+    /// file system on the first request and returning the cached result
+    /// thereafter.
+    FilePath find(const FileSearchPath& searchPath, const FilePath& filename);
+
+    /// Set the time-to-live of cache entries, in seconds.  Entries older
+    /// than this are resolved again on their next request.  A value of zero,
+    /// the default, allows entries to live until the cache is cleared.
+    void setTimeToLive(double seconds);
+
+    /// Return the time-to-live of cache entries, in seconds.
+    double getTimeToLive() const;
+
+    /// Return the number of requests served from the cache.
+    size_t getHitCount() const;
+
+    /// Return the number of requests that were resolved on the file system.
+    size_t getMissCount() const;
+
+    /// Return the number of entries in the cache.
+    size_t getEntryCount() const;
+
+    /// Reset the hit and miss counters of the cache.
+    void resetCounters();
+
+    /// Remove all entries from the cache.
+    void clear();
+
+  private:
+    class Data;
+    std::unique_ptr<Data> _data;
+};
+
 /// @class FileSearchPath
 /// A sequence of file paths, which may be queried to find the first instance
 /// of a given filename on the file system.
@@ -283,10 +351,25 @@ class FileSearchPath
         return _paths[index];
     }
 
+    /// Set the resolution cache through which this search path, and any
+    /// copies made from it, find files.  Defaults to a null pointer, in
+    /// which case every request is resolved on the file system.
+    void setResolutionCache(FileResolutionCachePtr cache)
+    {
+        _resolutionCache = cache;
+    }
+
+    /// Return the resolution cache of this search path, if any.
+    FileResolutionCachePtr getResolutionCache() const
+    {
+        return _resolutionCache;
+    }
+
     /// Given an input filename, iterate through each path in this sequence,
     /// returning the first combined path found on the file system.
     /// On success, the combined path is returned; otherwise the original
-    /// filename is returned unmodified.
+    /// filename is returned unmodified.  If a resolution cache has been set,
+    /// then the result is returned through the cache.
     FilePath find(const FilePath& filename) const
     {
         if (_paths.empty() || filename.isEmpty()) 
@@ -295,6 +378,10 @@ class FileSearchPath
         }
         if (!filename.isAbsolute())
         {
+            if (_resolutionCache)
+            {
+                return _resolutionCache->find(*this, filename);
+            }
             for (const FilePath& path : _paths)
             {
                 FilePath combined = path / filename;
@@ -320,6 +407,7 @@ class FileSearchPath
 
   private:
     FilePathVec _paths;
+    FileResolutionCachePtr _resolutionCache;
 };
 
 /// Return a FileSearchPath object from search path environment variable.
@@ -5,6 +5,9 @@
 
 #include <MaterialXFormat/Util.h>
 
+#include <MaterialXCore/Util.h>
+
+#include <exception>
 #include <fstream>
 #include <iostream>
 #include <sstream>
@@ -12,6 +15,28 @@
 namespace MaterialX
 {
 
+namespace {
+
+// Read a library file into a new document, skipping conflicting elements.
+DocumentPtr readLibraryFile(const FilePath& file, const FileSearchPath& searchPath)
+{
+    DocumentPtr libDoc = createDocument();
+    XmlReadOptions readOptions;
+    readOptions.skipConflictingElements = true;
+    readFromXmlFile(libDoc, file, searchPath, &readOptions);
+    return libDoc;
+}
+
+// Import a library document into the given document, skipping conflicting elements.
+void importLibraryFile(DocumentPtr libDoc, DocumentPtr doc)
+{
+    CopyOptions copyOptions;
+    copyOptions.skipConflictingElements = true;
+    doc->importLibrary(libDoc, &copyOptions);
+}
+
+} // anonymous namespace
+
 string readFile(const FilePath& filePath)
 {
     std::ifstream file(filePath.asString(), std::ios::in);
@@ -30,8 +55,9 @@ string readFile(const FilePath& filePath)
 
 void loadDocuments(const FilePath& rootPath, const FileSearchPath& searchPath, const StringSet& skipFiles,
                    const StringSet& includeFiles, vector<DocumentPtr>& documents, StringVec& documentsPaths,
-                   const XmlReadOptions& readOptions, StringVec& errors)
+                   const XmlReadOptions& readOptions, StringVec& errors, unsigned int threadCount)
 {
+    vector<std::pair<FilePath, FilePath>> files;
     for (const FilePath& dir : rootPath.getSubDirectories())
     {
         for (const FilePath& file : dir.getFilesInDirectory(MTLX_EXTENSION))
@@ -39,42 +65,59 @@ void loadDocuments(const FilePath& rootPath, const FileSearchPath& searchPath, c
             if (!skipFiles.count(file) &&
                 (includeFiles.empty() || includeFiles.count(file)))
             {
-                DocumentPtr doc = createDocument();
-                const FilePath filePath = dir / file;
-                try
-                {
-                    FileSearchPath readSearchPath(searchPath);
-                    readSearchPath.append(dir);
-                    readFromXmlFile(doc, filePath, readSearchPath, &readOptions);
-                    documents.push_back(doc);
-                    documentsPaths.push_back(filePath.asString());
-                }
-                catch (Exception& e)
-                {
-                    errors.push_back("Failed to load: " + filePath.asString() + ". Error: " + e.what());
-                }
+                files.emplace_back(dir, file);
             }
         }
     }
+
+    vector<DocumentPtr> fileDocuments(files.size());
+    StringVec fileErrors(files.size());
+    parallelFor(files.size(), threadCount, [&](size_t index)
+    {
+        const FilePath& dir = files[index].first;
+        const FilePath filePath = dir / files[index].second;
+        DocumentPtr doc = createDocument();
+        try
+        {
+            FileSearchPath readSearchPath(searchPath);
+            readSearchPath.append(dir);
+            readFromXmlFile(doc, filePath, readSearchPath, &readOptions);
+            fileDocuments[index] = doc;
+        }
+        catch (Exception& e)
+        {
+            fileErrors[index] = "Failed to load: " + filePath.asString() + ". Error: " + e.what();
+        }
+    });
+
+    for (size_t i = 0; i < files.size(); i++)
+    {
+        if (fileDocuments[i])
+        {
+            documents.push_back(fileDocuments[i]);
+            documentsPaths.push_back((files[i].first / files[i].second).asString());
+        }
+        else
+        {
+            errors.push_back(fileErrors[i]);
+        }
+    }
 }
 
 void loadLibrary(const FilePath& file, DocumentPtr doc, const FileSearchPath* searchPath)
 {
-    DocumentPtr libDoc = createDocument();
-    XmlReadOptions readOptions;
-    readOptions.skipConflictingElements = true;
-    readFromXmlFile(libDoc, file, searchPath ? *searchPath : FileSearchPath(), &readOptions);
-    CopyOptions copyOptions;
-    copyOptions.skipConflictingElements = true;
-    doc->importLibrary(libDoc, &copyOptions);
+    DocumentPtr libDoc = readLibraryFile(file, searchPath ? *searchPath : FileSearchPath());
+    importLibraryFile(libDoc, doc);
 }
 
 StringVec loadLibraries(const StringVec& libraryNames,
                         const FileSearchPath& searchPath,
                         DocumentPtr doc,
-                        const StringSet* excludeFiles)
+                        const StringSet* excludeFiles,
+                        unsigned int threadCount,
+                        StringVec* errors)
 {
-    StringVec loadedLibraries;
+    FilePathVec files;
     for (const std::string& libraryName : libraryNames)
     {
         FilePath libraryPath = searchPath.find(libraryName);
@@ -84,12 +127,75 @@ StringVec loadLibraries(const StringVec& libraryNames,
             {
                 if (!excludeFiles || !excludeFiles->count(filename))
                 {
-                    const FilePath& file = path / filename;
-                    loadLibrary(file, doc, &searchPath);
-                    loadedLibraries.push_back(file.asString());
+                    files.push_back(path / filename);
+                }
+            }
+        }
+    }
+
+    // With a single thread, read and import each file in turn, so that only
+    // one library document is held in memory at a time.
+    StringVec loadedLibraries;
+    if (threadCount == 1)
+    {
+        for (const FilePath& file : files)
+        {
+            DocumentPtr libDoc;
+            try
+            {
+                libDoc = readLibraryFile(file, searchPath);
+            }
+            catch (Exception& e)
+            {
+                if (!errors)
+                {
+                    throw;
                 }
+                errors->push_back("Failed to load: " + file.asString() + ". Error: " + e.what());
+                continue;
+            }
+            importLibraryFile(libDoc, doc);
+            loadedLibraries.push_back(file.asString());
+        }
+        return loadedLibraries;
+    }
+
+    // Otherwise, read and parse files concurrently, recording any failures.
+    vector<DocumentPtr> libDocs(files.size());
+    vector<std::exception_ptr> exceptions(files.size());
+    parallelFor(files.size(), threadCount, [&](size_t index)
+    {
+        try
+        {
+            libDocs[index] = readLibraryFile(files[index], searchPath);
+        }
+        catch (Exception&)
+        {
+            exceptions[index] = std::current_exception();
+        }
+    });
+
+    // Import libraries in file order.
+    for (size_t i = 0; i < files.size(); i++)
+    {
+        if (exceptions[i])
+        {
+            if (!errors)
+            {
+                std::rethrow_exception(exceptions[i]);
+            }
+            try
+            {
+                std::rethrow_exception(exceptions[i]);
+            }
+            catch (Exception& e)
+            {
+                errors->push_back("Failed to load: " + files[i].asString() + ". Error: " + e.what());
             }
+            continue;
         }
+        importLibraryFile(libDocs[i], doc);
+        loadedLibraries.push_back(files[i].asString());
     }
     return loadedLibraries;
 }
@@ -97,11 +203,13 @@ StringVec loadLibraries(const StringVec& libraryNames,
 StringVec loadLibraries(const StringVec& libraryNames,
                         const FilePath& filePath,
                         DocumentPtr doc,
-                        const StringSet* excludeFiles)
+                        const StringSet* excludeFiles,
+                        unsigned int threadCount,
+                        StringVec* errors)
 {
     FileSearchPath searchPath;
     searchPath.append(filePath);
-    return loadLibraries(libraryNames, searchPath, doc, excludeFiles);
+    return loadLibraries(libraryNames, searchPath, doc, excludeFiles, threadCount, errors);
 }
 
 }
@@ -23,26 +23,45 @@ namespace MaterialX
 /// successful, then the empty string is returned.
 string readFile(const FilePath& file);
 
-/// Scans for all documents under a root path and returns documents which can be loaded
+/// Scans for all documents under a root path and returns documents which can be loaded.
+/// Files may be read concurrently, but documents, paths and errors are always returned
+/// in the order of the scan.
+/// @param threadCount The number of threads across which files are read.  A value of
+///    zero selects the hardware concurrency of the system.  Defaults to one.
 void loadDocuments(const FilePath& rootPath, const FileSearchPath& searchPath, const StringSet& skipFiles,
                    const StringSet& includeFiles, vector<DocumentPtr>& documents, StringVec& documentsPaths,
-                   const XmlReadOptions& readOptions, StringVec& errors);
+                   const XmlReadOptions& readOptions, StringVec& errors, unsigned int threadCount = 1);
 
 /// Load a given MaterialX library into a document
 void loadLibrary(const FilePath& file, DocumentPtr doc, const FileSearchPath* searchPath = nullptr);
 
 /// Load all MaterialX files with given library names in given search paths.
 /// Note that all library files will have a URI set on them.
+/// With a single thread, each file is read and imported in turn.  With more
+/// threads, files are read concurrently into separate documents, which are
+/// then imported into the given document in file order, so that the result
+/// is identical to a serial load.
+/// @param threadCount The number of threads across which files are read.  A value of
+///    zero selects the hardware concurrency of the system.  Defaults to one.
+/// @param errors If provided, a message for each file that could not be read is
+///    appended to this vector, and the remaining files are loaded.  Otherwise, the
+///    exception for the first such file is thrown, once all prior files have been
+///    imported.  Defaults to a null pointer.
+/// @return The paths of all files that were loaded.
 StringVec loadLibraries(const StringVec& libraryNames,
                         const FileSearchPath& searchPath,
                         DocumentPtr doc,
-                        const StringSet* excludeFiles = nullptr);
+                        const StringSet* excludeFiles = nullptr,
+                        unsigned int threadCount = 1,
+                        StringVec* errors = nullptr);
 
 /// Load all MaterialX files with given library names in a given path.
 StringVec loadLibraries(const StringVec& libraryNames,
                         const FilePath& filePath,
                         DocumentPtr doc,
-                        const StringSet* excludeFiles = nullptr);
+                        const StringSet* excludeFiles = nullptr,
+                        unsigned int threadCount = 1,
+                        StringVec* errors = nullptr);
 
 } // namespace MaterialX
 
@@ -9,9 +9,32 @@
 
 #include <MaterialXCore/Types.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
 #include <cstring>
+#include <exception>
 #include <fstream>
+#include <iomanip>
+#include <locale>
+#include <mutex>
 #include <sstream>
+#include <typeinfo>
+#include <unordered_set>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 using namespace pugi;
 
@@ -26,7 +49,263 @@ const string XINCLUDE_TAG = "xi:include";
 const string XINCLUDE_NAMESPACE = "xmlns:xi";
 const string XINCLUDE_URL = "http://www.w3.org/2001/XInclude";
 
-void elementFromXml(const xml_node& xmlNode, ElementPtr elem, const XmlReadOptions* readOptions)
+const string READ_PHASE_NAMES[XmlReadStats::PhaseCount] =
+{
+    "parse",
+    "xinclude",
+    "construct",
+    "duplicates",
+    "upgrade"
+};
+
+using Clock = std::chrono::steady_clock;
+
+// Return the time in seconds that has elapsed since the given time point.
+double getElapsedTime(Clock::time_point start)
+{
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Return the read stats of the given read options, if any.
+XmlReadStats* getReadStats(const XmlReadOptions* readOptions)
+{
+    return readOptions ? readOptions->readStats.get() : nullptr;
+}
+
+// The elements and attributes constructed by a read, along with the time
+// spent reading includes and comparing duplicate elements during
+// construction.
+class ReadCounts
+{
+  public:
+    ReadCounts() :
+        elementCount(0),
+        attributeCount(0),
+        includeTime(0.0),
+        duplicateTime(0.0)
+    {
+    }
+    ~ReadCounts() { }
+
+    ReadCounts& operator+=(const ReadCounts& rhs)
+    {
+        elementCount += rhs.elementCount;
+        attributeCount += rhs.attributeCount;
+        includeTime += rhs.includeTime;
+        duplicateTime += rhs.duplicateTime;
+        return *this;
+    }
+
+    size_t elementCount;
+    size_t attributeCount;
+    double includeTime;
+    double duplicateTime;
+};
+
+// A scoped timer, which adds its elapsed time to a phase of the given read
+// stats, if any.
+class ScopedPhaseTimer
+{
+  public:
+    ScopedPhaseTimer(XmlReadStats* stats, XmlReadStats::Phase phase) :
+        _stats(stats),
+        _phase(phase),
+        _start(stats ? Clock::now() : Clock::time_point())
+    {
+    }
+    ~ScopedPhaseTimer()
+    {
+        if (_stats)
+        {
+            _stats->addPhaseTime(_phase, getElapsedTime(_start));
+        }
+    }
+
+  private:
+    XmlReadStats* _stats;
+    XmlReadStats::Phase _phase;
+    Clock::time_point _start;
+};
+
+// Record the given construction counts in read stats, where the elapsed
+// time of construction includes the times of reading includes and comparing
+// duplicate elements.
+void addReadCounts(XmlReadStats* stats, const ReadCounts& counts, double elapsedTime)
+{
+    stats->addPhaseTime(XmlReadStats::PhaseXInclude, counts.includeTime);
+    stats->addPhaseTime(XmlReadStats::PhaseDuplicates, counts.duplicateTime);
+    stats->addPhaseTime(XmlReadStats::PhaseConstruct, std::max(elapsedTime - counts.includeTime - counts.duplicateTime, 0.0));
+    stats->addElementCounts(counts.elementCount, counts.attributeCount);
+}
+
+// Return the number of bytes remaining in the given input stream, or zero
+// if the stream does not support positioning.
+size_t getRemainingStreamSize(std::istream& stream)
+{
+    std::streampos begin = stream.tellg();
+    if (begin == std::streampos(-1))
+    {
+        return 0;
+    }
+    stream.seekg(0, std::ios_base::end);
+    std::streampos end = stream.tellg();
+    stream.seekg(begin);
+    return end > begin ? (size_t) (end - begin) : 0;
+}
+
+// Return true if the given duplicate elements have conflicting content,
+// adding the time of the comparison to the given counts, if any.
+bool hasConflictingContent(ConstElementPtr previous, ConstElementPtr child, ReadCounts* counts)
+{
+    if (!counts)
+    {
+        return *previous != *child;
+    }
+    Clock::time_point start = Clock::now();
+    bool conflicting = *previous != *child;
+    counts->duplicateTime += getElapsedTime(start);
+    return conflicting;
+}
+
+// A private, writable memory mapping of a file, which allows the contents of
+// the file to be parsed in place without first being copied into memory.
+class MappedFile
+{
+  public:
+    MappedFile() :
+        _data(nullptr),
+        _size(0),
+        _releasedSize(0)
+#if defined(_WIN32)
+        , _mapping(nullptr)
+#endif
+    {
+    }
+    ~MappedFile()
+    {
+        close();
+    }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Map the given file into memory, returning true on success.
+    bool open(const FilePath& filename)
+    {
+        close();
+#if defined(_WIN32)
+        HANDLE file = CreateFile(filename.asString().c_str(), GENERIC_READ, FILE_SHARE_READ,
+                                 nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            return false;
+        }
+        LARGE_INTEGER size;
+        if (GetFileSizeEx(file, &size) && size.QuadPart > 0)
+        {
+            _mapping = CreateFileMapping(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+            if (_mapping)
+            {
+                _data = MapViewOfFile(_mapping, FILE_MAP_COPY, 0, 0, 0);
+                _size = _data ? (size_t) size.QuadPart : 0;
+            }
+        }
+        CloseHandle(file);
+#else
+        int file = ::open(filename.asString().c_str(), O_RDONLY);
+        if (file < 0)
+        {
+            return false;
+        }
+        struct stat sb;
+        if (fstat(file, &sb) == 0 && sb.st_size > 0)
+        {
+            void* data = mmap(nullptr, (size_t) sb.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
+            if (data != MAP_FAILED)
+            {
+                _data = data;
+                _size = (size_t) sb.st_size;
+            }
+        }
+        ::close(file);
+#endif
+        if (!_data)
+        {
+            close();
+        }
+        return _data != nullptr;
+    }
+
+    // Release the mapping, if any.
+    void close()
+    {
+#if defined(_WIN32)
+        if (_data)
+        {
+            UnmapViewOfFile(_data);
+        }
+        if (_mapping)
+        {
+            CloseHandle(_mapping);
+            _mapping = nullptr;
+        }
+#else
+        if (_data)
+        {
+            munmap(_data, _size);
+        }
+#endif
+        _data = nullptr;
+        _size = 0;
+        _releasedSize = 0;
+    }
+
+    // Release the memory of all whole pages before the given position in
+    // the mapping, which will not be accessed again.
+    void releaseBefore(const char* position)
+    {
+#if !defined(_WIN32)
+        const char* begin = static_cast<const char*>(_data);
+        if (!_data || position < begin || position >= begin + _size)
+        {
+            return;
+        }
+        size_t pageSize = (size_t) sysconf(_SC_PAGESIZE);
+        size_t releaseSize = ((size_t) (position - begin) / pageSize) * pageSize;
+        if (releaseSize > _releasedSize)
+        {
+            madvise(static_cast<char*>(_data) + _releasedSize, releaseSize - _releasedSize, MADV_DONTNEED);
+            _releasedSize = releaseSize;
+        }
+#else
+        (void) position;
+#endif
+    }
+
+    void* getData() const
+    {
+        return _data;
+    }
+
+    size_t getSize() const
+    {
+        return _size;
+    }
+
+  private:
+    void* _data;
+    size_t _size;
+    size_t _releasedSize;
+#if defined(_WIN32)
+    HANDLE _mapping;
+#endif
+};
+
+// Read the given XML node into an element.  If counts are provided, then
+// the constructed elements and attributes are added to them.  If a mapped
+// file is provided, then the memory of the mapping is released as the
+// children of the node are read.
+void elementFromXml(const xml_node& xmlNode, ElementPtr elem, const XmlReadOptions* readOptions,
+                    ReadCounts* counts = nullptr, MappedFile* mappedFile = nullptr)
 {
     bool skipConflictingElements = readOptions && readOptions->skipConflictingElements;
 
@@ -35,7 +314,11 @@ void elementFromXml(const xml_node& xmlNode, ElementPtr elem, const XmlReadOptio
     {
         if (xmlAttr.name() != Element::NAME_ATTRIBUTE)
         {
-            elem->setAttribute(xmlAttr.name(), xmlAttr.value());
+            elem->setAttribute(xmlAttr.name(), string(xmlAttr.value()));
+            if (counts)
+            {
+                counts->attributeCount++;
+            }
         }
     }
 
@@ -62,81 +345,341 @@ void elementFromXml(const xml_node& xmlNode, ElementPtr elem, const XmlReadOptio
 
         // Create the new element.
         ElementPtr child = elem->addChildOfCategory(category, name, !previous);
-        elementFromXml(xmlChild, child, readOptions);
+        if (counts)
+        {
+            counts->elementCount++;
+        }
+        elementFromXml(xmlChild, child, readOptions, counts);
 
         // Check for conflicting elements.
-        if (previous && *previous != *child)
+        if (previous && hasConflictingContent(previous, child, counts))
         {
             throw Exception("Duplicate element with conflicting content: " + name);
         }
+
+        // Release the mapped source of this child, which has now been read.
+        if (mappedFile && xmlChild.next_sibling())
+        {
+            mappedFile->releaseBefore(xmlChild.next_sibling().name());
+        }
     }
 }
 
-void elementToXml(ConstElementPtr elem, xml_node& xmlNode, const XmlWriteOptions* writeOptions)
+// Read the given XML node into an element, constructing the subtrees of its
+// children concurrently.  Children are created in document order before
+// their subtrees are constructed, and errors are reported in document order,
+// so the results are identical to those of elementFromXml.
+void elementFromXmlParallel(const xml_node& xmlNode, ElementPtr elem, const XmlReadOptions* readOptions,
+                            unsigned int threadCount, ReadCounts* counts = nullptr)
 {
-    bool writeXIncludeEnable = writeOptions ? writeOptions->writeXIncludeEnable : true;
-    ElementPredicate elementPredicate = writeOptions ? writeOptions->elementPredicate : nullptr;
+    bool skipConflictingElements = readOptions && readOptions->skipConflictingElements;
 
-    // Store attributes in XML.
-    if (!elem->getName().empty())
+    // Store attributes in element.
+    for (const xml_attribute& xmlAttr : xmlNode.attributes())
     {
-        xmlNode.append_attribute(Element::NAME_ATTRIBUTE.c_str()) = elem->getName().c_str();
+        if (xmlAttr.name() != Element::NAME_ATTRIBUTE)
+        {
+            elem->setAttribute(xmlAttr.name(), string(xmlAttr.value()));
+            if (counts)
+            {
+                counts->attributeCount++;
+            }
+        }
     }
-    for (const string& attrName : elem->getAttributeNames())
+
+    // Create child elements in document order.
+    vector<xml_node> xmlChildren;
+    vector<ElementPtr> children;
+    vector<ConstElementPtr> previousChildren;
+    for (const xml_node& xmlChild : xmlNode.children())
     {
-        xml_attribute xmlAttr = xmlNode.append_attribute(attrName.c_str());
-        xmlAttr.set_value(elem->getAttribute(attrName).c_str());
+        string category = xmlChild.name();
+        string name = xmlChild.attribute(Element::NAME_ATTRIBUTE.c_str()).value();
+
+        // Check for duplicate elements.
+        ConstElementPtr previous = elem->getChild(name);
+        if (previous && skipConflictingElements)
+        {
+            continue;
+        }
+
+        xmlChildren.push_back(xmlChild);
+        children.push_back(elem->addChildOfCategory(category, name, !previous));
+        previousChildren.push_back(previous);
     }
 
-    // Create child nodes and recurse.
-    StringSet writtenSourceFiles;
-    for (const ConstElementPtr& child : elem->getChildren())
+    // Construct the subtrees of the child elements concurrently, with
+    // separate counts for each subtree.
+    vector<std::exception_ptr> exceptions(children.size());
+    vector<ReadCounts> childCounts(counts ? children.size() : 0);
+    parallelFor(children.size(), threadCount, [&](size_t index)
     {
-        if (elementPredicate && !elementPredicate(child))
+        try
         {
-            continue;
+            elementFromXml(xmlChildren[index], children[index], readOptions, counts ? &childCounts[index] : nullptr);
+        }
+        catch (...)
+        {
+            exceptions[index] = std::current_exception();
+        }
+    });
+
+    // Report errors and conflicting elements in document order.
+    if (counts)
+    {
+        counts->elementCount += children.size();
+        for (const ReadCounts& subtreeCounts : childCounts)
+        {
+            *counts += subtreeCounts;
+        }
+    }
+    for (size_t i = 0; i < children.size(); i++)
+    {
+        if (exceptions[i])
+        {
+            std::rethrow_exception(exceptions[i]);
+        }
+        if (previousChildren[i] && hasConflictingContent(previousChildren[i], children[i], counts))
+        {
+            throw Exception("Duplicate element with conflicting content: " + children[i]->getName());
+        }
+    }
+}
+
+// A writer that serializes a document directly to an output stream while
+// walking its element tree, producing the same bytes as the pugixml writer
+// with its default formatting and two-space indentation.  Output is staged
+// in a fixed-size buffer, so the memory used is independent of the size of
+// the document.
+class XmlStreamWriter
+{
+  public:
+    XmlStreamWriter(std::ostream& stream, const XmlWriteOptions* writeOptions) :
+        _stream(stream),
+        _writeXIncludeEnable(writeOptions ? writeOptions->writeXIncludeEnable : true),
+        _elementPredicate(writeOptions ? writeOptions->elementPredicate : nullptr)
+    {
+        _buffer.reserve(BUFFER_SIZE);
+    }
+
+    void write(ConstDocumentPtr doc)
+    {
+        _docSourceUri = doc->getSourceUri();
+        writeString("<?xml version=\"1.0\"?>\n");
+        writeElement(doc, "materialx", 0);
+        flush();
+    }
+
+  private:
+    // Return true if the given child is written as an XInclude reference.
+    bool isXInclude(const ElementPtr& child) const
+    {
+        return _writeXIncludeEnable && child->hasSourceUri() && child->getSourceUri() != _docSourceUri;
+    }
+
+    void writeElement(ConstElementPtr elem, const string& tag, size_t depth)
+    {
+        // Determine whether any children are written, and whether any of them
+        // are XInclude references, since both affect the start tag.
+        bool hasChildren = false;
+        bool hasXIncludes = false;
+        for (const ElementPtr& child : elem->getChildren())
+        {
+            bool include = isXInclude(child);
+            if ((hasChildren && !include) || (_elementPredicate && !_elementPredicate(child)))
+            {
+                continue;
+            }
+            hasChildren = true;
+            if (include)
+            {
+                hasXIncludes = true;
+                break;
+            }
+        }
+
+        // Write the start tag and attributes.
+        writeIndent(depth);
+        writeChar('<');
+        writeName(tag);
+        if (!elem->getName().empty())
+        {
+            writeAttribute(Element::NAME_ATTRIBUTE, elem->getName());
+        }
+        for (const string& attrName : elem->getAttributeNames())
+        {
+            writeAttribute(attrName, elem->getAttribute(attrName));
         }
+        if (hasXIncludes && !elem->hasAttribute(XINCLUDE_NAMESPACE))
+        {
+            writeAttribute(XINCLUDE_NAMESPACE, XINCLUDE_URL);
+        }
+        if (!hasChildren)
+        {
+            writeString(" />\n");
+            return;
+        }
+        writeString(">\n");
 
-        // Write XInclude references if requested.
-        if (writeXIncludeEnable && child->hasSourceUri())
+        // Write child elements and XInclude references.
+        StringSet writtenSourceFiles;
+        for (const ElementPtr& child : elem->getChildren())
         {
-            string sourceUri = child->getSourceUri();
-            if (sourceUri != elem->getDocument()->getSourceUri())
+            if (_elementPredicate && !_elementPredicate(child))
+            {
+                continue;
+            }
+
+            if (isXInclude(child))
             {
+                const string& sourceUri = child->getSourceUri();
                 if (!writtenSourceFiles.count(sourceUri))
                 {
-                    if (!xmlNode.attribute(XINCLUDE_NAMESPACE.c_str()))
-                    {
-                        xmlNode.append_attribute(XINCLUDE_NAMESPACE.c_str()) = XINCLUDE_URL.c_str();
-                    }
-                    xml_node includeNode = xmlNode.append_child(XINCLUDE_TAG.c_str());
-                    xml_attribute includeAttr = includeNode.append_attribute("href");
-                    FilePath includePath(sourceUri);
-
                     // Write relative include paths in Posix format, and absolute
                     // include paths in native format.
+                    FilePath includePath(sourceUri);
                     FilePath::Format includeFormat = includePath.isAbsolute() ?
                         FilePath::FormatNative : FilePath::FormatPosix;
-                    includeAttr.set_value(includePath.asString(includeFormat).c_str());
+                    writeIndent(depth + 1);
+                    writeChar('<');
+                    writeName(XINCLUDE_TAG);
+                    writeAttribute("href", includePath.asString(includeFormat));
+                    writeString(" />\n");
 
                     writtenSourceFiles.insert(sourceUri);
                 }
                 continue;
             }
+
+            writeElement(child, child->getCategory(), depth + 1);
         }
 
-        xml_node xmlChild = xmlNode.append_child(child->getCategory().c_str());
-        elementToXml(child, xmlChild, writeOptions);
+        // Write the end tag.
+        writeIndent(depth);
+        writeString("</");
+        writeName(tag);
+        writeString(">\n");
+    }
+
+    void writeAttribute(const string& name, const string& value)
+    {
+        writeChar(' ');
+        writeName(name);
+        writeString("=\"");
+        writeEscaped(value);
+        writeChar('"');
+    }
+
+    // Write an element or attribute name, with empty names written as
+    // anonymous, and with content after any embedded null ignored, as in
+    // pugixml.
+    void writeName(const string& name)
+    {
+        writeString(name.empty() ? ":anonymous" : name.c_str());
+    }
+
+    // Write an attribute value with XML escapes applied.  Angle brackets are
+    // written unescaped, following the MaterialX conventions of the pugixml
+    // writer.
+    void writeEscaped(const string& value)
+    {
+        const char* run = value.c_str();
+        for (const char* ptr = run; ; ptr++)
+        {
+            unsigned char ch = (unsigned char) *ptr;
+            if (ch && ch != '&' && ch != '"' && (ch >= 32 || ch == '\t'))
+            {
+                continue;
+            }
+            writeBuffer(run, ptr - run);
+            if (!ch)
+            {
+                break;
+            }
+            if (ch == '&')
+            {
+                writeString("&amp;");
+            }
+            else if (ch == '"')
+            {
+                writeString("&quot;");
+            }
+            else
+            {
+                const char escape[] = { '&', '#', (char) ('0' + ch / 10), (char) ('0' + ch % 10), ';' };
+                writeBuffer(escape, sizeof(escape));
+            }
+            run = ptr + 1;
+        }
+    }
+
+    void writeIndent(size_t depth)
+    {
+        for (size_t i = 0; i < depth; i++)
+        {
+            writeBuffer("  ", 2);
+        }
+    }
+
+    void writeString(const char* str)
+    {
+        writeBuffer(str, std::strlen(str));
+    }
+
+    void writeChar(char ch)
+    {
+        writeBuffer(&ch, 1);
+    }
+
+    void writeBuffer(const char* data, size_t size)
+    {
+        if (_buffer.size() + size > BUFFER_SIZE)
+        {
+            flush();
+            if (size > BUFFER_SIZE)
+            {
+                _stream.write(data, size);
+                return;
+            }
+        }
+        _buffer.append(data, size);
     }
-}
 
-void xmlDocumentFromFile(xml_document& xmlDoc, FilePath filename, FileSearchPath searchPath)
+    void flush()
+    {
+        _stream.write(_buffer.data(), _buffer.size());
+        _buffer.clear();
+    }
+
+  private:
+    static const size_t BUFFER_SIZE = 16384;
+
+    std::ostream& _stream;
+    bool _writeXIncludeEnable;
+    ElementPredicate _elementPredicate;
+    string _docSourceUri;
+    string _buffer;
+};
+
+// Load the given file into an XML document, replacing the given filename
+// with its resolved path.  If a mapped file is provided, then the file is
+// mapped into memory and parsed in place, and the mapping must outlive the
+// XML document.
+void xmlDocumentFromFile(xml_document& xmlDoc, FilePath& filename, FileSearchPath searchPath, MappedFile* mappedFile = nullptr)
 {
     searchPath.append(getEnvironmentPath());
 
     filename = searchPath.find(filename);
 
-    xml_parse_result result = xmlDoc.load_file(filename.asString().c_str());
+    xml_parse_result result;
+    if (mappedFile && mappedFile->open(filename))
+    {
+        result = xmlDoc.load_buffer_inplace(mappedFile->getData(), mappedFile->getSize());
+    }
+    else
+    {
+        result = xmlDoc.load_file(filename.asString().c_str());
+    }
     if (!result)
     {
         if (result.status == xml_parse_status::status_file_not_found ||
@@ -153,6 +696,67 @@ void xmlDocumentFromFile(xml_document& xmlDoc, FilePath filename, FileSearchPath
     }
 }
 
+// Return the search path for the XInclude references of the given document,
+// with the directory of the document prepended to accommodate includes
+// relative to the parent file location.
+FileSearchPath getIncludeSearchPath(ConstDocumentPtr doc, const FileSearchPath& searchPath)
+{
+    FileSearchPath includeSearchPath;
+    string parentUri = doc->getSourceUri();
+    if (!parentUri.empty())
+    {
+        FilePath filePath = searchPath.find(parentUri);
+        if (!filePath.isEmpty())
+        {
+            // Remove the file name from the path as we want the path to the containing folder.
+            includeSearchPath = searchPath;
+            includeSearchPath.prepend(filePath.getParentPath());
+        }
+    }
+
+    // Set default search path if no parent path found
+    if (includeSearchPath.isEmpty())
+    {
+        includeSearchPath = searchPath;
+    }
+    return includeSearchPath;
+}
+
+// Read the given XInclude reference into a library document, or fetch the
+// library document from the include cache.
+ConstDocumentPtr readXInclude(const string& filename, const FileSearchPath& includeSearchPath, const XmlReadOptions* readOptions)
+{
+    XmlReadFunction readXIncludeFunction = readOptions ? readOptions->readXIncludeFunction : readFromXmlFile;
+
+    // Check for XInclude cycles.
+    if (readOptions)
+    {
+        const StringVec& parents = readOptions->parentXIncludes;
+        if (std::find(parents.begin(), parents.end(), filename) != parents.end())
+        {
+            throw ExceptionParseError("XInclude cycle detected.");
+        }
+    }
+
+    XmlReadOptions xiReadOptions = readOptions ? *readOptions : XmlReadOptions();
+    xiReadOptions.parentXIncludes.push_back(filename);
+    if (xiReadOptions.readStats)
+    {
+        xiReadOptions.readStats = xiReadOptions.readStats->addInclude(filename);
+    }
+
+    // Filtered includes are not cached, as the cache is not keyed by
+    // element predicate.
+    if (xiReadOptions.includeCache && !xiReadOptions.elementPredicate)
+    {
+        return xiReadOptions.includeCache->getInclude(filename, includeSearchPath, xiReadOptions);
+    }
+
+    DocumentPtr library = createDocument();
+    readXIncludeFunction(library, filename, includeSearchPath, &xiReadOptions);
+    return library;
+}
+
 void processXIncludes(DocumentPtr doc, xml_node& xmlNode, const FileSearchPath& searchPath, const XmlReadOptions* readOptions)
 {
     // Search path for includes. Set empty and then evaluated once in the iteration through xml includes.
@@ -167,47 +771,13 @@ void processXIncludes(DocumentPtr doc, xml_node& xmlNode, const FileSearchPath&
             // Read XInclude references if requested.
             if (readXIncludeFunction)
             {
-                string filename = xmlChild.attribute("href").value();
-
-                // Check for XInclude cycles.
-                if (readOptions)
-                {
-                    const StringVec& parents = readOptions->parentXIncludes;
-                    if (std::find(parents.begin(), parents.end(), filename) != parents.end())
-                    {
-                        throw ExceptionParseError("XInclude cycle detected.");
-                    }
-                }
-
-                // Read the included file into a library document.
-                DocumentPtr library = createDocument();
-                XmlReadOptions xiReadOptions = readOptions ? *readOptions : XmlReadOptions();
-                xiReadOptions.parentXIncludes.push_back(filename);
-
-                // Prepend the directory of the parent to accommodate
-                // includes relative to the parent file location.
                 if (includeSearchPath.isEmpty())
                 {
-                    string parentUri = doc->getSourceUri();
-                    if (!parentUri.empty())
-                    {
-                        FilePath filePath = searchPath.find(parentUri);
-                        if (!filePath.isEmpty())
-                        {
-                            // Remove the file name from the path as we want the path to the containing folder.
-                            includeSearchPath = searchPath;
-                            includeSearchPath.prepend(filePath.getParentPath());
-                        }
-                    }
-                    // Set default search path if no parent path found
-                    if (includeSearchPath.isEmpty())
-                    {
-                        includeSearchPath = searchPath;
-                    }
+                    includeSearchPath = getIncludeSearchPath(doc, searchPath);
                 }
-                readXIncludeFunction(library, filename, includeSearchPath, &xiReadOptions);
 
-                // Import the library document.
+                // Read and import the library document.
+                ConstDocumentPtr library = readXInclude(xmlChild.attribute("href").value(), includeSearchPath, readOptions);
                 doc->importLibrary(library, readOptions);
             }
 
@@ -226,22 +796,789 @@ void processXIncludes(DocumentPtr doc, xml_node& xmlNode, const FileSearchPath&
 void documentFromXml(DocumentPtr doc,
                      const xml_document& xmlDoc,
                      const FileSearchPath& searchPath = FileSearchPath(),
-                     const XmlReadOptions* readOptions = nullptr)
+                     const XmlReadOptions* readOptions = nullptr,
+                     MappedFile* mappedFile = nullptr)
 {
     ScopedUpdate update(doc);
     doc->onRead();
 
+    XmlReadStats* stats = getReadStats(readOptions);
     xml_node xmlRoot = xmlDoc.child(Document::CATEGORY.c_str());
     if (xmlRoot)
     {
-        processXIncludes(doc, xmlRoot, searchPath, readOptions);
-        elementFromXml(xmlRoot, doc, readOptions);
+        {
+            ScopedPhaseTimer timer(stats, XmlReadStats::PhaseXInclude);
+            processXIncludes(doc, xmlRoot, searchPath, readOptions);
+        }
+
+        // Construct elements concurrently if requested, unless the callbacks
+        // of a document subclass may not support concurrent edits.
+        ReadCounts counts;
+        Clock::time_point start = stats ? Clock::now() : Clock::time_point();
+        unsigned int threadCount = readOptions ? readOptions->buildThreadCount : 1;
+        if (threadCount != 1 && typeid(*doc) == typeid(Document))
+        {
+            elementFromXmlParallel(xmlRoot, doc, readOptions, threadCount, stats ? &counts : nullptr);
+        }
+        else
+        {
+            elementFromXml(xmlRoot, doc, readOptions, stats ? &counts : nullptr, mappedFile);
+        }
+        if (stats)
+        {
+            addReadCounts(stats, counts, getElapsedTime(start));
+        }
+    }
+
+    ScopedPhaseTimer timer(stats, XmlReadStats::PhaseUpgrade);
+    bool applyFutureUpdates = readOptions ? readOptions->applyFutureUpdates : false;
+    doc->upgradeVersion(applyFutureUpdates);
+}
+
+// An incremental XML parser, which reads its input in fixed-size blocks and
+// issues element events to a stream handler.  Only the chain of open elements
+// is retained between events.
+class XmlStreamParser
+{
+  public:
+    XmlStreamParser(std::istream& stream, XmlStreamHandler& handler, const string& source) :
+        _stream(stream),
+        _handler(handler),
+        _source(source),
+        _buffer(BLOCK_SIZE),
+        _pos(0),
+        _end(0),
+        _offset(0)
+    {
+    }
+
+    void parse()
+    {
+        bool foundElement = false;
+        while (true)
+        {
+            // Skip character data, which is not represented in MaterialX.
+            int c = get();
+            while (c != EOF && c != '<')
+            {
+                c = get();
+            }
+            if (c == EOF)
+            {
+                break;
+            }
+
+            c = peek();
+            if (c == '?')
+            {
+                skipPast("?>", "Unterminated processing instruction");
+            }
+            else if (c == '!')
+            {
+                get();
+                parseMarkupDeclaration();
+            }
+            else if (c == '/')
+            {
+                get();
+                parseEndTag();
+            }
+            else
+            {
+                parseStartTag();
+                foundElement = true;
+            }
+        }
+
+        if (!_openElements.empty())
+        {
+            error("Start-end tags mismatch");
+        }
+        if (!foundElement)
+        {
+            error("No document element found");
+        }
+    }
+
+  private:
+    int peek()
+    {
+        if (_pos == _end && !fill())
+        {
+            return EOF;
+        }
+        return (unsigned char) _buffer[_pos];
+    }
+
+    int get()
+    {
+        int c = peek();
+        if (c != EOF)
+        {
+            _pos++;
+        }
+        return c;
+    }
+
+    bool fill()
+    {
+        _offset += _end;
+        _pos = 0;
+        _end = 0;
+        if (_stream)
+        {
+            _stream.read(_buffer.data(), (std::streamsize) _buffer.size());
+            _end = (size_t) _stream.gcount();
+        }
+        return _end > 0;
+    }
+
+    static bool isSpace(int c)
+    {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+    }
+
+    void skipSpace()
+    {
+        while (isSpace(peek()))
+        {
+            get();
+        }
+    }
+
+    void expect(char expected, const char* desc)
+    {
+        if (get() != expected)
+        {
+            error(desc);
+        }
+    }
+
+    void skipPast(const char* terminator, const char* desc)
+    {
+        size_t length = strlen(terminator);
+        string window;
+        for (int c = get(); c != EOF; c = get())
+        {
+            window.push_back((char) c);
+            if (window.size() > length)
+            {
+                window.erase(0, 1);
+            }
+            if (window == terminator)
+            {
+                return;
+            }
+        }
+        error(desc);
+    }
+
+    void parseMarkupDeclaration()
+    {
+        int c = peek();
+        if (c == '-')
+        {
+            get();
+            expect('-', "Error parsing comment");
+            skipPast("-->", "Error parsing comment");
+        }
+        else if (c == '[')
+        {
+            for (const char* p = "[CDATA["; *p; p++)
+            {
+                expect(*p, "Error parsing CDATA section");
+            }
+            skipPast("]]>", "Error parsing CDATA section");
+        }
+        else
+        {
+            // Skip document type declarations, including internal subsets,
+            // ignoring markup characters within quoted literals.
+            int depth = 0;
+            for (c = get(); c != EOF; c = get())
+            {
+                if (c == '"' || c == '\'')
+                {
+                    int quote = c;
+                    for (c = get(); c != EOF && c != quote; c = get())
+                    {
+                    }
+                    if (c == EOF)
+                    {
+                        break;
+                    }
+                }
+                else if (c == '[')
+                {
+                    depth++;
+                }
+                else if (c == ']')
+                {
+                    depth--;
+                }
+                else if (c == '>' && depth <= 0)
+                {
+                    return;
+                }
+            }
+            error("Error parsing document type declaration");
+        }
+    }
+
+    // Return true if the given character may begin an XML name.  Non-ASCII
+    // characters are accepted as the bytes of UTF-8 encoded name characters.
+    static bool isNameStartChar(int c)
+    {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+               c == '_' || c == ':' || c >= 0x80;
+    }
+
+    static bool isNameChar(int c)
+    {
+        return isNameStartChar(c) || (c >= '0' && c <= '9') || c == '-' || c == '.';
+    }
+
+    void readName(string& name)
+    {
+        name.clear();
+        if (!isNameStartChar(peek()))
+        {
+            error("Error parsing element or attribute name");
+        }
+        while (isNameChar(peek()))
+        {
+            name.push_back((char) get());
+        }
+        int c = peek();
+        if (c != EOF && !isSpace(c) && c != '/' && c != '>' && c != '=')
+        {
+            error("Error parsing element or attribute name");
+        }
+    }
+
+    void readEntity(string& value)
+    {
+        string entity;
+        for (int c = peek(); c != EOF && entity.size() < 16 && (isalnum(c) || c == '#'); c = peek())
+        {
+            entity.push_back((char) get());
+        }
+        if (peek() != ';')
+        {
+            value += "&" + entity;
+            return;
+        }
+        get();
+
+        if (entity == "lt")
+        {
+            value.push_back('<');
+        }
+        else if (entity == "gt")
+        {
+            value.push_back('>');
+        }
+        else if (entity == "amp")
+        {
+            value.push_back('&');
+        }
+        else if (entity == "quot")
+        {
+            value.push_back('"');
+        }
+        else if (entity == "apos")
+        {
+            value.push_back('\'');
+        }
+        else if (!entity.empty() && entity[0] == '#')
+        {
+            // Numeric references must name a valid character, excluding the
+            // null character and the UTF-16 surrogate range.
+            bool hex = entity.size() > 1 && entity[1] == 'x';
+            const char* digits = entity.c_str() + (hex ? 2 : 1);
+            bool valid = *digits != '\0';
+            for (const char* p = digits; *p; p++)
+            {
+                valid = valid && (hex ? isxdigit((unsigned char) *p) : isdigit((unsigned char) *p));
+            }
+            unsigned long code = valid ? std::strtoul(digits, nullptr, hex ? 16 : 10) : 0;
+            if (code == 0 || code > 0x10FFFF || (code >= 0xD800 && code <= 0xDFFF))
+            {
+                error("Invalid character reference");
+            }
+            appendUtf8(value, code);
+        }
+        else
+        {
+            value += "&" + entity + ";";
+        }
+    }
+
+    static void appendUtf8(string& value, unsigned long code)
+    {
+        if (code < 0x80)
+        {
+            value.push_back((char) code);
+        }
+        else if (code < 0x800)
+        {
+            value.push_back((char) (0xC0 | (code >> 6)));
+            value.push_back((char) (0x80 | (code & 0x3F)));
+        }
+        else if (code < 0x10000)
+        {
+            value.push_back((char) (0xE0 | (code >> 12)));
+            value.push_back((char) (0x80 | ((code >> 6) & 0x3F)));
+            value.push_back((char) (0x80 | (code & 0x3F)));
+        }
+        else
+        {
+            value.push_back((char) (0xF0 | (code >> 18)));
+            value.push_back((char) (0x80 | ((code >> 12) & 0x3F)));
+            value.push_back((char) (0x80 | ((code >> 6) & 0x3F)));
+            value.push_back((char) (0x80 | (code & 0x3F)));
+        }
+    }
+
+    void readAttributeValue(string& value)
+    {
+        int quote = get();
+        if (quote != '"' && quote != '\'')
+        {
+            error("Error parsing attribute value");
+        }
+
+        // Resolve entity references, and convert whitespace characters to
+        // spaces, following the attribute normalization of the DOM parser.
+        value.clear();
+        for (int c = get(); c != quote; c = get())
+        {
+            if (c == EOF)
+            {
+                error("Error parsing attribute value");
+            }
+            else if (c == '&')
+            {
+                readEntity(value);
+            }
+            else if (c == '\r')
+            {
+                if (peek() == '\n')
+                {
+                    get();
+                }
+                value.push_back(' ');
+            }
+            else if (c == '\n' || c == '\t')
+            {
+                value.push_back(' ');
+            }
+            else
+            {
+                value.push_back((char) c);
+            }
+        }
+    }
+
+    void parseStartTag()
+    {
+        readName(_category);
+        _attributes.clear();
+        while (true)
+        {
+            skipSpace();
+            int c = peek();
+            if (c == '>')
+            {
+                get();
+                _handler.beginElement(_category, _attributes);
+                _openElements.push_back(_category);
+                return;
+            }
+            if (c == '/')
+            {
+                get();
+                expect('>', "Error parsing start element tag");
+                _handler.beginElement(_category, _attributes);
+                _handler.endElement(_category);
+                return;
+            }
+            if (c == EOF)
+            {
+                error("Error parsing start element tag");
+            }
+
+            _attributes.emplace_back();
+            readName(_attributes.back().first);
+            skipSpace();
+            expect('=', "Error parsing attribute");
+            skipSpace();
+            readAttributeValue(_attributes.back().second);
+        }
+    }
+
+    void parseEndTag()
+    {
+        readName(_category);
+        skipSpace();
+        expect('>', "Error parsing end element tag");
+        if (_openElements.empty() || _openElements.back() != _category)
+        {
+            error("Start-end tags mismatch");
+        }
+        _openElements.pop_back();
+        _handler.endElement(_category);
+    }
+
+    void error(const char* desc) const
+    {
+        string offset = std::to_string(_offset + _pos);
+        throw ExceptionParseError("XML parse error in " + _source +
+                                  " (" + string(desc) + " at character " + offset + ")");
+    }
+
+  private:
+    static const size_t BLOCK_SIZE = 64 * 1024;
+
+    std::istream& _stream;
+    XmlStreamHandler& _handler;
+    string _source;
+    vector<char> _buffer;
+    size_t _pos;
+    size_t _end;
+    size_t _offset;
+
+    string _category;
+    XmlAttributeVec _attributes;
+    StringVec _openElements;
+};
+
+// A stream handler that constructs the elements of a document, skipping
+// the subtrees of elements that are rejected by the element predicate of
+// the given read options.
+class XmlDocumentBuilder : public XmlStreamHandler
+{
+  public:
+    XmlDocumentBuilder(DocumentPtr doc, const FileSearchPath& searchPath, const XmlReadOptions* readOptions) :
+        _doc(doc),
+        _searchPath(searchPath),
+        _readOptions(readOptions),
+        _elementPredicate(readOptions ? readOptions->elementPredicate : nullptr),
+        _skipConflictingElements(readOptions && readOptions->skipConflictingElements),
+        _rootFound(false),
+        _skipDepth(0),
+        _includedCount(0),
+        _counts(readOptions && readOptions->readStats ? new ReadCounts : nullptr)
+    {
+    }
+
+    // Return the counts of the elements and attributes constructed by the
+    // builder, if read stats were requested.
+    const ReadCounts* getCounts() const
+    {
+        return _counts.get();
+    }
+
+    void beginElement(const string& category, const XmlAttributeVec& attributes) override
+    {
+        if (_skipDepth)
+        {
+            _skipDepth++;
+            return;
+        }
+
+        // Only the first root element with the document category is read.
+        if (_openElements.empty())
+        {
+            if (_rootFound || category != Document::CATEGORY)
+            {
+                _skipDepth = 1;
+                return;
+            }
+            _rootFound = true;
+            setAttributes(_doc, attributes, _counts.get());
+            _openElements.emplace_back(_doc, nullptr);
+            return;
+        }
+
+        ElementPtr parent = _openElements.back().first;
+        if (parent == _doc && category == XINCLUDE_TAG)
+        {
+            processXInclude(attributes);
+            _skipDepth = 1;
+            return;
+        }
+
+        string name;
+        for (const auto& attr : attributes)
+        {
+            if (attr.first == Element::NAME_ATTRIBUTE)
+            {
+                name = attr.second;
+                break;
+            }
+        }
+
+        // Check for duplicate elements.
+        ConstElementPtr previous = parent->getChild(name);
+        if (previous && _skipConflictingElements)
+        {
+            _skipDepth = 1;
+            return;
+        }
+
+        // Create the new element without registering it, and test it against
+        // the element predicate before it joins the tree, so that rejected
+        // elements issue no add or remove notifications and leave the child
+        // order of the parent untouched.
+        ElementPtr child = parent->addChildOfCategory(category, name, false);
+        setAttributes(child, attributes, _counts.get());
+        if (_elementPredicate && !_elementPredicate(child))
+        {
+            _skipDepth = 1;
+            return;
+        }
+        if (!previous)
+        {
+            parent->attachChild(child);
+        }
+        if (_counts)
+        {
+            _counts->elementCount++;
+        }
+        _openElements.emplace_back(child, previous);
+    }
+
+    void endElement(const string&) override
+    {
+        if (_skipDepth)
+        {
+            _skipDepth--;
+            return;
+        }
+
+        // Check for conflicting elements.
+        ElementPtr child = _openElements.back().first;
+        ConstElementPtr previous = _openElements.back().second;
+        _openElements.pop_back();
+        if (previous && hasConflictingContent(previous, child, _counts.get()))
+        {
+            throw Exception("Duplicate element with conflicting content: " + child->getName());
+        }
+    }
+
+  private:
+    static void setAttributes(ElementPtr elem, const XmlAttributeVec& attributes, ReadCounts* counts)
+    {
+        for (const auto& attr : attributes)
+        {
+            if (attr.first != Element::NAME_ATTRIBUTE)
+            {
+                elem->setAttribute(attr.first, attr.second);
+                if (counts)
+                {
+                    counts->attributeCount++;
+                }
+            }
+        }
     }
 
+    void processXInclude(const XmlAttributeVec& attributes)
+    {
+        if (_readOptions && !_readOptions->readXIncludeFunction)
+        {
+            return;
+        }
+
+        string filename;
+        for (const auto& attr : attributes)
+        {
+            if (attr.first == "href")
+            {
+                filename = attr.second;
+                break;
+            }
+        }
+        Clock::time_point start = _counts ? Clock::now() : Clock::time_point();
+        if (_includeSearchPath.isEmpty())
+        {
+            _includeSearchPath = getIncludeSearchPath(_doc, _searchPath);
+        }
+
+        // The DOM reader processes all includes before local elements, so
+        // included elements take precedence over any local elements of the
+        // same name that precede this include.  Set such local elements
+        // aside, so that they may be checked for conflicts as duplicates.
+        ConstDocumentPtr library = readXInclude(filename, _includeSearchPath, _readOptions);
+        vector<ElementPtr> replacedElements;
+        if (library)
+        {
+            const vector<ElementPtr>& children = _doc->getChildren();
+            std::unordered_set<ElementPtr> localElements(children.begin() + _includedCount, children.end());
+            for (ConstElementPtr libraryChild : library->getChildren())
+            {
+                ElementPtr local = _doc->getChild(libraryChild->getQualifiedName(libraryChild->getName()));
+                if (local && localElements.count(local))
+                {
+                    _doc->removeChild(local->getName());
+                    replacedElements.push_back(local);
+                }
+            }
+        }
+
+        // Import the library document, and move its elements ahead of any
+        // local elements in a single reordering.
+        size_t childCount = _doc->getChildren().size();
+        _doc->importLibrary(library, _readOptions);
+        vector<ElementPtr> children = _doc->getChildren();
+        if (children.size() > childCount)
+        {
+            vector<ElementPtr> order;
+            order.reserve(children.size());
+            order.insert(order.end(), children.begin(), children.begin() + _includedCount);
+            order.insert(order.end(), children.begin() + childCount, children.end());
+            order.insert(order.end(), children.begin() + _includedCount, children.begin() + childCount);
+            _doc->setChildOrder(order);
+            _includedCount += children.size() - childCount;
+        }
+        if (!_skipConflictingElements)
+        {
+            for (ElementPtr local : replacedElements)
+            {
+                if (hasConflictingContent(_doc->getChild(local->getName()), local, _counts.get()))
+                {
+                    throw Exception("Duplicate element with conflicting content: " + local->getName());
+                }
+            }
+        }
+        if (_counts)
+        {
+            _counts->includeTime += getElapsedTime(start);
+        }
+    }
+
+  private:
+    DocumentPtr _doc;
+    FileSearchPath _searchPath;
+    FileSearchPath _includeSearchPath;
+    const XmlReadOptions* _readOptions;
+    ElementPredicate _elementPredicate;
+    bool _skipConflictingElements;
+    bool _rootFound;
+    size_t _skipDepth;
+    size_t _includedCount;
+    vector<std::pair<ElementPtr, ConstElementPtr>> _openElements;
+    std::unique_ptr<ReadCounts> _counts;
+};
+
+// Read the given input stream into a document with the streaming parser.
+// As parsing and construction are interleaved in the streaming parser, both
+// are recorded in the construct phase of the read stats.
+void documentFromXmlStream(DocumentPtr doc,
+                           std::istream& stream,
+                           const string& source,
+                           const FileSearchPath& searchPath,
+                           const XmlReadOptions* readOptions)
+{
+    ScopedUpdate update(doc);
+    doc->onRead();
+
+    XmlReadStats* stats = getReadStats(readOptions);
+    Clock::time_point start = stats ? Clock::now() : Clock::time_point();
+    XmlDocumentBuilder builder(doc, searchPath, readOptions);
+    XmlStreamParser(stream, builder, source).parse();
+    if (stats)
+    {
+        addReadCounts(stats, *builder.getCounts(), getElapsedTime(start));
+    }
+
+    ScopedPhaseTimer timer(stats, XmlReadStats::PhaseUpgrade);
     bool applyFutureUpdates = readOptions ? readOptions->applyFutureUpdates : false;
     doc->upgradeVersion(applyFutureUpdates);
 }
 
+// Open the given file for streaming, resolving it against the given search path.
+void openXmlFile(std::ifstream& stream, FilePath& filename, FileSearchPath searchPath)
+{
+    searchPath.append(getEnvironmentPath());
+    filename = searchPath.find(filename);
+
+    stream.open(filename.asString(), std::ios_base::in | std::ios_base::binary);
+    if (!stream)
+    {
+        throw ExceptionFileMissing("Failed to open file for reading: " + filename.asString());
+    }
+}
+
+// A file on which a cached include depends, along with the modification time
+// and size that the file had when the include was read.
+struct IncludeDependency
+{
+    FilePath path;
+    long long modificationTime;
+    size_t fileSize;
+};
+
+using IncludeDependencyVec = vector<IncludeDependency>;
+
+// The dependencies of the include currently being read by the cache on this
+// thread, to which nested includes add their own dependencies.
+thread_local IncludeDependencyVec* activeIncludeDependencies = nullptr;
+
+// Record the given dependencies in those of the include being read, if any.
+void recordIncludeDependencies(const IncludeDependencyVec& dependencies)
+{
+    if (activeIncludeDependencies)
+    {
+        activeIncludeDependencies->insert(activeIncludeDependencies->end(), dependencies.begin(), dependencies.end());
+    }
+}
+
+// Return true if none of the given dependencies have changed on disk.
+bool includeDependenciesUnchanged(const IncludeDependencyVec& dependencies)
+{
+    for (const IncludeDependency& dependency : dependencies)
+    {
+        if (dependency.path.getModificationTime() != dependency.modificationTime ||
+            dependency.path.getFileSize() != dependency.fileSize)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// A scope within which nested includes record their dependencies in the
+// given vector.
+class ScopedIncludeDependencies
+{
+  public:
+    explicit ScopedIncludeDependencies(IncludeDependencyVec& dependencies) :
+        _parent(activeIncludeDependencies)
+    {
+        activeIncludeDependencies = &dependencies;
+    }
+    ~ScopedIncludeDependencies()
+    {
+        activeIncludeDependencies = _parent;
+    }
+
+  private:
+    IncludeDependencyVec* _parent;
+};
+
+// Return true if the given function reads includes with readFromXmlFile.
+bool isStandardIncludeReader(const XmlReadFunction& readFunction)
+{
+    using XmlReadFilePtr = void (*)(DocumentPtr, const FilePath&, const FileSearchPath&, const XmlReadOptions*);
+    if (!readFunction)
+    {
+        return true;
+    }
+    const XmlReadFilePtr* target = readFunction.target<XmlReadFilePtr>();
+    return target && *target == &readFromXmlFile;
+}
+
 } // anonymous namespace
 
 //
@@ -250,8 +1587,370 @@ void documentFromXml(DocumentPtr doc,
 
 XmlReadOptions::XmlReadOptions() :
     readXIncludeFunction(readFromXmlFile),
-    applyFutureUpdates(false)
+    applyFutureUpdates(false),
+    memoryMapFiles(false),
+    buildThreadCount(1)
+{
+}
+
+//
+// XmlReadStats methods
+//
+
+class XmlReadStats::Data
+{
+  public:
+    Data(const string& source) :
+        source(source)
+    {
+        reset();
+    }
+    ~Data() { }
+
+    void reset()
+    {
+        std::fill(phaseTimes, phaseTimes + PhaseCount, 0.0);
+        elementCount = 0;
+        attributeCount = 0;
+        byteCount = 0;
+        includes.clear();
+    }
+
+    std::mutex mutex;
+    string source;
+    double phaseTimes[PhaseCount];
+    size_t elementCount;
+    size_t attributeCount;
+    size_t byteCount;
+    vector<XmlReadStatsPtr> includes;
+};
+
+XmlReadStats::XmlReadStats(const string& source) :
+    _data(new Data(source))
+{
+}
+
+XmlReadStats::~XmlReadStats()
+{
+}
+
+const string& XmlReadStats::getPhaseName(Phase phase)
+{
+    if (phase < 0 || phase >= PhaseCount)
+    {
+        throw Exception("Invalid read phase: " + std::to_string((int) phase));
+    }
+    return READ_PHASE_NAMES[phase];
+}
+
+void XmlReadStats::setSource(const string& source)
+{
+    std::lock_guard<std::mutex> guard(_data->mutex);
+    _data->source = source;
+}
+
+string XmlReadStats::getSource() const
+{
+    std::lock_guard<std::mutex> guard(_data->mutex);
+    return _data->source;
+}
+
+void XmlReadStats::addPhaseTime(Phase phase, double seconds)
+{
+    getPhaseName(phase);
+    std::lock_guard<std::mutex> guard(_data->mutex);
+    _data->phaseTimes[phase] += seconds;
+}
+
+double XmlReadStats::getPhaseTime(Phase phase) const
+{
+    getPhaseName(phase);
+    std::lock_guard<std::mutex> guard(_data->mutex);
+    return _data->phaseTimes[phase];
+}
+
+double XmlReadStats::getTotalTime() const
+{
+    std::lock_guard<std::mutex> guard(_data->mutex);
+    double totalTime = 0.0;
+    for (double phaseTime : _data->phaseTimes)
+    {
+        totalTime += phaseTime;
+    }
+    return totalTime;
+}
+
+void XmlReadStats::addElementCounts(size_t elementCount, size_t attributeCount)
+{
+    std::lock_guard<std::mutex> guard(_data->mutex);
+    _data->elementCount += elementCount;
+    _data->attributeCount += attributeCount;
+}
+
+size_t XmlReadStats::getElementCount() const
+{
+    std::lock_guard<std::mutex> guard(_data->mutex);
+    return _data->elementCount;
+}
+
+size_t XmlReadStats::getAttributeCount() const
+{
+    std::lock_guard<std::mutex> guard(_data->mutex);
+    return _data->attributeCount;
+}
+
+void XmlReadStats::addByteCount(size_t byteCount)
+{
+    std::lock_guard<std::mutex> guard(_data->mutex);
+    _data->byteCount += byteCount;
+}
+
+size_t XmlReadStats::getByteCount() const
+{
+    std::lock_guard<std::mutex> guard(_data->mutex);
+    return _data->byteCount;
+}
+
+XmlReadStatsPtr XmlReadStats::addInclude(const string& source)
+{
+    XmlReadStatsPtr include = create(source);
+    std::lock_guard<std::mutex> guard(_data->mutex);
+    _data->includes.push_back(include);
+    return include;
+}
+
+vector<XmlReadStatsPtr> XmlReadStats::getIncludes() const
+{
+    std::lock_guard<std::mutex> guard(_data->mutex);
+    return _data->includes;
+}
+
+string XmlReadStats::toJson() const
+{
+    string json;
+    writeJson(json, 0);
+    json += '\n';
+    return json;
+}
+
+void XmlReadStats::clear()
+{
+    std::lock_guard<std::mutex> guard(_data->mutex);
+    _data->reset();
+}
+
+void XmlReadStats::writeJson(string& json, size_t depth) const
+{
+    // Escape the given string as a quoted JSON string.
+    auto quote = [](const string& str)
+    {
+        string quoted = "\"";
+        for (char c : str)
+        {
+            if (c == '"' || c == '\\')
+            {
+                quoted += '\\';
+                quoted += c;
+            }
+            else if ((unsigned char) c < 0x20)
+            {
+                const char* hexDigits = "0123456789abcdef";
+                quoted += "\\u00";
+                quoted += hexDigits[(c >> 4) & 0xF];
+                quoted += hexDigits[c & 0xF];
+            }
+            else
+            {
+                quoted += c;
+            }
+        }
+        return quoted + "\"";
+    };
+
+    // Format the given time in seconds in the classic locale.
+    auto formatTime = [](double seconds)
+    {
+        std::ostringstream stream;
+        stream.imbue(std::locale::classic());
+        stream << std::setprecision(9) << seconds;
+        return stream.str();
+    };
+
+    vector<XmlReadStatsPtr> includes = getIncludes();
+    string indent(depth * 4, ' ');
+    string totalTime = formatTime(getTotalTime());
+    {
+        std::lock_guard<std::mutex> guard(_data->mutex);
+        json += "{\n";
+        json += indent + "    \"source\": " + quote(_data->source) + ",\n";
+        json += indent + "    \"byteCount\": " + std::to_string(_data->byteCount) + ",\n";
+        json += indent + "    \"elementCount\": " + std::to_string(_data->elementCount) + ",\n";
+        json += indent + "    \"attributeCount\": " + std::to_string(_data->attributeCount) + ",\n";
+        json += indent + "    \"totalTime\": " + totalTime + ",\n";
+        json += indent + "    \"phaseTimes\": {\n";
+        for (int i = 0; i < PhaseCount; i++)
+        {
+            json += indent + "        " + quote(READ_PHASE_NAMES[i]) + ": " + formatTime(_data->phaseTimes[i]);
+            json += (i + 1 < PhaseCount) ? ",\n" : "\n";
+        }
+        json += indent + "    },\n";
+    }
+    json += indent + "    \"includes\": [";
+    for (size_t i = 0; i < includes.size(); i++)
+    {
+        json += (i == 0) ? "\n" : ",\n";
+        json += indent + "        ";
+        includes[i]->writeJson(json, depth + 2);
+    }
+    json += includes.empty() ? "]\n" : "\n" + indent + "    ]\n";
+    json += indent + "}";
+}
+
+//
+// XmlIncludeCache methods
+//
+
+class XmlIncludeCache::Data
+{
+  public:
+    Data() :
+        hitCount(0),
+        missCount(0),
+        parsedByteCount(0)
+    {
+    }
+    ~Data() { }
+
+    // A cached include, whose mutex serializes the first read of the
+    // include across threads.
+    class Entry
+    {
+      public:
+        Entry() { }
+        ~Entry() { }
+
+        std::mutex mutex;
+        ConstDocumentPtr doc;
+        IncludeDependencyVec dependencies;
+    };
+
+    std::mutex mutex;
+    std::unordered_map<string, shared_ptr<Entry>> entries;
+    std::atomic<size_t> hitCount;
+    std::atomic<size_t> missCount;
+    std::atomic<size_t> parsedByteCount;
+};
+
+XmlIncludeCache::XmlIncludeCache() :
+    _data(new Data)
+{
+}
+
+XmlIncludeCache::~XmlIncludeCache()
+{
+}
+
+ConstDocumentPtr XmlIncludeCache::getInclude(const FilePath& filename,
+                                             const FileSearchPath& searchPath,
+                                             const XmlReadOptions& readOptions)
+{
+    XmlReadFunction readFunction = readOptions.readXIncludeFunction ? readOptions.readXIncludeFunction : readFromXmlFile;
+
+    // Resolve the include in the same way as readFromXmlFile.
+    FileSearchPath resolvePath = searchPath;
+    resolvePath.append(getEnvironmentPath());
+    FilePath resolvedPath = resolvePath.find(filename);
+    if (!resolvedPath.exists() || !isStandardIncludeReader(readFunction))
+    {
+        // Includes that are not found on the file system, or that are read
+        // by a custom function, are passed through without caching.
+        _data->missCount++;
+        DocumentPtr library = createDocument();
+        readFunction(library, filename, searchPath, &readOptions);
+        return library;
+    }
+
+    // Build a key from the resolved path and the context of the include.
+    string key = resolvedPath.asString();
+    key += '\n' + searchPath.asString();
+    for (const string& parent : readOptions.parentXIncludes)
+    {
+        key += '\n' + parent;
+    }
+    key += readOptions.skipConflictingElements ? "\n1" : "\n0";
+    key += readOptions.applyFutureUpdates ? "1" : "0";
+
+    shared_ptr<Data::Entry> entry;
+    {
+        std::lock_guard<std::mutex> guard(_data->mutex);
+        shared_ptr<Data::Entry>& slot = _data->entries[key];
+        if (!slot)
+        {
+            slot = std::make_shared<Data::Entry>();
+        }
+        entry = slot;
+    }
+
+    // Return the cached document if neither the file nor any of its nested
+    // includes have changed, and otherwise read it again.
+    std::lock_guard<std::mutex> guard(entry->mutex);
+    if (entry->doc && includeDependenciesUnchanged(entry->dependencies))
+    {
+        _data->hitCount++;
+        recordIncludeDependencies(entry->dependencies);
+        return entry->doc;
+    }
+
+    _data->missCount++;
+    size_t fileSize = resolvedPath.getFileSize();
+    IncludeDependencyVec dependencies;
+    dependencies.push_back({ resolvedPath, resolvedPath.getModificationTime(), fileSize });
+    DocumentPtr library = createDocument();
+    {
+        ScopedIncludeDependencies scope(dependencies);
+        readFunction(library, filename, searchPath, &readOptions);
+    }
+    library->freeze();
+    _data->parsedByteCount += fileSize;
+    recordIncludeDependencies(dependencies);
+
+    entry->doc = library;
+    entry->dependencies = std::move(dependencies);
+    return library;
+}
+
+size_t XmlIncludeCache::getHitCount() const
+{
+    return _data->hitCount;
+}
+
+size_t XmlIncludeCache::getMissCount() const
+{
+    return _data->missCount;
+}
+
+size_t XmlIncludeCache::getParsedByteCount() const
+{
+    return _data->parsedByteCount;
+}
+
+size_t XmlIncludeCache::getEntryCount() const
+{
+    std::lock_guard<std::mutex> guard(_data->mutex);
+    return _data->entries.size();
+}
+
+void XmlIncludeCache::resetCounters()
+{
+    _data->hitCount = 0;
+    _data->missCount = 0;
+    _data->parsedByteCount = 0;
+}
+
+void XmlIncludeCache::clear()
 {
+    std::lock_guard<std::mutex> guard(_data->mutex);
+    _data->entries.clear();
 }
 
 //
@@ -269,8 +1968,25 @@ XmlWriteOptions::XmlWriteOptions() :
 
 void readFromXmlBuffer(DocumentPtr doc, const char* buffer, const XmlReadOptions* readOptions)
 {
+    XmlReadStats* stats = getReadStats(readOptions);
+    if (stats)
+    {
+        stats->addByteCount(std::strlen(buffer));
+    }
+
+    if (readOptions && readOptions->elementPredicate)
+    {
+        std::istringstream stream(buffer);
+        documentFromXmlStream(doc, stream, "buffer", EMPTY_STRING, readOptions);
+        return;
+    }
+
     xml_document xmlDoc;
-    xml_parse_result result = xmlDoc.load_string(buffer);
+    xml_parse_result result;
+    {
+        ScopedPhaseTimer timer(stats, XmlReadStats::PhaseParse);
+        result = xmlDoc.load_string(buffer);
+    }
     if (!result)
     {
         throw ExceptionParseError("Parse error in readFromXmlBuffer");
@@ -281,8 +1997,24 @@ void readFromXmlBuffer(DocumentPtr doc, const char* buffer, const XmlReadOptions
 
 void readFromXmlStream(DocumentPtr doc, std::istream& stream, const XmlReadOptions* readOptions)
 {
+    XmlReadStats* stats = getReadStats(readOptions);
+    if (stats)
+    {
+        stats->addByteCount(getRemainingStreamSize(stream));
+    }
+
+    if (readOptions && readOptions->elementPredicate)
+    {
+        documentFromXmlStream(doc, stream, "stream", EMPTY_STRING, readOptions);
+        return;
+    }
+
     xml_document xmlDoc;
-    xml_parse_result result = xmlDoc.load(stream);
+    xml_parse_result result;
+    {
+        ScopedPhaseTimer timer(stats, XmlReadStats::PhaseParse);
+        result = xmlDoc.load(stream);
+    }
     if (!result)
     {
         throw ExceptionParseError("Parse error in readFromXmlStream");
@@ -293,8 +2025,26 @@ void readFromXmlStream(DocumentPtr doc, std::istream& stream, const XmlReadOptio
 
 void readFromXmlFile(DocumentPtr doc, const FilePath& filename, const FileSearchPath& searchPath, const XmlReadOptions* readOptions)
 {
+    bool streaming = readOptions && readOptions->elementPredicate;
+    XmlReadStats* stats = getReadStats(readOptions);
+    MappedFile mappedFile;
     xml_document xmlDoc;
-    xmlDocumentFromFile(xmlDoc, filename, searchPath);
+    std::ifstream stream;
+    FilePath resolvedFilename = filename;
+    if (streaming)
+    {
+        openXmlFile(stream, resolvedFilename, searchPath);
+    }
+    else
+    {
+        ScopedPhaseTimer timer(stats, XmlReadStats::PhaseParse);
+        xmlDocumentFromFile(xmlDoc, resolvedFilename, searchPath, readOptions && readOptions->memoryMapFiles ? &mappedFile : nullptr);
+    }
+    if (stats)
+    {
+        stats->setSource(resolvedFilename.asString());
+        stats->addByteCount(resolvedFilename.getFileSize());
+    }
 
     // This must be done before parsing the XML as the source URI
     // is used for searching for include files.
@@ -306,7 +2056,14 @@ void readFromXmlFile(DocumentPtr doc, const FilePath& filename, const FileSearch
     {
         doc->setSourceUri(filename);
     }
-    documentFromXml(doc, xmlDoc, searchPath, readOptions);
+    if (streaming)
+    {
+        documentFromXmlStream(doc, stream, "file: " + resolvedFilename.asString(), searchPath, readOptions);
+    }
+    else
+    {
+        documentFromXml(doc, xmlDoc, searchPath, readOptions, mappedFile.getData() ? &mappedFile : nullptr);
+    }
 }
 
 void readFromXmlString(DocumentPtr doc, const string& str, const XmlReadOptions* readOptions)
@@ -315,6 +2072,23 @@ void readFromXmlString(DocumentPtr doc, const string& str, const XmlReadOptions*
     readFromXmlStream(doc, stream, readOptions);
 }
 
+//
+// Streaming
+//
+
+void streamFromXmlStream(std::istream& stream, XmlStreamHandler& handler)
+{
+    XmlStreamParser(stream, handler, "stream").parse();
+}
+
+void streamFromXmlFile(const FilePath& filename, XmlStreamHandler& handler, const FileSearchPath& searchPath)
+{
+    FilePath resolvedFilename = filename;
+    std::ifstream stream;
+    openXmlFile(stream, resolvedFilename, searchPath);
+    XmlStreamParser(stream, handler, "file: " + resolvedFilename.asString()).parse();
+}
+
 //
 // Writing
 //
@@ -324,10 +2098,7 @@ void writeToXmlStream(DocumentPtr doc, std::ostream& stream, const XmlWriteOptio
     ScopedUpdate update(doc);
     doc->onWrite();
 
-    xml_document xmlDoc;
-    xml_node xmlRoot = xmlDoc.append_child("materialx");
-    elementToXml(doc, xmlRoot, writeOptions);
-    xmlDoc.save(stream, "  ");
+    XmlStreamWriter(stream, writeOptions).write(doc);
 }
 
 void writeToXmlFile(DocumentPtr doc, const FilePath& filename, const XmlWriteOptions* writeOptions)
@@ -19,9 +19,22 @@ namespace MaterialX
 {
 
 class XmlReadOptions;
+class XmlIncludeCache;
+class XmlReadStats;
+class XmlStreamHandler;
 
 extern const string MTLX_EXTENSION;
 
+/// A shared pointer to an XmlIncludeCache
+using XmlIncludeCachePtr = shared_ptr<XmlIncludeCache>;
+
+/// A shared pointer to an XmlReadStats
+using XmlReadStatsPtr = shared_ptr<XmlReadStats>;
+
+/// A vector of attribute name-value pairs, in the order of their appearance
+/// within an XML element.
+using XmlAttributeVec = vector<std::pair<string, string>>;
+
 /// A standard function that reads from an XML file into a Document, with
 /// optional search path and read options.
 using XmlReadFunction = std::function<void(DocumentPtr, const FilePath&, const FileSearchPath&, const XmlReadOptions*)>;
@@ -45,6 +58,252 @@ class XmlReadOptions : public CopyOptions
     /// Apply updates that test prototype functionality for future versions
     /// of MaterialX.  Defaults to false.
     bool applyFutureUpdates;
+
+    /// If true, files will be mapped into memory and parsed in place, rather
+    /// than copied into an intermediate buffer, reducing the peak memory of
+    /// reads from large files.  If a file cannot be mapped, then it is read
+    /// in the standard way.  Defaults to false.
+    bool memoryMapFiles;
+
+    /// The number of threads across which the subtrees of top-level elements
+    /// are constructed after parsing.  A value of zero selects the hardware
+    /// concurrency of the system.  The resulting document is identical to
+    /// one constructed on a single thread.  Documents of subclasses such as
+    /// ObservedDocument, whose callbacks may not support concurrent edits,
+    /// are always constructed on a single thread.  Defaults to one.
+    unsigned int buildThreadCount;
+
+    /// If provided, XInclude references will be read through this cache,
+    /// which may be shared across any number of read operations and threads.
+    /// Defaults to a null pointer.
+    XmlIncludeCachePtr includeCache;
+
+    /// If provided, this function will be used to exclude specific elements
+    /// (those returning false) from the read operation.  The predicate is
+    /// applied to each element once its attributes have been read, and the
+    /// subtrees of excluded elements are skipped without being constructed.
+    ///
+    /// When a predicate is provided, documents are read with the streaming
+    /// reader, whose memory is bounded by the depth of the document rather
+    /// than its size, and the memoryMapFiles, buildThreadCount and
+    /// includeCache options are not applied.  Defaults to nullptr.
+    ElementPredicate elementPredicate;
+
+    /// If provided, the time spent in each phase of the read, along with the
+    /// elements, attributes and bytes that it reads, will be recorded in this
+    /// object, and each XInclude reference that is followed will be recorded
+    /// as a child of this object.  Defaults to a null pointer.
+    XmlReadStatsPtr readStats;
+};
+
+/// @class XmlReadStats
+/// A thread-safe record of the work performed by XML read operations, for
+/// use in profiling document loads.
+///
+/// The wall time of each phase of a read is recorded, along with the number
+/// of elements and attributes constructed and the number of bytes read from
+/// the source.  Each XInclude reference that is followed by the read is
+/// recorded as a child of the stats object, forming a tree that matches the
+/// include structure of the document.  Times and counts exclude the work of
+/// child includes, with the exception of the XInclude phase, whose time
+/// includes the complete reads of the child includes.  Includes that are
+/// served from an XmlIncludeCache record no phases of their own.
+///
+/// If a stats object is shared by several read operations, then its values
+/// accumulate across those operations.
+class XmlReadStats
+{
+  public:
+    /// The phases of an XML read operation.
+    enum Phase
+    {
+        PhaseParse = 0,
+        PhaseXInclude = 1,
+        PhaseConstruct = 2,
+        PhaseDuplicates = 3,
+        PhaseUpgrade = 4,
+        PhaseCount = 5
+    };
+
+  public:
+    XmlReadStats(const string& source = EMPTY_STRING);
+    ~XmlReadStats();
+    XmlReadStats(const XmlReadStats&) = delete;
+    XmlReadStats& operator=(const XmlReadStats&) = delete;
+
+    /// Create a new stats object, with an optional source name.
+    static XmlReadStatsPtr create(const string& source = EMPTY_STRING)
+    {
+        return std::make_shared<XmlReadStats>(source);
+    }
+
+    /// Return the name of the given phase.
+    static const string& getPhaseName(Phase phase);
+
+    /// @name Source
+    /// @{
+
+    /// Set the source of the read, which is the resolved filename for reads
+    /// from files.
+    void setSource(const string& source);
+
+    /// Return the source of the read.
+    string getSource() const;
+
+    /// @}
+    /// @name Phases
+    /// @{
+
+    /// Add the given time in seconds to a phase of the read.
+    void addPhaseTime(Phase phase, double seconds);
+
+    /// Return the time in seconds spent in a phase of the read.
+    double getPhaseTime(Phase phase) const;
+
+    /// Return the time in seconds spent in all phases of the read, including
+    /// the reads of child includes.
+    double getTotalTime() const;
+
+    /// @}
+    /// @name Counters
+    /// @{
+
+    /// Add the given counts of constructed elements and attributes.
+    void addElementCounts(size_t elementCount, size_t attributeCount);
+
+    /// Return the number of elements constructed by the read.
+    size_t getElementCount() const;
+
+    /// Return the number of attributes constructed by the read.
+    size_t getAttributeCount() const;
+
+    /// Add the given number of bytes read from the source.
+    void addByteCount(size_t byteCount);
+
+    /// Return the number of bytes read from the source, or zero if the size
+    /// of the source is unknown.
+    size_t getByteCount() const;
+
+    /// @}
+    /// @name Includes
+    /// @{
+
+    /// Add a child stats object for an XInclude reference, and return it.
+    XmlReadStatsPtr addInclude(const string& source);
+
+    /// Return the child stats objects of XInclude references, in the order
+    /// in which they were read.
+    vector<XmlReadStatsPtr> getIncludes() const;
+
+    /// @}
+    /// @name Utilities
+    /// @{
+
+    /// Return the contents of this object and its child includes as a
+    /// JSON string.
+    string toJson() const;
+
+    /// Reset all times and counters, and remove all child includes.
+    void clear();
+
+    /// @}
+
+  private:
+    void writeJson(string& json, size_t depth) const;
+
+  private:
+    class Data;
+    std::unique_ptr<Data> _data;
+};
+
+/// @class XmlIncludeCache
+/// A thread-safe cache of documents read from XInclude references.
+///
+/// Each unique include is read once, and later references to the same
+/// include are imported from the cached document.  Entries are keyed by the
+/// resolved path of the include, the read options and the chain of parent
+/// includes, which affect the content of the included document.  Each entry
+/// records the modification time and size of the include and of every
+/// include nested within it, so that edits to any of these files cause the
+/// include to be read again.
+///
+/// Only includes read with the standard readFromXmlFile function are
+/// cached.  If the read options provide a custom readXIncludeFunction, then
+/// each include is passed through to that function without caching.
+class XmlIncludeCache
+{
+  public:
+    XmlIncludeCache();
+    ~XmlIncludeCache();
+    XmlIncludeCache(const XmlIncludeCache&) = delete;
+    XmlIncludeCache& operator=(const XmlIncludeCache&) = delete;
+
+    /// Create a new include cache.
+    static XmlIncludeCachePtr create()
+    {
+        return std::make_shared<XmlIncludeCache>();
+    }
+
+    /// Return the document for the given XInclude reference, reading it on
+    /// the first request and returning the cached document thereafter.
+    /// Cached documents are frozen, and must be imported into a target
+    /// document rather than edited.
+    /// @param filename The filename of the XInclude reference.
+    /// @param searchPath The search path used to resolve the filename.
+    /// @param readOptions The read options for the included document.
+    /// @throws ExceptionFileMissing if the file cannot be opened.
+    ConstDocumentPtr getInclude(const FilePath& filename,
+                                const FileSearchPath& searchPath,
+                                const XmlReadOptions& readOptions);
+
+    /// Return the number of include requests served from the cache.
+    size_t getHitCount() const;
+
+    /// Return the number of include requests that required a read.
+    size_t getMissCount() const;
+
+    /// Return the total size in bytes of the include files that have been
+    /// read by the cache.
+    size_t getParsedByteCount() const;
+
+    /// Return the number of unique includes that have been requested from
+    /// the cache since it was last cleared.
+    size_t getEntryCount() const;
+
+    /// Reset the hit, miss and parsed byte counters of the cache.
+    void resetCounters();
+
+    /// Remove all documents from the cache.
+    void clear();
+
+  private:
+    class Data;
+    std::unique_ptr<Data> _data;
+};
+
+/// @class XmlStreamHandler
+/// An interface for receiving the element events of a streaming XML read.
+///
+/// Events are issued in document order as the input is parsed, and the
+/// reader retains no state beyond the chain of currently open elements, so
+/// the memory of a streaming read is bounded by the depth of the document
+/// rather than its size.
+class XmlStreamHandler
+{
+  public:
+    XmlStreamHandler() { }
+    virtual ~XmlStreamHandler() { }
+
+    /// Called when the start tag of an element has been read.
+    /// @param category The category (tag name) of the element.
+    /// @param attributes The attributes of the element, in document order,
+    ///    with entity references resolved.
+    virtual void beginElement(const string& category, const XmlAttributeVec& attributes) = 0;
+
+    /// Called when the end of an element has been read.  Empty elements
+    /// issue an end event immediately after their begin event.
+    /// @param category The category (tag name) of the element.
+    virtual void endElement(const string& category) = 0;
 };
 
 /// @class XmlWriteOptions
@@ -128,6 +387,30 @@ void readFromXmlFile(DocumentPtr doc,
 /// @throws ExceptionParseError if the document cannot be parsed.
 void readFromXmlString(DocumentPtr doc, const string& str, const XmlReadOptions* readOptions = nullptr);
 
+/// @}
+/// @name Streaming Functions
+/// @{
+
+/// Read XML from the given input stream, issuing the element events of its
+/// content to the given handler.
+/// @param stream The input stream from which data is read.
+/// @param handler The handler to which element events are issued.
+/// @throws ExceptionParseError if the stream cannot be parsed.
+void streamFromXmlStream(std::istream& stream, XmlStreamHandler& handler);
+
+/// Read XML from the given filename, issuing the element events of its
+/// content to the given handler.  XInclude references are reported as
+/// elements, and are not followed.
+/// @param filename The filename from which data is read.
+/// @param handler The handler to which element events are issued.
+/// @param searchPath An optional sequence of file paths that will be applied
+///    in order when searching for the given file.
+/// @throws ExceptionParseError if the file cannot be parsed.
+/// @throws ExceptionFileMissing if the file cannot be opened.
+void streamFromXmlFile(const FilePath& filename,
+                       XmlStreamHandler& handler,
+                       const FileSearchPath& searchPath = FileSearchPath());
+
 /// @}
 /// @name Write Functions
 /// @{
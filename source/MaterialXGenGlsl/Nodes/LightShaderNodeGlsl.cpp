@@ -50,11 +50,11 @@ void LightShaderNodeGlsl::initialize(const InterfaceElement& element, GenContext
     NodeDefPtr nodeDef = impl.getNodeDef();
     for (InputPtr input : nodeDef->getActiveInputs())
     {
-        _lightUniforms.add(TypeDesc::get(input->getType()), input->getName(), input->getValue());
+        _lightUniforms.add(TypeDesc::get(input->getType()), input->getName(), input->getCachedValue());
     }
     for (ParameterPtr param : nodeDef->getActiveParameters())
     {
-        _lightUniforms.add(TypeDesc::get(param->getType()), param->getName(), param->getValue());
+        _lightUniforms.add(TypeDesc::get(param->getType()), param->getName(), param->getCachedValue());
     }
 }
 
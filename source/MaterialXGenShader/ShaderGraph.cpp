@@ -13,6 +13,8 @@
 
 #include <MaterialXCore/Document.h>
 
+#include <algorithm>
+
 namespace MaterialX
 {
 
@@ -49,7 +51,7 @@ void ShaderGraph::addInputSockets(const InterfaceElement& elem, GenContext& cont
                 ShaderGraphInputSocket* inputSocket = addInputSocket(port->getName(), TypeDesc::get(port->getType()));
                 if (!portValue.empty())
                 {
-                    inputSocket->setValue(port->getValue());
+                    inputSocket->setValue(port->getCachedValue());
                 }
             }
         }
@@ -165,7 +167,7 @@ void ShaderGraph::addUpstreamDependencies(const Element& root, ConstMaterialPtr
     ShaderNode* rootNode = getNode(root.getName());
     std::set<ElementPtr> processedOutputs;
 
-    for (Edge edge : root.traverseGraph(material))
+    for (Edge edge : root.traverseGraphUnique(material))
     {
         ElementPtr upstreamElement = edge.getUpstreamElement();
         if (!upstreamElement)
@@ -1270,7 +1272,7 @@ void ShaderGraph::optimize(GenContext& context)
             {
                 // Find which branch should be taken
                 ShaderInput* cutoff = node->getInput("cutoff");
-                ValuePtr value = intest->getConnection() ? intest->getConnection()->getNode()->getInput(0)->getValue() : intest->getValue();
+                ConstValuePtr value = intest->getConnection() ? intest->getConnection()->getNode()->getInput(0)->getValue() : intest->getValue();
                 const float intestValue = value ? value->asA<float>() : 0.0f;
                 const int branch = (intestValue <= cutoff->getValue()->asA<float>() ? 2 : 3);
 
@@ -1287,7 +1289,7 @@ void ShaderGraph::optimize(GenContext& context)
             if (!which->getConnection() || which->getConnection()->getNode()->hasClassification(ShaderNode::Classification::CONSTANT))
             {
                 // Find which branch should be taken
-                ValuePtr value = which->getConnection() ? which->getConnection()->getNode()->getInput(0)->getValue() : which->getValue();
+                ConstValuePtr value = which->getConnection() ? which->getConnection()->getNode()->getInput(0)->getValue() : which->getValue();
                 const int branch = int(value==nullptr ? 0 :
                     (which->getType() == Type::BOOLEAN ? value->asA<bool>() :
                     (which->getType() == Type::FLOAT ? value->asA<float>() : value->asA<int>())));
@@ -1429,9 +1431,18 @@ void ShaderGraph::topologicalSort()
 
         // Find connected nodes and decrease their in-degree,
         // adding node to the queue if in-degrees becomes 0.
+        // Connections are visited in order of name rather than
+        // address, so that the resulting order is deterministic.
         for (const auto& output : node->getOutputs())
         {
-            for (const auto& input : output->getConnections())
+            vector<ShaderInput*> connections(output->getConnections().begin(), output->getConnections().end());
+            std::sort(connections.begin(), connections.end(), [](const ShaderInput* lhs, const ShaderInput* rhs)
+            {
+                const string& lhsNodeName = lhs->getNode()->getName();
+                const string& rhsNodeName = rhs->getNode()->getName();
+                return lhsNodeName != rhsNodeName ? lhsNodeName < rhsNodeName : lhs->getName() < rhs->getName();
+            });
+            for (ShaderInput* input : connections)
             {
                 if (input->getNode() != this)
                 {
@@ -18,7 +18,7 @@ namespace MaterialX
 // ShaderPort methods
 //
 
-ShaderPort::ShaderPort(ShaderNode* node, const TypeDesc* type, const string& name, ValuePtr value) :
+ShaderPort::ShaderPort(ShaderNode* node, const TypeDesc* type, const string& name, ConstValuePtr value) :
     _node(node),
     _type(type),
     _name(name),
@@ -45,7 +45,7 @@ class ShaderPort : public std::enable_shared_from_this<ShaderPort>
     static const unsigned int EMITTED = 1 << 0;
     static const unsigned int BIND_INPUT = 1 << 1;
 
-    ShaderPort(ShaderNode* node, const TypeDesc* type, const string& name, ValuePtr value = nullptr);
+    ShaderPort(ShaderNode* node, const TypeDesc* type, const string& name, ConstValuePtr value = nullptr);
 
     /// Return a shared pointer instance of this object.
     ShaderPortPtr getSelf()
@@ -87,10 +87,10 @@ class ShaderPort : public std::enable_shared_from_this<ShaderPort>
     const string& getSemantic() const { return _semantic; }
 
     /// Set a value on this port.
-    void setValue(ValuePtr value) { _value = value; }
+    void setValue(ConstValuePtr value) { _value = value; }
 
     /// Return the value set on this port.
-    ValuePtr getValue() const { return _value; }
+    ConstValuePtr getValue() const { return _value; }
 
     /// Set a unit type for the value on this port.
     void setUnit(const string& unit) { _unit = unit; }
@@ -136,7 +136,7 @@ class ShaderPort : public std::enable_shared_from_this<ShaderPort>
     string _path;
     string _semantic;
     string _variable;
-    ValuePtr _value;
+    ConstValuePtr _value;
     string _unit;
     string _geomprop;
     unsigned int _flags;
@@ -64,7 +64,7 @@ ShaderPort* VariableBlock::find(const ShaderPortPredicate& predicate)
     return nullptr;
 }
 
-ShaderPort* VariableBlock::add(const TypeDesc* type, const string& name, ValuePtr value)
+ShaderPort* VariableBlock::add(const TypeDesc* type, const string& name, ConstValuePtr value)
 {
     auto it = _variableMap.find(name);
     if (it != _variableMap.end())
@@ -107,7 +107,7 @@ class VariableBlock
     ShaderPort* find(const ShaderPortPredicate& predicate);
 
     /// Add a new shader port to this block.
-    ShaderPort* add(const TypeDesc* type, const string& name, ValuePtr value = nullptr);
+    ShaderPort* add(const TypeDesc* type, const string& name, ConstValuePtr value = nullptr);
 
     /// Add an existing shader port to this block.
     void add(ShaderPortPtr port);
@@ -159,7 +159,7 @@ string Syntax::getSwizzledVariable(const string& srcName, const TypeDesc* srcTyp
     return dstSyntax.getValue(membersSwizzled, false);
 }
 
-ValuePtr Syntax::getSwizzledValue(ValuePtr value, const TypeDesc* srcType, const string& channels, const TypeDesc* dstType) const
+ValuePtr Syntax::getSwizzledValue(ConstValuePtr value, const TypeDesc* srcType, const string& channels, const TypeDesc* dstType) const
 {
     const TypeSyntax& srcSyntax = getTypeSyntax(srcType);
     const vector<string>& srcMembers = srcSyntax.getMembers();
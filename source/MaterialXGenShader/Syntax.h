@@ -95,7 +95,7 @@ class Syntax
     string getSwizzledVariable(const string& srcName, const TypeDesc* srcType, const string& channels, const TypeDesc* dstType) const;
 
     /// Get swizzled value
-    ValuePtr getSwizzledValue(ValuePtr value, const TypeDesc* srcType, const string& channels, const TypeDesc* dstType) const;
+    ValuePtr getSwizzledValue(ConstValuePtr value, const TypeDesc* srcType, const string& channels, const TypeDesc* dstType) const;
 
     /// Returns a set of names that are reserved words for this language syntax.
     const StringSet& getReservedWords() const { return _reservedWords; }
@@ -85,7 +85,7 @@ namespace
                     }
                     else if (opacity->getNodeName().empty() && opacity->getInterfaceName().empty())
                     {
-                        ValuePtr value = opacity->getValue();
+                        ConstValuePtr value = opacity->getCachedValue();
                         if (!value || (value->isA<float>() && isOne(value->asA<float>())))
                         {
                             opaque = true;
@@ -109,7 +109,7 @@ namespace
                     if (weight && weight->getNodeName() == EMPTY_STRING && weight->getInterfaceName() == EMPTY_STRING)
                     {
                         // Unconnected, check the value
-                        ValuePtr value = weight->getValue();
+                        ConstValuePtr value = weight->getCachedValue();
                         if (value && value->isA<float>() && isZero(value->asA<float>()))
                         {
                             opaque = true;
@@ -123,7 +123,7 @@ namespace
                         if (tint && tint->getNodeName() == EMPTY_STRING && tint->getInterfaceName() == EMPTY_STRING)
                         {
                             // Unconnected, check the value
-                            ValuePtr value = tint->getValue();
+                            ConstValuePtr value = tint->getCachedValue();
                             if (!value || (value->isA<Color3>() && isBlack(value->asA<Color3>())))
                             {
                                 opaque = true;
@@ -159,7 +159,7 @@ namespace
                         if (transmission->getNodeName().empty())
                         {
                             // Unconnected, check the value
-                            ValuePtr value = transmission->getValue();
+                            ConstValuePtr value = transmission->getCachedValue();
                             if (!value || (value->asA<float>() && isZero(value->asA<float>())))
                             {
                                 opaque = true;
@@ -187,7 +187,7 @@ namespace
                             if (opacity->getNodeName().empty())
                             {
                                 // Unconnected, check the value
-                                ValuePtr value = opacity->getValue();
+                                ConstValuePtr value = opacity->getCachedValue();
                                 if (!value || (value->isA<Color3>() && isWhite(value->asA<Color3>())))
                                 {
                                     opaque = true;
@@ -273,7 +273,7 @@ bool isTransparentSurface(ElementPtr element, const ShaderGenerator& shadergen)
             }
             else
             {
-                ValuePtr value = opacity->getValue();
+                ConstValuePtr value = opacity->getCachedValue();
                 if (value && value->isA<Color3>() && !isWhite(value->asA<Color3>()))
                 {
                     opaque = false;
@@ -291,7 +291,7 @@ bool isTransparentSurface(ElementPtr element, const ShaderGenerator& shadergen)
             }
             else
             {
-                ValuePtr value = transmission->getValue();
+                ConstValuePtr value = transmission->getCachedValue();
                 if (value && value->isA<float>() && !isZero(value->asA<float>()))
                 {
                     opaque = false;
@@ -309,7 +309,7 @@ bool isTransparentSurface(ElementPtr element, const ShaderGenerator& shadergen)
             }
             else
             {
-                ValuePtr value = subsurface->getValue();
+                ConstValuePtr value = subsurface->getCachedValue();
                 if (value && value->isA<float>() && !isZero(value->asA<float>()))
                 {
                     opaque = false;
@@ -346,7 +346,7 @@ bool isTransparentSurface(ElementPtr element, const ShaderGenerator& shadergen)
             }
             else
             {
-                ValuePtr value = opacity->getValue();
+                ConstValuePtr value = opacity->getCachedValue();
                 if (value && value->isA<Color3>() && !isWhite(value->asA<Color3>()))
                 {
                     opaque = false;
@@ -364,7 +364,7 @@ bool isTransparentSurface(ElementPtr element, const ShaderGenerator& shadergen)
             }
             else
             {
-                ValuePtr value = transmission->getValue();
+                ConstValuePtr value = transmission->getCachedValue();
                 if (value && value->isA<float>() && !isZero(value->asA<float>()))
                 {
                     opaque = false;
@@ -382,7 +382,7 @@ bool isTransparentSurface(ElementPtr element, const ShaderGenerator& shadergen)
             }
             else
             {
-                ValuePtr value = subsurface->getValue();
+                ConstValuePtr value = subsurface->getCachedValue();
                 if (value && value->isA<float>() && !isZero(value->asA<float>()))
                 {
                     opaque = false;
@@ -519,7 +519,7 @@ vector<MaterialAssignPtr> getGeometryBindings(NodePtr materialNode, const string
         {
             if (matAssign->getReferencedMaterialNode() == materialNode)
             {
-                if (geomStringsMatch(geom, matAssign->getActiveGeom()))
+                if (matAssign->matchesGeomString(geom))
                 {
                     matAssigns.push_back(matAssign);
                     continue;
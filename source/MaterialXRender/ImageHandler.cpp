@@ -221,7 +221,7 @@ void ImageSamplingProperties::setProperties(const string& fileNameUniform,
 
     const string uaddressmodeStr = root + UADDRESS_MODE_SUFFIX;
     const ShaderPort* port = uniformBlock.find(uaddressmodeStr);
-    ValuePtr intValue = port ? port->getValue() : nullptr;
+    ConstValuePtr intValue = port ? port->getValue() : nullptr;
     uaddressMode = ImageSamplingProperties::AddressMode(intValue && intValue->isA<int>() ? intValue->asA<int>() : INVALID_MAPPED_INT_VALUE);
 
     const string vaddressmodeStr = root + VADDRESS_MODE_SUFFIX;
@@ -236,7 +236,7 @@ void ImageSamplingProperties::setProperties(const string& fileNameUniform,
 
     const string defaultColorStr = root + DEFAULT_COLOR_SUFFIX;
     port = uniformBlock.find(defaultColorStr);
-    ValuePtr colorValue = port ? port->getValue() : nullptr;
+    ConstValuePtr colorValue = port ? port->getValue() : nullptr;
     if (colorValue)
     {
         mapValueToColor(colorValue, defaultColor);
@@ -5,6 +5,7 @@
 
 #include <MaterialXRender/Mesh.h>
 
+#include <limits>
 #include <map>
 
 namespace MaterialX
@@ -238,17 +239,24 @@ void MeshStream::transform(const Matrix44 &matrix)
         getType() == MeshStream::TEXCOORD_ATTRIBUTE ||
         getType() == MeshStream::GEOMETRY_PROPERTY_ATTRIBUTE)
     {
-        for (size_t i=0; i<numElements; i++)
+        if (stride == 3)
         {
-            Vector4 vec(0.0, 0.0, 0.0, 1.0);
-            for (size_t j=0; j<stride; j++)
-            {
-                vec[j] = _data[i*stride + j];
-            }
-            vec = matrix.multiply(vec);
-            for (size_t k=0; k<stride; k++)
+            matrix.transformPoints(_data.data(), _data.data(), numElements);
+        }
+        else
+        {
+            for (size_t i=0; i<numElements; i++)
             {
-                _data[i*stride + k] = vec[k];
+                Vector4 vec(0.0, 0.0, 0.0, 1.0);
+                for (size_t j=0; j<stride; j++)
+                {
+                    vec[j] = _data[i*stride + j];
+                }
+                vec = matrix.multiply(vec);
+                for (size_t k=0; k<stride; k++)
+                {
+                    _data[i*stride + k] = vec[k];
+                }
             }
         }
     }
@@ -256,17 +264,25 @@ void MeshStream::transform(const Matrix44 &matrix)
              getType() == MeshStream::TANGENT_ATTRIBUTE ||
              getType() == MeshStream::BITANGENT_ATTRIBUTE)
     {
-        for (size_t i=0; i<numElements; i++)
+        if (stride == 3)
         {
-            Vector3 vec(0.0, 0.0, 0.0);
-            for (size_t j=0; j<stride; j++)
-            {
-                vec[j] = _data[i*stride + j];
-            }
-            vec = matrix.transformNormal(vec);
-            for (size_t k=0; k<stride; k++)
+            matrix.transformNormals(_data.data(), _data.data(), numElements);
+        }
+        else
+        {
+            Matrix44 normalMatrix = matrix.getInverse().getTranspose();
+            for (size_t i=0; i<numElements; i++)
             {
-                _data[i*stride + k] = vec[k];
+                Vector3 vec(0.0, 0.0, 0.0);
+                for (size_t j=0; j<stride; j++)
+                {
+                    vec[j] = _data[i*stride + j];
+                }
+                vec = normalMatrix.transformVector(vec);
+                for (size_t k=0; k<stride; k++)
+                {
+                    _data[i*stride + k] = vec[k];
+                }
             }
         }
     }
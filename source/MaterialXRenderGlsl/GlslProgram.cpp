@@ -569,7 +569,7 @@ ImagePtr GlslProgram::bindTexture(unsigned int uniformType, int uniformLocation,
     return nullptr;
 }
 
-MaterialX::ValuePtr GlslProgram::findUniformValue(const string& uniformName, const GlslProgram::InputMap& uniformList)
+MaterialX::ConstValuePtr GlslProgram::findUniformValue(const string& uniformName, const GlslProgram::InputMap& uniformList)
 {
     auto uniform = uniformList.find(uniformName);
     if (uniform != uniformList.end())
@@ -774,7 +774,7 @@ void GlslProgram::bindLighting(LightHandlerPtr lightHandler, ImageHandlerPtr ima
                 input = uniformList.find(prefix + "." + lightInput->getName());
                 if (input != uniformList.end())
                 {
-                    bindUniform(input->second->location, *lightInput->getValue());
+                    bindUniform(input->second->location, *lightInput->getCachedValue());
                 }
             }
         }
@@ -788,7 +788,7 @@ void GlslProgram::bindLighting(LightHandlerPtr lightHandler, ImageHandlerPtr ima
                 input = uniformList.find(prefix + "." + param->getName());
                 if (input != uniformList.end())
                 {
-                    bindUniform(input->second->location, *param->getValue());
+                    bindUniform(input->second->location, *param->getCachedValue());
                 }
             }
         }
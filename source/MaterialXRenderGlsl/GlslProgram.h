@@ -89,7 +89,7 @@ class GlslProgram
         std::string typeString;
         /// Input value. Will only be non-empty if initialized stages with a HwShader and a value was set during
         /// shader generation.
-        MaterialX::ValuePtr value;
+        MaterialX::ConstValuePtr value;
         /// Is this a constant
         bool isConstant;
         /// Element path (if any)
@@ -224,7 +224,7 @@ class GlslProgram
 
     /// Utility to find a uniform value in an uniform list.
     /// If uniform cannot be found a null pointer will be return.
-    MaterialX::ValuePtr findUniformValue(const std::string& uniformName, const InputMap& uniformList);
+    MaterialX::ConstValuePtr findUniformValue(const std::string& uniformName, const InputMap& uniformList);
 
     /// @}
     /// @name Utilities
@@ -0,0 +1,135 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#ifndef BENCHMARK_UTIL_H
+#define BENCHMARK_UTIL_H
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#if defined(__linux__)
+#include <malloc.h>
+#include <unistd.h>
+#endif
+
+namespace BenchmarkUtil
+{
+
+//
+// A simple wall-clock timer for benchmark test cases.
+//
+class Timer
+{
+  public:
+    Timer()
+    {
+        reset();
+    }
+
+    // Restart the timer.
+    void reset()
+    {
+        _startTime = std::chrono::steady_clock::now();
+    }
+
+    // Return the elapsed time in seconds since the timer was last reset.
+    double elapsed() const
+    {
+        std::chrono::duration<double> duration = std::chrono::steady_clock::now() - _startTime;
+        return duration.count();
+    }
+
+  protected:
+    std::chrono::steady_clock::time_point _startTime;
+};
+
+//
+// Report the result of a benchmark to the standard output, optionally
+// including a per-iteration average.
+//
+inline void report(const std::string& label, double seconds, size_t iterations = 0)
+{
+    std::cout << "Benchmark: " << label << ": " << seconds << " s";
+    if (iterations > 1)
+    {
+        std::cout << " (" << (seconds / iterations) * 1.0e6 << " us per iteration)";
+    }
+    std::cout << std::endl;
+}
+
+//
+// Return the resident memory of the current process in bytes, or zero if
+// this query is not supported on the current platform.
+//
+inline size_t getResidentMemory()
+{
+#if defined(__linux__)
+    std::ifstream statm("/proc/self/statm");
+    size_t totalPages = 0;
+    size_t residentPages = 0;
+    if (statm >> totalPages >> residentPages)
+    {
+        return residentPages * (size_t) sysconf(_SC_PAGESIZE);
+    }
+#endif
+    return 0;
+}
+
+//
+// Return the peak resident memory of the current process in bytes, or zero
+// if this query is not supported on the current platform.
+//
+inline size_t getPeakResidentMemory()
+{
+#if defined(__linux__)
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line))
+    {
+        if (line.compare(0, 6, "VmHWM:") == 0)
+        {
+            return (size_t) std::stoull(line.substr(6)) * 1024;
+        }
+    }
+#endif
+    return 0;
+}
+
+//
+// Reset the peak resident memory of the current process to its current
+// resident memory, where supported by the platform.  Free memory held by
+// the allocator is first returned to the system, so that measurements are
+// not skewed by earlier allocations.
+//
+inline void resetPeakResidentMemory()
+{
+#if defined(__linux__)
+#if defined(__GLIBC__)
+    malloc_trim(0);
+#endif
+    std::ofstream clearRefs("/proc/self/clear_refs");
+    clearRefs << "5";
+#endif
+}
+
+//
+// Report a memory measurement to the standard output, optionally including
+// a per-item average.
+//
+inline void reportMemory(const std::string& label, size_t bytes, size_t items = 0)
+{
+    std::cout << "Benchmark: " << label << ": " << bytes << " bytes";
+    if (items > 1)
+    {
+        std::cout << " (" << (double) bytes / items << " bytes per item)";
+    }
+    std::cout << std::endl;
+}
+
+} // namespace BenchmarkUtil
+
+#endif
@@ -4,12 +4,15 @@
 //
 
 #include <MaterialXTest/Catch/catch.hpp>
+#include <MaterialXTest/BenchmarkUtil.h>
 
 #include <MaterialXCore/Document.h>
 #include <MaterialXFormat/File.h>
 #include <MaterialXFormat/Util.h>
 #include <MaterialXFormat/XmlIo.h>
 
+#include <thread>
+
 namespace mx = MaterialX;
 
 TEST_CASE("Document", "[document]")
@@ -158,3 +161,543 @@ TEST_CASE("Version", "[document]")
         REQUIRE((convertItem.second == 0));
     }
 }
+
+TEST_CASE("Legacy version upgrade", "[document]")
+{
+    mx::FileSearchPath searchPath("resources/Materials/TestSuite/stdlib/upgrade/");
+    mx::DocumentPtr legacyDoc = mx::createDocument();
+    mx::readFromXmlFile(legacyDoc, "1_22_to_1_37.mtlx", searchPath);
+    REQUIRE(legacyDoc->getVersionString() == mx::createDocument()->getVersionString());
+    REQUIRE(legacyDoc->validate());
+
+    // Shaders and opgraphs are converted to nodedefs and nodegraphs.
+    mx::NodeDefPtr nodeDef = legacyDoc->getNodeDef("ND_legacy_surface");
+    REQUIRE(nodeDef);
+    REQUIRE(nodeDef->getNodeString() == "legacy_surface");
+    REQUIRE(nodeDef->getOutput("out"));
+    REQUIRE(nodeDef->getParameter("placement")->getType() == "matrix44");
+    REQUIRE(nodeDef->getParameter("roughness")->getValueString() == "0.2");
+    REQUIRE(nodeDef->getParameter("texture")->getValueString() == "tex.<UDIM>.png");
+    REQUIRE(legacyDoc->getNodeDef("ND_legacy_program")->getNodeString() == "legacy_program");
+    mx::NodeGraphPtr coatGraph = legacyDoc->getNodeGraph("coat_graph");
+    REQUIRE(coatGraph);
+    REQUIRE(coatGraph->getNode("constant1")->getParameter("value"));
+    REQUIRE(coatGraph->getNode("add1")->getInput("in1")->getNodeName() == "constant1");
+    REQUIRE(coatGraph->getOutput("out")->getNodeName() == "add1");
+
+    // Node categories are converted.
+    mx::NodeGraphPtr nodeGraph = legacyDoc->getNodeGraph("node_graph");
+    REQUIRE(nodeGraph->getNode("rotate1")->getCategory() == "rotate3d");
+    REQUIRE(nodeGraph->getNode("compare1")->getCategory() == "ifgreatereq");
+    REQUIRE(nodeGraph->getNode("compare1")->getInput("value2")->getValueString() == "0.6");
+    REQUIRE(nodeGraph->getNode("geomattrvalue1")->getAttribute("geomprop") == "mask");
+    REQUIRE(nodeGraph->getNode("invert1")->getCategory() == "invertmatrix");
+    REQUIRE(nodeGraph->getNode("separate1")->getCategory() == "separate3");
+
+    // Overrides and inheritance are converted to bindings and inherit strings.
+    mx::MaterialPtr material = legacyDoc->getMaterial("legacy_material");
+    REQUIRE(material->getInheritString() == "base_material");
+    mx::ShaderRefPtr shaderRef = material->getShaderRefs()[0];
+    REQUIRE(shaderRef->getNodeDef() == nodeDef);
+    REQUIRE(shaderRef->getBindParam("roughness")->getValueString() == "0.5");
+    REQUIRE(shaderRef->getBindParam("texture")->getValueString() == "override.<UVTILE>.png");
+    REQUIRE(shaderRef->getBindInput("coat_color")->getNodeGraphString() == "coat_graph");
+    REQUIRE(legacyDoc->getLook("legacy_look")->getInheritString() == "base_look");
+    REQUIRE(legacyDoc->getLook("legacy_look")->getMaterialAssigns()[0]->getMaterial() == "legacy_material");
+    REQUIRE(legacyDoc->getGeomPropValue("udimset")->getValueString() == "1001, 1002");
+
+    // The lookup cache reflects the upgraded content.
+    REQUIRE(legacyDoc->getMatchingNodeDefs("legacy_surface").size() == 1);
+    REQUIRE(legacyDoc->getMatchingPorts("add1").size() == 1);
+}
+
+TEST_CASE("Version upgrade benchmark", "[document][benchmark]")
+{
+    const size_t ITERATIONS = 20;
+
+    // Gather legacy documents, along with copies that are labeled with the
+    // current version, so that they can be parsed without an upgrade.
+    const std::string currentVersion = mx::createDocument()->getVersionString();
+    std::vector<std::pair<std::string, std::string>> legacyStrings;
+    mx::FileSearchPath searchPath("resources/Materials/TestSuite/stdlib/upgrade/");
+    for (const char* filename : { "1_22_to_1_37.mtlx", "1_36_to_1_37.mtlx" })
+    {
+        std::string legacyString = mx::readFile(searchPath.find(filename));
+        const std::string versionPrefix = "<materialx version=\"";
+        size_t versionStart = legacyString.find(versionPrefix) + versionPrefix.size();
+        size_t versionEnd = legacyString.find('"', versionStart);
+        std::string version = legacyString.substr(versionStart, versionEnd - versionStart);
+        REQUIRE(version != currentVersion);
+        legacyString.replace(versionStart, versionEnd - versionStart, currentVersion);
+        legacyStrings.emplace_back(version, legacyString);
+    }
+
+    // Legacy documents are upgraded alongside an imported standard library,
+    // whose lookup cache has been populated.
+    mx::DocumentPtr stdlib = mx::createDocument();
+    mx::loadLibrary(mx::FilePath("libraries/stdlib/stdlib_defs.mtlx"), stdlib);
+    mx::loadLibrary(mx::FilePath("libraries/stdlib/stdlib_ng.mtlx"), stdlib);
+
+    double parseTime = 0.0;
+    double upgradeTime = 0.0;
+    for (size_t i = 0; i < ITERATIONS; i++)
+    {
+        for (const auto& pair : legacyStrings)
+        {
+            mx::DocumentPtr doc = mx::createDocument();
+            doc->importLibrary(stdlib);
+            doc->getMatchingNodeDefs("add");
+
+            BenchmarkUtil::Timer parseTimer;
+            mx::readFromXmlString(doc, pair.second);
+            parseTime += parseTimer.elapsed();
+
+            doc->setVersionString(pair.first);
+            BenchmarkUtil::Timer upgradeTimer;
+            doc->upgradeVersion();
+            upgradeTime += upgradeTimer.elapsed();
+            REQUIRE(doc->getVersionString() == currentVersion);
+        }
+    }
+    BenchmarkUtil::report("Legacy document parse", parseTime, ITERATIONS);
+    BenchmarkUtil::report("Legacy document upgrade", upgradeTime, ITERATIONS);
+}
+
+TEST_CASE("Document cache", "[document]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::NodeDefPtr nodeDef = doc->addNodeDef("ND_simple", "color3", "simple");
+    mx::NodeGraphPtr nodeGraph = doc->addNodeGraph();
+    mx::NodePtr node1 = nodeGraph->addNode("simple", "node1", "color3");
+    mx::NodePtr node2 = nodeGraph->addNode("simple", "node2", "color3");
+    mx::OutputPtr output = nodeGraph->addOutput("out", "color3");
+
+    // Populate the cache, then apply edits that update it incrementally.
+    REQUIRE(node1->getNodeDef() == nodeDef);
+    REQUIRE(doc->getMatchingPorts("node1").empty());
+    node2->setConnectedNode("in", node1);
+    output->setConnectedNode(node2);
+    REQUIRE(doc->getMatchingPorts("node1").size() == 1);
+    REQUIRE(doc->getMatchingPorts("node2").size() == 1);
+
+    // Re-key an existing port connection.
+    output->setConnectedNode(node1);
+    REQUIRE(doc->getMatchingPorts("node1").size() == 2);
+    REQUIRE(doc->getMatchingPorts("node2").empty());
+
+    // Re-key and remove nodedefs.
+    nodeDef->setNodeString("complex");
+    REQUIRE(!node1->getNodeDef());
+    REQUIRE(doc->getMatchingNodeDefs("complex").size() == 1);
+    nodeDef->setNodeString("simple");
+    REQUIRE(node1->getNodeDef() == nodeDef);
+    doc->removeNodeDef(nodeDef->getName());
+    REQUIRE(doc->getMatchingNodeDefs("simple").empty());
+
+    // Add and remove implementations.
+    mx::ImplementationPtr impl = doc->addImplementation("IM_simple");
+    impl->setNodeDefString("ND_simple");
+    REQUIRE(doc->getMatchingImplementations("ND_simple").size() == 1);
+    impl->removeAttribute(mx::InterfaceElement::NODE_DEF_ATTRIBUTE);
+    REQUIRE(doc->getMatchingImplementations("ND_simple").empty());
+
+    // Apply a namespace to a subtree.
+    nodeGraph->setNamespace("custom");
+    REQUIRE(doc->getMatchingPorts("node1").empty());
+    REQUIRE(doc->getMatchingPorts("custom:node1").size() == 2);
+    nodeGraph->removeAttribute(mx::Element::NAMESPACE_ATTRIBUTE);
+    REQUIRE(doc->getMatchingPorts("node1").size() == 2);
+
+    // Remove elements from the document.
+    nodeGraph->removeNode(node2->getName());
+    REQUIRE(doc->getMatchingPorts("node1").size() == 1);
+    doc->removeNodeGraph(nodeGraph->getName());
+    REQUIRE(doc->getMatchingPorts("node1").empty());
+
+    // Copied content must be indexed as well.
+    mx::DocumentPtr stdlib = mx::createDocument();
+    mx::loadLibrary(mx::FilePath::getCurrentPath() / mx::FilePath("libraries/stdlib/stdlib_defs.mtlx"), stdlib);
+    REQUIRE(!stdlib->getMatchingNodeDefs("add").empty());
+    doc->importLibrary(stdlib);
+    REQUIRE(doc->getMatchingNodeDefs("add").size() == stdlib->getMatchingNodeDefs("add").size());
+    mx::DocumentPtr copy = doc->copy();
+    REQUIRE(copy->getMatchingNodeDefs("add").size() == stdlib->getMatchingNodeDefs("add").size());
+    doc->initialize();
+    REQUIRE(doc->getMatchingNodeDefs("add").empty());
+}
+
+TEST_CASE("Document cache benchmark", "[document][benchmark]")
+{
+    const size_t NODE_COUNT = 20000;
+    const size_t INPUT_COUNT = 4;
+    const size_t EDIT_COUNT = 1000;
+
+    // Build a document with roughly 100k elements.
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::NodeDefPtr nodeDef = doc->addNodeDef("ND_simple", "float", "simple");
+    for (size_t j = 0; j < INPUT_COUNT; j++)
+    {
+        nodeDef->addInput("in" + std::to_string(j), "float");
+    }
+    mx::NodeGraphPtr nodeGraph = doc->addNodeGraph();
+    std::vector<mx::NodePtr> nodes;
+    for (size_t i = 0; i < NODE_COUNT; i++)
+    {
+        mx::NodePtr node = nodeGraph->addNode("simple", "node" + std::to_string(i), "float");
+        for (size_t j = 0; j < INPUT_COUNT; j++)
+        {
+            node->addInput("in" + std::to_string(j), "float");
+        }
+        nodes.push_back(node);
+    }
+    REQUIRE(nodes[0]->getNodeDef() == nodeDef);
+
+    // Alternate single edits with cache lookups.
+    BenchmarkUtil::Timer timer;
+    for (size_t i = 1; i < EDIT_COUNT; i++)
+    {
+        nodes[i]->setConnectedNode("in0", nodes[i - 1]);
+        REQUIRE(doc->getMatchingPorts(nodes[i - 1]->getName()).size() == 1);
+        REQUIRE(nodes[i]->getNodeDef() == nodeDef);
+    }
+    size_t elementCount = NODE_COUNT * (INPUT_COUNT + 1);
+    BenchmarkUtil::report("Document cache edit and lookup, " + std::to_string(elementCount) + " elements",
+                          timer.elapsed(), EDIT_COUNT);
+}
+
+TEST_CASE("Document cache threading", "[document][benchmark]")
+{
+    const size_t RESOLVE_COUNT = 10000;
+
+    // Create a node for every nodedef in the standard library.
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::loadLibrary(mx::FilePath::getCurrentPath() / mx::FilePath("libraries/stdlib/stdlib_defs.mtlx"), doc);
+    mx::NodeGraphPtr nodeGraph = doc->addNodeGraph();
+    for (mx::NodeDefPtr nodeDef : doc->getNodeDefs())
+    {
+        nodeGraph->addNode(nodeDef->getNodeString(), mx::EMPTY_STRING, nodeDef->getType());
+    }
+    std::vector<mx::NodePtr> nodes = nodeGraph->getNodes();
+    REQUIRE(!nodes.empty());
+
+    // Compute reference results on a single thread.
+    std::vector<mx::NodeDefPtr> expected;
+    for (mx::NodePtr node : nodes)
+    {
+        expected.push_back(node->getNodeDef());
+    }
+
+    // Resolve nodedefs from multiple threads against a cold cache, splitting
+    // a fixed amount of work across the threads.
+    for (size_t threadCount : { 1, 2, 4, 8 })
+    {
+        nodeGraph->setNamespace("ns");
+        nodeGraph->removeAttribute(mx::Element::NAMESPACE_ATTRIBUTE);
+
+        std::vector<size_t> mismatches(threadCount, 0);
+        std::vector<std::thread> threads;
+        BenchmarkUtil::Timer timer;
+        for (size_t t = 0; t < threadCount; t++)
+        {
+            threads.emplace_back([&, t]()
+            {
+                for (size_t i = t; i < RESOLVE_COUNT; i += threadCount)
+                {
+                    size_t index = i % nodes.size();
+                    if (nodes[index]->getNodeDef() != expected[index])
+                    {
+                        mismatches[t]++;
+                    }
+                }
+            });
+        }
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+        BenchmarkUtil::report("Nodedef resolution, " + std::to_string(threadCount) + " threads",
+                              timer.elapsed(), RESOLVE_COUNT);
+
+        for (size_t count : mismatches)
+        {
+            REQUIRE(count == 0);
+        }
+    }
+}
+
+TEST_CASE("Frozen document", "[document]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::NodeDefPtr nodeDef = doc->addNodeDef("ND_simple", "color3", "simple");
+    mx::NodeGraphPtr nodeGraph = doc->addNodeGraph();
+    mx::NodePtr node = nodeGraph->addNode("simple", "node1", "color3");
+    mx::OutputPtr output = nodeGraph->addOutput("out", "color3");
+    output->setConnectedNode(node);
+
+    // Freeze the document, and verify that queries are still supported.
+    REQUIRE(!doc->isFrozen());
+    doc->freeze();
+    REQUIRE(doc->isFrozen());
+    REQUIRE(node->getNodeDef() == nodeDef);
+    REQUIRE(doc->getMatchingPorts("node1").size() == 1);
+    REQUIRE(doc->validate());
+
+    // Verify that edits to a frozen document are rejected.
+    REQUIRE_THROWS_AS(nodeGraph->addNode("simple"), mx::ExceptionFrozenDocument&);
+    REQUIRE_THROWS_AS(node->setNodeDefString("ND_simple"), mx::ExceptionFrozenDocument&);
+    REQUIRE_THROWS_AS(output->removeAttribute(mx::PortElement::NODE_NAME_ATTRIBUTE), mx::ExceptionFrozenDocument&);
+    REQUIRE_THROWS_AS(doc->removeNodeGraph(nodeGraph->getName()), mx::ExceptionFrozenDocument&);
+    REQUIRE_THROWS_AS(doc->initialize(), mx::ExceptionFrozenDocument&);
+    REQUIRE_THROWS_AS(doc->setChildIndex(nodeGraph->getName(), 0), mx::ExceptionFrozenDocument&);
+    REQUIRE_THROWS_AS(doc->setChildOrder(doc->getChildren()), mx::ExceptionFrozenDocument&);
+    REQUIRE_THROWS_AS(node->setSourceUri("frozen.mtlx"), mx::ExceptionFrozenDocument&);
+    REQUIRE(doc->getChildIndex(nodeGraph->getName()) == 1);
+    REQUIRE(!node->hasSourceUri());
+    REQUIRE(doc->getMatchingPorts("node1").size() == 1);
+
+    // A copy of a frozen document may be edited.
+    mx::DocumentPtr copy = doc->copy();
+    REQUIRE(!copy->isFrozen());
+    copy->getNodeGraph(nodeGraph->getName())->addNode("simple", "node2", "color3");
+    REQUIRE(copy->getNodeGraph(nodeGraph->getName())->getNodes().size() == 2);
+}
+
+TEST_CASE("Document arena", "[document]")
+{
+    mx::DocumentPtr doc = mx::createDocument(true);
+    REQUIRE(doc->getArena());
+    REQUIRE(!mx::createDocument()->getArena());
+
+    mx::NodeGraphPtr nodeGraph = doc->addNodeGraph();
+    mx::NodePtr constant = nodeGraph->addNode("constant", "node1", "color3");
+    constant->setParameterValue("value", mx::Color3(0.1f, 0.2f, 0.3f));
+    mx::OutputPtr output = nodeGraph->addOutput("out", "color3");
+    output->setConnectedNode(constant);
+    REQUIRE(doc->getArena()->getAllocatedBytes() > 0);
+    REQUIRE(doc->getArena()->getReservedBytes() >= doc->getArena()->getAllocatedBytes());
+
+    // Copies of an arena document are allocated from an arena of their own.
+    mx::DocumentPtr copy = doc->copy();
+    REQUIRE(*copy == *doc);
+    REQUIRE(copy->getArena());
+    REQUIRE(copy->getArena() != doc->getArena());
+
+    // Elements remain valid after their document has been released.
+    mx::ElementPtr elem = copy->getDescendant(constant->getNamePath());
+    REQUIRE(elem);
+    copy = nullptr;
+    REQUIRE(elem->getName() == constant->getName());
+    REQUIRE(elem->getChildren().size() == 1);
+}
+
+TEST_CASE("Validation diagnostics", "[document]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::NodeGraphPtr nodeGraph = doc->addNodeGraph("graph1");
+    mx::NodePtr node = nodeGraph->addNode("constant", "node1", "color3");
+    mx::OutputPtr output = nodeGraph->addOutput("out", "color3");
+    output->setConnectedNode(node);
+    for (int i = 0; i < 8; i++)
+    {
+        mx::NodeGraphPtr brokenGraph = doc->addNodeGraph();
+        mx::OutputPtr brokenOutput = brokenGraph->addOutput("out", "color3");
+        brokenOutput->setNodeName("missing");
+    }
+    doc->removeAttribute(mx::Document::VERSION_ATTRIBUTE);
+
+    // Structured diagnostics match the message string of the serial path.
+    std::string message;
+    REQUIRE(!doc->validate(&message));
+    for (unsigned int threadCount : { 1, 4 })
+    {
+        mx::ValidationOptions options;
+        options.threadCount = threadCount;
+        mx::ValidationDiagnosticVec diagnostics;
+        REQUIRE(!doc->validate(diagnostics, options));
+        REQUIRE(diagnostics.size() == 9);
+        REQUIRE(diagnostics[0].rule == "Missing version string");
+        REQUIRE(diagnostics[0].elementPath.empty());
+        std::string joined;
+        for (const mx::ValidationDiagnostic& diagnostic : diagnostics)
+        {
+            joined += diagnostic.message + "\n";
+        }
+        REQUIRE(joined == message);
+        REQUIRE(diagnostics[1].rule == "Invalid port connection");
+        REQUIRE(doc->getDescendant(diagnostics[1].elementPath)->isA<mx::Output>());
+    }
+
+    // Validation may stop early after a given number of errors.
+    mx::ValidationOptions options;
+    options.threadCount = 4;
+    options.maxErrors = 3;
+    mx::ValidationDiagnosticVec diagnostics;
+    REQUIRE(!doc->validate(diagnostics, options));
+    REQUIRE(diagnostics.size() == 3);
+
+    // A valid document produces no diagnostics.
+    doc->setVersionString(mx::getVersionString());
+    for (mx::NodeGraphPtr graph : doc->getNodeGraphs())
+    {
+        if (graph != nodeGraph)
+        {
+            doc->removeNodeGraph(graph->getName());
+        }
+    }
+    REQUIRE(doc->validate(diagnostics, mx::ValidationOptions()));
+    REQUIRE(diagnostics.empty());
+}
+
+TEST_CASE("Validation benchmark", "[document][benchmark]")
+{
+    // Combine the test suite materials and the standard libraries into a
+    // single document.
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::FilePath libraryPath("libraries");
+    mx::loadLibraries({ "stdlib", "pbrlib", "bxdf" }, mx::FileSearchPath(libraryPath), doc);
+    mx::XmlReadOptions readOptions;
+    readOptions.skipConflictingElements = true;
+    mx::CopyOptions copyOptions;
+    copyOptions.skipConflictingElements = true;
+    mx::FilePath rootPath("resources/Materials/TestSuite");
+    for (const mx::FilePath& dir : rootPath.getSubDirectories())
+    {
+        for (const mx::FilePath& filename : dir.getFilesInDirectory(mx::MTLX_EXTENSION))
+        {
+            mx::DocumentPtr suiteDoc = mx::createDocument();
+            try
+            {
+                mx::readFromXmlFile(suiteDoc, dir / filename, mx::FileSearchPath(dir), &readOptions);
+            }
+            catch (mx::Exception&)
+            {
+                continue;
+            }
+            doc->importLibrary(suiteDoc, &copyOptions);
+        }
+    }
+    REQUIRE(doc->getChildren().size() > 0);
+
+    std::string message;
+    bool serialResult = doc->validate(&message);
+    for (unsigned int threadCount : { 1, 2, 4, 8 })
+    {
+        mx::ValidationOptions options;
+        options.threadCount = threadCount;
+        mx::ValidationDiagnosticVec diagnostics;
+        BenchmarkUtil::Timer timer;
+        bool result = doc->validate(diagnostics, options);
+        BenchmarkUtil::report("Validation with " + std::to_string(threadCount) + " threads", timer.elapsed(), 1);
+        REQUIRE(result == serialResult);
+    }
+}
+
+TEST_CASE("Library references", "[document]")
+{
+    mx::DocumentPtr library = mx::createDocument();
+    mx::loadLibraries({ "stdlib" }, mx::FileSearchPath(mx::FilePath("libraries")), library);
+    REQUIRE_THROWS_AS(mx::createDocument()->referenceLibrary(library), mx::Exception&);
+    library->freeze();
+
+    // Referenced definitions are visible to the queries of the document.
+    mx::DocumentPtr doc = mx::createDocument();
+    doc->referenceLibrary(library);
+    REQUIRE(doc->getChildren().empty());
+    REQUIRE(doc->getReferencedLibraries().size() == 1);
+    REQUIRE(doc->getNodeDefs().size() == library->getNodeDefs().size());
+    REQUIRE(doc->getImplementations().size() == library->getImplementations().size());
+    REQUIRE(doc->getTypeDefs().size() == library->getTypeDefs().size());
+    mx::NodeDefPtr nodeDef = doc->getNodeDef("ND_image_color3");
+    REQUIRE(nodeDef);
+    REQUIRE(nodeDef->getDocument() == library);
+    REQUIRE(doc->getMatchingNodeDefs("image").size() == library->getMatchingNodeDefs("image").size());
+    REQUIRE(doc->getMatchingImplementations("ND_image_color3").size() ==
+            library->getMatchingImplementations("ND_image_color3").size());
+
+    // Nodes of the document resolve against the referenced definitions.
+    mx::NodeGraphPtr nodeGraph = doc->addNodeGraph();
+    mx::NodePtr image = nodeGraph->addNode("image", "image1", "color3");
+    mx::OutputPtr output = nodeGraph->addOutput("out", "color3");
+    output->setConnectedNode(image);
+    REQUIRE(image->getNodeDef() == nodeDef);
+    image->setNodeDefString("ND_image_color3");
+    REQUIRE(image->getNodeDef() == nodeDef);
+    REQUIRE(output->getTypeDef() == library->getTypeDef("color3"));
+    REQUIRE(doc->validate());
+
+    // Referenced elements are immutable until copied into the document.
+    REQUIRE_THROWS_AS(nodeDef->setVersionString("2.0"), mx::ExceptionFrozenDocument&);
+    mx::ElementPtr localCopy = doc->copyReferencedElement("ND_image_color3");
+    REQUIRE(localCopy);
+    REQUIRE(localCopy->getDocument() == doc);
+    REQUIRE(doc->copyReferencedElement("ND_image_color3") == localCopy);
+    REQUIRE(!doc->copyReferencedElement("ND_missing"));
+    localCopy->setAttribute("doc", "Local copy");
+    REQUIRE(doc->getNodeDef("ND_image_color3") == localCopy);
+    REQUIRE(image->getNodeDef() == localCopy);
+    REQUIRE(doc->getNodeDefs().size() == library->getNodeDefs().size());
+    REQUIRE(doc->getMatchingNodeDefs("image").size() == library->getMatchingNodeDefs("image").size());
+    REQUIRE(nodeDef->getAttribute("doc") != "Local copy");
+
+    // Library references are preserved by document copies.
+    mx::DocumentPtr copy = doc->copy();
+    REQUIRE(copy->getReferencedLibraries() == doc->getReferencedLibraries());
+    REQUIRE(copy->getNodeDef("ND_image_color3")->getDocument() == copy);
+    REQUIRE(copy->getNodeDef("ND_image_color4")->getDocument() == library);
+
+    // Clearing references removes the shared definitions.
+    doc->clearReferencedLibraries();
+    REQUIRE(doc->getNodeDefs().size() == 1);
+    REQUIRE(!doc->getNodeDef("ND_image_color4"));
+    REQUIRE(output->getTypeDef() == nullptr);
+}
+
+TEST_CASE("Library reference benchmark", "[document][benchmark]")
+{
+    const size_t REFERENCE_COUNT = 1000;
+    const size_t IMPORT_COUNT = 100;
+
+    mx::DocumentPtr library = mx::createDocument();
+    mx::loadLibraries({ "stdlib" }, mx::FileSearchPath(mx::FilePath("libraries")), library);
+    library->freeze();
+
+    // Import the library into each document by deep copy.
+    {
+        std::vector<mx::DocumentPtr> docs;
+        size_t startMemory = BenchmarkUtil::getResidentMemory();
+        BenchmarkUtil::Timer timer;
+        for (size_t i = 0; i < IMPORT_COUNT; i++)
+        {
+            mx::DocumentPtr doc = mx::createDocument();
+            doc->importLibrary(library);
+            docs.push_back(doc);
+        }
+        BenchmarkUtil::report("Library import", timer.elapsed(), IMPORT_COUNT);
+        size_t endMemory = BenchmarkUtil::getResidentMemory();
+        if (endMemory > startMemory)
+        {
+            BenchmarkUtil::reportMemory("Library import memory", endMemory - startMemory, IMPORT_COUNT);
+        }
+        REQUIRE(docs.back()->getNodeDef("ND_image_color3"));
+    }
+
+    // Reference the library from each document.
+    {
+        std::vector<mx::DocumentPtr> docs;
+        size_t startMemory = BenchmarkUtil::getResidentMemory();
+        BenchmarkUtil::Timer timer;
+        for (size_t i = 0; i < REFERENCE_COUNT; i++)
+        {
+            mx::DocumentPtr doc = mx::createDocument();
+            doc->referenceLibrary(library);
+            docs.push_back(doc);
+        }
+        BenchmarkUtil::report("Library reference", timer.elapsed(), REFERENCE_COUNT);
+        size_t endMemory = BenchmarkUtil::getResidentMemory();
+        if (endMemory > startMemory)
+        {
+            BenchmarkUtil::reportMemory("Library reference memory", endMemory - startMemory, REFERENCE_COUNT);
+        }
+        REQUIRE(docs.back()->getNodeDef("ND_image_color3"));
+    }
+}
@@ -40,6 +40,21 @@ TEST_CASE("Element", "[element]")
     REQUIRE(elem1->getTypedAttribute<bool>("customColor") == false);
     REQUIRE(elem1->getTypedAttribute<mx::Color3>("customFlag") == mx::Color3(0.0f));
 
+    // Elements with the same attribute names share an interned name vector.
+    elem2->setTypedAttribute<bool>("customFlag", false);
+    REQUIRE(&elem1->getAttributeNames() != &elem2->getAttributeNames());
+    elem2->setTypedAttribute<mx::Color3>("customColor", mx::Color3(0.5f));
+    REQUIRE(&elem1->getAttributeNames() == &elem2->getAttributeNames());
+    REQUIRE(elem2->getAttributeNames() == mx::StringVec({ "customFlag", "customColor" }));
+    elem2->removeAttribute("customFlag");
+    REQUIRE(elem2->getAttributeNames() == mx::StringVec({ "customColor" }));
+    REQUIRE(elem2->getTypedAttribute<mx::Color3>("customColor") == mx::Color3(0.5f));
+    elem2->setTypedAttribute<bool>("customFlag", false);
+    REQUIRE(elem2->getAttributeNames() == mx::StringVec({ "customColor", "customFlag" }));
+    elem2->removeAttribute("customColor");
+    elem2->removeAttribute("customFlag");
+    REQUIRE(elem2->getAttributeNames().empty());
+
     // Modify element names.
     elem1->setName("elem1");
     elem2->setName("elem2");
@@ -66,3 +81,83 @@ TEST_CASE("Element", "[element]")
     }
     REQUIRE_THROWS_AS(orphan->getDocument(), mx::ExceptionOrphanedElement&);    
 }
+
+TEST_CASE("Typed children", "[element]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::NodeGraphPtr nodeGraph = doc->addNodeGraph();
+    mx::NodePtr constant = nodeGraph->addNode("constant");
+    mx::NodePtr image = nodeGraph->addNode("image");
+    mx::OutputPtr output = nodeGraph->addOutput();
+    mx::NodePtr add = nodeGraph->addNode("add");
+
+    // Typed queries preserve the order in which children were added.
+    std::vector<mx::NodePtr> nodes = nodeGraph->getNodes();
+    REQUIRE(nodes == std::vector<mx::NodePtr>({ constant, image, add }));
+    REQUIRE(nodeGraph->getNodes("image") == std::vector<mx::NodePtr>({ image }));
+    REQUIRE(nodeGraph->getChildCountOfType<mx::Node>() == 3);
+    REQUIRE(nodeGraph->getChildOfTypeAtIndex<mx::Node>(2) == add);
+    REQUIRE(!nodeGraph->getChildOfTypeAtIndex<mx::Node>(3));
+    REQUIRE(nodeGraph->getChildOfTypeAtIndex<mx::Output>(0) == output);
+    REQUIRE(nodeGraph->getChildrenOfType<mx::TypedElement>().size() == 4);
+
+    // Reordering, renaming and removing children updates typed queries.
+    nodeGraph->setChildIndex(add->getName(), 0);
+    REQUIRE(nodeGraph->getNodes() == std::vector<mx::NodePtr>({ add, constant, image }));
+    image->setName("image2");
+    REQUIRE(nodeGraph->getChildOfTypeAtIndex<mx::Node>(2) == image);
+    nodeGraph->removeNode(constant->getName());
+    REQUIRE(nodeGraph->getNodes() == std::vector<mx::NodePtr>({ add, image }));
+    nodeGraph->removeOutput(output->getName());
+    REQUIRE(nodeGraph->getChildCountOfType<mx::Output>() == 0);
+    REQUIRE(nodeGraph->getOutputs().empty());
+
+    // Copied content is indexed as well.
+    mx::DocumentPtr copy = doc->copy();
+    REQUIRE(copy->getNodeGraph(nodeGraph->getName())->getNodes().size() == 2);
+    REQUIRE(copy->getChildOfTypeAtIndex<mx::NodeGraph>(0)->getName() == nodeGraph->getName());
+}
+
+TEST_CASE("Cached values", "[element]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::NodePtr constant = doc->addNode("constant");
+    mx::InputPtr input = constant->addInput("value", "float");
+    REQUIRE(!input->getCachedValue());
+
+    // Repeated queries share a single parsed value.
+    input->setValue(0.5f);
+    size_t parseCount = mx::Value::getParseCount();
+    mx::ConstValuePtr value = input->getCachedValue();
+    REQUIRE(value->asA<float>() == 0.5f);
+    REQUIRE(input->getCachedValue() == value);
+    REQUIRE(input->getValue() != value);
+    REQUIRE(input->getValue()->asA<float>() == 0.5f);
+    REQUIRE(mx::Value::getParseCount() == parseCount + 1);
+
+    // Changes to other attributes preserve the cached value.
+    input->setAttribute("uiname", "Value");
+    REQUIRE(input->getCachedValue() == value);
+
+    // Changes to the value or type invalidate the cached value.
+    input->setValueString("0.25");
+    REQUIRE(input->getCachedValue()->asA<float>() == 0.25f);
+    input->setType("color3");
+    input->setValueString("1, 0, 0");
+    REQUIRE(input->getCachedValue()->asA<mx::Color3>() == mx::Color3(1.0f, 0.0f, 0.0f));
+    input->setType("string");
+    REQUIRE(input->getCachedValue()->asA<std::string>() == "1, 0, 0");
+    input->removeAttribute(mx::ValueElement::VALUE_ATTRIBUTE);
+    REQUIRE(!input->getCachedValue());
+    REQUIRE(!input->getValue());
+
+    // Copied and cleared content invalidates the cached value.
+    input->setValue(2);
+    REQUIRE(input->getCachedValue()->asA<int>() == 2);
+    mx::InputPtr other = constant->addInput("other");
+    other->setValue(3);
+    input->copyContentFrom(other);
+    REQUIRE(input->getCachedValue()->asA<int>() == 3);
+    input->clearContent();
+    REQUIRE(!input->getCachedValue());
+}
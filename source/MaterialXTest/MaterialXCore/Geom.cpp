@@ -4,11 +4,60 @@
 //
 
 #include <MaterialXTest/Catch/catch.hpp>
+#include <MaterialXTest/BenchmarkUtil.h>
 
 #include <MaterialXCore/Document.h>
 
+#include <algorithm>
+#include <random>
+
 namespace mx = MaterialX;
 
+namespace {
+
+// Return true if the two geometry strings match, using the reference
+// implementation built on GeomPath.
+bool referenceGeomStringsMatch(const std::string& geom1, const std::string& geom2, bool contains)
+{
+    for (const std::string& name1 : mx::splitString(geom1, mx::ARRAY_VALID_SEPARATORS))
+    {
+        for (const std::string& name2 : mx::splitString(geom2, mx::ARRAY_VALID_SEPARATORS))
+        {
+            if (mx::GeomPath(name1).isMatching(mx::GeomPath(name2), contains))
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// Return a random geometry string with the given maximum number of names,
+// drawn from a small vocabulary so that paths frequently overlap.
+std::string randomGeomString(std::mt19937& rng, size_t maxNames)
+{
+    static const char* SEGMENTS[] = { "a", "b", "ab", "robot1", "arm" };
+    std::string geom;
+    size_t nameCount = rng() % (maxNames + 1);
+    for (size_t i = 0; i < nameCount; i++)
+    {
+        if (i)
+        {
+            geom += (rng() % 2) ? ", " : ",";
+        }
+        size_t depth = rng() % 4;
+        geom += depth ? "" : "/";
+        for (size_t j = 0; j < depth; j++)
+        {
+            geom += (rng() % 4) ? "/" : "//";
+            geom += SEGMENTS[rng() % 5];
+        }
+    }
+    return geom;
+}
+
+} // anonymous namespace
+
 TEST_CASE("Geom strings", "[geom]")
 {
     // Test for overlapping paths.
@@ -22,6 +71,35 @@ TEST_CASE("Geom strings", "[geom]")
     // Test that one path contains another.
     REQUIRE(mx::geomStringsMatch("/", "/robot1", true));
     REQUIRE(!mx::geomStringsMatch("/robot1", "/", true));
+
+    // Test compiled geometry strings.
+    mx::GeomPathMatcher matcher("/robot1/left_arm, /robot2");
+    REQUIRE(!matcher.isEmpty());
+    REQUIRE(matcher.matches("/robot1"));
+    REQUIRE(matcher.matches("/robot1/left_arm/hand"));
+    REQUIRE(matcher.matches("/robot3, /robot2/head"));
+    REQUIRE(matcher.matches("/"));
+    REQUIRE(!matcher.matches("/robot1/right_arm"));
+    REQUIRE(!matcher.matches(""));
+    REQUIRE(!matcher.matches("/robot1", true));
+    REQUIRE(matcher.matches("/robot1/left_arm", true));
+    REQUIRE(mx::GeomPathMatcher().isEmpty());
+    REQUIRE(!mx::GeomPathMatcher(", ").matches("/"));
+
+    // Compiled and direct matches are consistent with GeomPath.
+    std::mt19937 rng(0);
+    for (size_t i = 0; i < 2000; i++)
+    {
+        std::string geom1 = randomGeomString(rng, 3);
+        std::string geom2 = randomGeomString(rng, 2);
+        mx::GeomPathMatcher compiled(geom1);
+        for (bool contains : { false, true })
+        {
+            bool expected = referenceGeomStringsMatch(geom1, geom2, contains);
+            REQUIRE(mx::geomStringsMatch(geom1, geom2, contains) == expected);
+            REQUIRE(compiled.matches(geom2, contains) == expected);
+        }
+    }
 }
 
 TEST_CASE("Geom elements", "[geom]")
@@ -83,6 +161,41 @@ TEST_CASE("Geom elements", "[geom]")
     collection1->setGeomPrefix("/root");
     REQUIRE(collection1->matchesGeomString("/root/scene1"));
     REQUIRE(!collection1->matchesGeomString("/root/scene2"));
+    collection1->removeAttribute(mx::Element::GEOM_PREFIX_ATTRIBUTE);
+
+    // Compiled collections are updated as their geometry is edited.
+    REQUIRE(collection2->matchesGeomString("/scene1/sphere3"));
+    collection1->setExcludeGeom("/scene1/sphere2, /scene1/sphere3");
+    REQUIRE(!collection2->matchesGeomString("/scene1/sphere3"));
+    collection2->setIncludeGeom("/scene2");
+    REQUIRE(collection2->matchesGeomStrings({ "/scene1/sphere1", "/scene1/sphere3", "/scene2/cube", "/scene3" }) ==
+            std::vector<bool>({ true, false, true, false }));
+    collection1->setName("collection3");
+    REQUIRE(!collection2->matchesGeomString("/scene1/sphere1"));
+    collection1->setName("collection1");
+    REQUIRE(collection2->matchesGeomString("/scene1/sphere1"));
+    doc->removeCollection("collection1");
+    REQUIRE(!collection2->matchesGeomString("/scene1/sphere1"));
+    collection1 = doc->addCollection("collection1");
+    collection1->setIncludeGeom("/scene4");
+    REQUIRE(collection2->matchesGeomString("/scene4"));
+
+    // Cycles are reported by every query.
+    collection1->setIncludeCollection(collection2);
+    REQUIRE_THROWS_AS(collection1->matchesGeomString("/scene4"), mx::ExceptionFoundCycle&);
+    REQUIRE_THROWS_AS(collection2->matchesGeomStrings({ "/scene2" }), mx::ExceptionFoundCycle&);
+    REQUIRE(collection1->hasIncludeCycle());
+    collection1->setIncludeCollection(nullptr);
+    REQUIRE(!collection1->hasIncludeCycle());
+
+    // Compiled geometry of geometric elements is updated as it is edited.
+    REQUIRE(geominfo2->matchesGeomString("/robot1/head"));
+    geominfo2->setGeom("/robot3");
+    REQUIRE(!geominfo2->matchesGeomString("/robot1/head"));
+    REQUIRE(geominfo2->matchesGeomStrings({ "/robot1", "/robot3/head" }) == std::vector<bool>({ false, true }));
+    doc->setGeomPrefix("/world");
+    REQUIRE(geominfo2->matchesGeomString("/world/robot3"));
+    REQUIRE(!geominfo2->matchesGeomString("/robot3"));
 }
 
 TEST_CASE("GeomPropDef", "[geom]")
@@ -103,3 +216,90 @@ TEST_CASE("GeomPropDef", "[geom]")
     REQUIRE(input->getDefaultGeomProp() == worldNormal);
     REQUIRE(doc->validate());
 }
+
+TEST_CASE("Geom binding benchmark", "[geom][benchmark]")
+{
+    const size_t PRIM_COUNT = 20000;
+
+    // Create a look whose assignments bind collections and geometry strings
+    // to a set of scene branches.
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::LookPtr look = doc->addLook("look1");
+    mx::StringVec branches;
+    for (size_t i = 0; i < 50; i++)
+    {
+        std::string branch = "/scene/set" + std::to_string(i % 10) + "/branch" + std::to_string(i);
+        branches.push_back(branch);
+        mx::CollectionPtr base = doc->addCollection("base" + std::to_string(i));
+        base->setIncludeGeom(branch + "/a, " + branch + "/b, " + branch + "/c");
+        mx::CollectionPtr collection = doc->addCollection("collection" + std::to_string(i));
+        collection->setIncludeCollection(base);
+        collection->setExcludeGeom(branch + "/b/hidden");
+        mx::MaterialAssignPtr byCollection = look->addMaterialAssign("collectionAssign" + std::to_string(i));
+        byCollection->setCollection(collection);
+        mx::MaterialAssignPtr byGeom = look->addMaterialAssign("geomAssign" + std::to_string(i));
+        byGeom->setGeom(branch + "/d, " + branch + "/e");
+    }
+
+    // Create the prim paths to be resolved.
+    mx::StringVec prims;
+    for (size_t i = 0; i < PRIM_COUNT; i++)
+    {
+        const char* leaves[] = { "a", "b", "d", "f" };
+        prims.push_back(branches[i % branches.size()] + "/" + leaves[i % 4] + "/mesh" + std::to_string(i));
+    }
+
+    // Compare per-prim resolution against the uncompiled geometry strings.
+    size_t expectedCount = 0;
+    {
+        BenchmarkUtil::Timer timer;
+        for (const std::string& prim : prims)
+        {
+            for (mx::MaterialAssignPtr assign : look->getMaterialAssigns())
+            {
+                mx::CollectionPtr collection = assign->getCollection();
+                bool matched = mx::geomStringsMatch(prim, assign->getActiveGeom());
+                if (!matched && collection && !mx::geomStringsMatch(collection->getActiveExcludeGeom(), prim, true))
+                {
+                    for (mx::CollectionPtr included : collection->getIncludeCollections())
+                    {
+                        matched = matched || mx::geomStringsMatch(included->getActiveIncludeGeom(), prim);
+                    }
+                }
+                expectedCount += matched ? 1 : 0;
+            }
+        }
+        BenchmarkUtil::report("Uncompiled geometry binding of " + std::to_string(PRIM_COUNT) + " prims",
+                              timer.elapsed(), 1);
+    }
+    size_t compiledCount = 0;
+    {
+        BenchmarkUtil::Timer timer;
+        for (const std::string& prim : prims)
+        {
+            for (mx::MaterialAssignPtr assign : look->getMaterialAssigns())
+            {
+                mx::CollectionPtr collection = assign->getCollection();
+                bool matched = assign->matchesGeomString(prim) || (collection && collection->matchesGeomString(prim));
+                compiledCount += matched ? 1 : 0;
+            }
+        }
+        BenchmarkUtil::report("Compiled geometry binding of " + std::to_string(PRIM_COUNT) + " prims",
+                              timer.elapsed(), 1);
+    }
+    size_t batchCount = 0;
+    {
+        BenchmarkUtil::Timer timer;
+        for (mx::MaterialAssignPtr assign : look->getMaterialAssigns())
+        {
+            mx::CollectionPtr collection = assign->getCollection();
+            std::vector<bool> matched = collection ? collection->matchesGeomStrings(prims) : assign->matchesGeomStrings(prims);
+            batchCount += std::count(matched.begin(), matched.end(), true);
+        }
+        BenchmarkUtil::report("Batched geometry binding of " + std::to_string(PRIM_COUNT) + " prims",
+                              timer.elapsed(), 1);
+    }
+    REQUIRE(expectedCount > 0);
+    REQUIRE(compiledCount == expectedCount);
+    REQUIRE(batchCount == expectedCount);
+}
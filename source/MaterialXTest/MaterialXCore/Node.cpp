@@ -4,11 +4,13 @@
 //
 
 #include <MaterialXTest/Catch/catch.hpp>
+#include <MaterialXTest/BenchmarkUtil.h>
 
 #include <MaterialXCore/Definition.h>
 #include <MaterialXCore/Document.h>
 
 #include <MaterialXFormat/File.h>
+#include <MaterialXFormat/Util.h>
 #include <MaterialXFormat/XmlIo.h>
 
 namespace mx = MaterialX;
@@ -135,6 +137,113 @@ TEST_CASE("Node", "[node]")
     REQUIRE(doc->getOutputs().empty());
 }
 
+TEST_CASE("NodeDef cache", "[node]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::NodeDefPtr floatDef = doc->addNodeDef("ND_custom_float", "float", "custom");
+    floatDef->addInput("in", "float");
+    mx::NodeDefPtr colorDef = doc->addNodeDef("ND_custom_color3", "color3", "custom");
+    mx::NodeGraphPtr nodeGraph = doc->addNodeGraph();
+    mx::NodePtr node = nodeGraph->addNode("custom", "node1", "float");
+
+    // Statistics are only recorded when enabled.
+    REQUIRE(!doc->isNodeDefCacheStatsEnabled());
+    REQUIRE(node->getNodeDef("genosl") == floatDef);
+    REQUIRE(node->getNodeDef("genosl") == floatDef);
+    REQUIRE(doc->getNodeDefCacheStats().hits == 0);
+    REQUIRE(doc->getNodeDefCacheStats().misses == 0);
+
+    // Repeated lookups are served from the cache.
+    doc->setNodeDefCacheStatsEnabled(true);
+    doc->resetNodeDefCacheStats();
+    REQUIRE(node->getNodeDef() == floatDef);
+    REQUIRE(node->getNodeDef() == floatDef);
+    REQUIRE(node->getNodeDef("genglsl") == floatDef);
+    mx::NodeDefCacheStats stats = doc->getNodeDefCacheStats();
+    REQUIRE(stats.hits == 1);
+    REQUIRE(stats.misses == 2);
+
+    // Edits to the node invalidate its cache.
+    node->setType("color3");
+    REQUIRE(node->getNodeDef() == colorDef);
+    node->setType("float");
+    node->setInputValue("in", 0.5f);
+    REQUIRE(node->getNodeDef() == floatDef);
+    node->setInputValue("extra", 0.5f);
+    REQUIRE(!node->getNodeDef());
+    node->removeInput("extra");
+    REQUIRE(node->getNodeDef() == floatDef);
+    node->setCategory("other");
+    REQUIRE(!node->getNodeDef());
+    node->setCategory("custom");
+    node->setNodeDefString(colorDef->getName());
+    REQUIRE(node->getNodeDef() == colorDef);
+    node->removeAttribute(mx::InterfaceElement::NODE_DEF_ATTRIBUTE);
+    REQUIRE(node->getNodeDef() == floatDef);
+
+    // Edits to nodedefs invalidate the caches of all nodes.
+    floatDef->setTarget("genosl");
+    REQUIRE(!node->getNodeDef("genglsl"));
+    REQUIRE(node->getNodeDef("genosl") == floatDef);
+    floatDef->removeAttribute(mx::Element::TARGET_ATTRIBUTE);
+    floatDef->removeInput("in");
+    REQUIRE(!node->getNodeDef());
+    floatDef->addInput("in", "float");
+    REQUIRE(node->getNodeDef() == floatDef);
+    doc->removeNodeDef(floatDef->getName());
+    REQUIRE(!node->getNodeDef());
+    mx::NodeDefPtr newDef = doc->addNodeDef("ND_custom_float", "float", "custom");
+    newDef->addInput("in", "float");
+    REQUIRE(node->getNodeDef() == newDef);
+
+    // Namespace changes invalidate the caches of all nodes.
+    newDef->setNamespace("ns");
+    REQUIRE(!node->getNodeDef());
+    node->setNamespace("ns");
+    REQUIRE(node->getNodeDef() == newDef);
+}
+
+TEST_CASE("NodeDef cache benchmark", "[node][benchmark]")
+{
+    const size_t ROUND_COUNT = 10;
+
+    // Create a node for every nodedef in the standard libraries.
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::FilePath libraryPath = mx::FilePath::getCurrentPath() / mx::FilePath("libraries");
+    mx::loadLibrary(libraryPath / mx::FilePath("stdlib/stdlib_defs.mtlx"), doc);
+    mx::loadLibrary(libraryPath / mx::FilePath("pbrlib/pbrlib_defs.mtlx"), doc);
+    mx::NodeGraphPtr nodeGraph = doc->addNodeGraph();
+    for (mx::NodeDefPtr nodeDef : doc->getNodeDefs())
+    {
+        nodeGraph->addNode(nodeDef->getNodeString(), mx::EMPTY_STRING, nodeDef->getType());
+    }
+    std::vector<mx::NodePtr> nodes = nodeGraph->getNodes();
+
+    // Resolve nodedefs repeatedly, as shader generation and validation do.
+    doc->setNodeDefCacheStatsEnabled(true);
+    doc->resetNodeDefCacheStats();
+    BenchmarkUtil::Timer timer;
+    size_t resolvedCount = 0;
+    for (size_t i = 0; i < ROUND_COUNT; i++)
+    {
+        for (mx::NodePtr node : nodes)
+        {
+            if (node->getNodeDef())
+            {
+                resolvedCount++;
+            }
+        }
+    }
+    BenchmarkUtil::report("NodeDef resolution", timer.elapsed(), ROUND_COUNT * nodes.size());
+    REQUIRE(resolvedCount == ROUND_COUNT * nodes.size());
+
+    mx::NodeDefCacheStats stats = doc->getNodeDefCacheStats();
+    std::cout << "NodeDef cache: " << stats.hits << " hits, " << stats.misses << " misses, " <<
+                 stats.getHitRate() * 100.0 << "% hit rate" << std::endl;
+    REQUIRE(stats.misses == nodes.size());
+    REQUIRE(stats.hits == (ROUND_COUNT - 1) * nodes.size());
+}
+
 TEST_CASE("Flatten", "[nodegraph]")
 {
     mx::FileSearchPath searchPath = "resources/Materials/Examples/Syntax" +
@@ -182,6 +291,80 @@ TEST_CASE("Flatten", "[nodegraph]")
     REQUIRE(totalNodeCount == 15);
 }
 
+TEST_CASE("Flatten benchmark", "[nodegraph][benchmark]")
+{
+    const size_t LEVEL_COUNT = 4;
+    const size_t GRAPH_WIDTH = 3;
+    const size_t ROOT_NODE_COUNT = 50;
+
+    // Create a chain of nodes within the given graph, with the first node
+    // optionally bound to an interface input, and connect the chain to the
+    // graph output.
+    auto addNodeChain = [](mx::GraphElementPtr graph, const std::string& category, size_t count, bool bindInterface)
+    {
+        mx::NodePtr previous;
+        for (size_t i = 0; i < count; i++)
+        {
+            mx::NodePtr node = graph->addNode(category, category + "_" + std::to_string(i), "float");
+            mx::InputPtr input = node->addInput("in", "float");
+            if (previous)
+            {
+                input->setConnectedNode(previous);
+            }
+            else if (bindInterface)
+            {
+                input->setInterfaceName("in");
+            }
+            previous = node;
+        }
+        mx::OutputPtr output = graph->addOutput("out", "float");
+        output->setConnectedNode(previous);
+    };
+
+    // Create nested graph definitions, where each level instantiates the
+    // level beneath it, and the lowest level contains atomic nodes.
+    mx::DocumentPtr doc = mx::createDocument();
+    for (size_t level = 0; level < LEVEL_COUNT; level++)
+    {
+        std::string category = "level" + std::to_string(level);
+        mx::NodeDefPtr nodeDef = doc->addNodeDef("ND_" + category, "float", category);
+        nodeDef->addInput("in", "float");
+        mx::NodeGraphPtr defGraph = doc->addNodeGraph("NG_" + category);
+        defGraph->setNodeDef(nodeDef);
+        addNodeChain(defGraph, level ? "level" + std::to_string(level - 1) : "add", GRAPH_WIDTH, true);
+    }
+    mx::NodeGraphPtr graph = doc->addNodeGraph("root");
+    addNodeChain(graph, "level" + std::to_string(LEVEL_COUNT - 1), ROOT_NODE_COUNT, false);
+
+    BenchmarkUtil::Timer timer;
+    mx::FlattenStats stats;
+    graph->flattenSubgraphs(mx::EMPTY_STRING, &stats);
+    BenchmarkUtil::report("Flatten subgraphs", timer.elapsed(), stats.instantiatedNodeCount);
+
+    // Verify the reported statistics.
+    size_t atomicNodeCount = ROOT_NODE_COUNT;
+    size_t flattenedNodeCount = 0;
+    for (size_t level = 0; level < LEVEL_COUNT; level++)
+    {
+        flattenedNodeCount += atomicNodeCount;
+        atomicNodeCount *= GRAPH_WIDTH;
+    }
+    REQUIRE(stats.flattenedNodeCount == flattenedNodeCount);
+    REQUIRE(stats.instantiatedNodeCount == flattenedNodeCount - ROOT_NODE_COUNT + atomicNodeCount);
+    REQUIRE(stats.nestingDepth == LEVEL_COUNT);
+
+    // Verify that the flattened graph is a single chain of atomic nodes.
+    REQUIRE(graph->getNodes().size() == atomicNodeCount);
+    REQUIRE(graph->getNodes("add").size() == atomicNodeCount);
+    size_t edgeCount = 0;
+    for (mx::Edge edge : graph->getOutput("out")->traverseGraph())
+    {
+        edgeCount++;
+    }
+    REQUIRE(edgeCount == atomicNodeCount);
+    REQUIRE(isTopologicalOrder(graph->topologicalSort()));
+}
+
 TEST_CASE("Topological sort", "[nodegraph]")
 {
     // Create a document.
@@ -4,11 +4,49 @@
 //
 
 #include <MaterialXTest/Catch/catch.hpp>
+#include <MaterialXTest/BenchmarkUtil.h>
 
 #include <MaterialXCore/Document.h>
 
+#include <map>
+#include <set>
+
 namespace mx = MaterialX;
 
+namespace {
+
+// Create a diamond lattice of the given depth within a node graph, in which
+// each layer contains two nodes, and each node is connected to both nodes of
+// the previous layer.  The number of paths through the lattice doubles with
+// each layer.
+mx::OutputPtr createDiamondLattice(mx::NodeGraphPtr nodeGraph, size_t depth)
+{
+    std::vector<mx::NodePtr> previousLayer;
+    for (size_t i = 0; i < depth; i++)
+    {
+        std::vector<mx::NodePtr> layer;
+        for (size_t j = 0; j < 2; j++)
+        {
+            mx::NodePtr node = nodeGraph->addNode("add", "node" + std::to_string(i) + "_" + std::to_string(j), "float");
+            if (!previousLayer.empty())
+            {
+                node->setConnectedNode("in1", previousLayer[0]);
+                node->setConnectedNode("in2", previousLayer[1]);
+            }
+            layer.push_back(node);
+        }
+        previousLayer = layer;
+    }
+    mx::NodePtr root = nodeGraph->addNode("add", "root", "float");
+    root->setConnectedNode("in1", previousLayer[0]);
+    root->setConnectedNode("in2", previousLayer[1]);
+    mx::OutputPtr output = nodeGraph->addOutput("out", "float");
+    output->setConnectedNode(root);
+    return output;
+}
+
+} // anonymous namespace
+
 TEST_CASE("Traversal", "[traversal]")
 {
     // Test null iterators.
@@ -171,3 +209,156 @@ TEST_CASE("Traversal", "[traversal]")
     REQUIRE(!output->hasUpstreamCycle());
     REQUIRE(doc->validate());
 }
+
+TEST_CASE("Unique graph traversal", "[traversal]")
+{
+    const size_t LATTICE_DEPTH = 6;
+
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::NodeGraphPtr nodeGraph = doc->addNodeGraph();
+    mx::OutputPtr output = createDiamondLattice(nodeGraph, LATTICE_DEPTH);
+    REQUIRE(doc->validate());
+    REQUIRE(output->traverseGraphUnique().isUnique());
+    REQUIRE(!output->traverseGraph().isUnique());
+
+    // A unique traversal visits each edge of the graph exactly once.
+    std::set<mx::Edge> pathEdges;
+    size_t pathEdgeCount = 0;
+    for (mx::Edge edge : output->traverseGraph())
+    {
+        pathEdges.insert(edge);
+        pathEdgeCount++;
+    }
+    std::set<mx::Edge> uniqueEdges;
+    size_t uniqueEdgeCount = 0;
+    for (mx::Edge edge : output->traverseGraphUnique())
+    {
+        uniqueEdges.insert(edge);
+        uniqueEdgeCount++;
+    }
+    const size_t graphEdgeCount = 1 + 2 + 4 * (LATTICE_DEPTH - 1);
+    REQUIRE(uniqueEdges == pathEdges);
+    REQUIRE(uniqueEdgeCount == graphEdgeCount);
+    REQUIRE(pathEdgeCount > uniqueEdgeCount);
+
+    // Each node is returned once for each of its downstream connections.
+    std::map<mx::ElementPtr, size_t> visitCounts;
+    for (mx::Edge edge : output->traverseGraphUnique())
+    {
+        visitCounts[edge.getUpstreamElement()]++;
+    }
+    for (mx::NodePtr node : nodeGraph->getNodes())
+    {
+        REQUIRE(visitCounts[node] == node->getDownstreamPorts().size());
+    }
+
+    // Subgraphs pruned on one visit are traversed on a later visit.
+    size_t prunedEdgeCount = 0;
+    bool pruned = false;
+    for (mx::GraphIterator it = output->traverseGraphUnique().begin(); it != mx::GraphIterator::end(); ++it)
+    {
+        if (!pruned && it.getUpstreamElement()->getName() == "node4_0")
+        {
+            it.setPruneSubgraph(true);
+            pruned = true;
+        }
+        prunedEdgeCount++;
+    }
+    REQUIRE(pruned);
+    REQUIRE(prunedEdgeCount == graphEdgeCount);
+
+    // Cycles are detected as in a standard traversal.
+    mx::NodePtr node = nodeGraph->getNode("node0_0");
+    node->setConnectedNode("in1", nodeGraph->getNode("node3_1"));
+    REQUIRE_THROWS_AS([&]() { for (mx::Edge edge : output->traverseGraphUnique()) { } }(), mx::ExceptionFoundCycle&);
+    REQUIRE(output->hasUpstreamCycle());
+    node->removeInput("in1");
+    REQUIRE(!output->hasUpstreamCycle());
+}
+
+TEST_CASE("Traversal benchmark", "[traversal][benchmark]")
+{
+    const size_t NODE_COUNT = 5000;
+    const size_t INPUT_COUNT = 4;
+    const size_t TRAVERSAL_COUNT = 10;
+
+    // Create a long chain of nodes, each with one connected input and
+    // several unconnected inputs and parameters.
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::NodeGraphPtr nodeGraph = doc->addNodeGraph();
+    mx::NodePtr previous;
+    for (size_t i = 0; i < NODE_COUNT; i++)
+    {
+        mx::NodePtr node = nodeGraph->addNode("add", "node" + std::to_string(i), "float");
+        for (size_t j = 0; j < INPUT_COUNT; j++)
+        {
+            node->setInputValue("in" + std::to_string(j), 0.0f);
+            node->setParameterValue("param" + std::to_string(j), 0.0f);
+        }
+        if (previous)
+        {
+            node->setConnectedNode("in0", previous);
+        }
+        previous = node;
+    }
+    mx::OutputPtr output = nodeGraph->addOutput("out", "float");
+    output->setConnectedNode(previous);
+
+    BenchmarkUtil::Timer timer;
+    size_t edgeCount = 0;
+    for (size_t i = 0; i < TRAVERSAL_COUNT; i++)
+    {
+        for (mx::Edge edge : output->traverseGraph())
+        {
+            edgeCount++;
+        }
+    }
+    BenchmarkUtil::report("Graph traversal", timer.elapsed(), TRAVERSAL_COUNT);
+    REQUIRE(edgeCount == NODE_COUNT * TRAVERSAL_COUNT);
+
+    timer.reset();
+    size_t inputCount = 0;
+    for (size_t i = 0; i < TRAVERSAL_COUNT; i++)
+    {
+        for (mx::NodePtr node : nodeGraph->getNodes())
+        {
+            inputCount += node->getInputs().size();
+        }
+    }
+    BenchmarkUtil::report("Typed child enumeration", timer.elapsed(), TRAVERSAL_COUNT);
+    REQUIRE(inputCount == NODE_COUNT * INPUT_COUNT * TRAVERSAL_COUNT);
+
+    timer.reset();
+    std::vector<mx::ElementPtr> sorted = nodeGraph->topologicalSort();
+    BenchmarkUtil::report("Topological sort", timer.elapsed());
+    REQUIRE(sorted.size() == NODE_COUNT + 1);
+}
+
+TEST_CASE("Unique graph traversal benchmark", "[traversal][benchmark]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+    for (size_t depth : { 8, 12, 16 })
+    {
+        mx::NodeGraphPtr nodeGraph = doc->addNodeGraph();
+        mx::OutputPtr output = createDiamondLattice(nodeGraph, depth);
+        const std::string label = "diamond lattice of depth " + std::to_string(depth);
+
+        BenchmarkUtil::Timer timer;
+        size_t pathEdgeCount = 0;
+        for (mx::Edge edge : output->traverseGraph())
+        {
+            pathEdgeCount++;
+        }
+        BenchmarkUtil::report("Graph traversal of " + label, timer.elapsed());
+
+        timer.reset();
+        size_t uniqueEdgeCount = 0;
+        for (mx::Edge edge : output->traverseGraphUnique())
+        {
+            uniqueEdgeCount++;
+        }
+        BenchmarkUtil::report("Unique graph traversal of " + label, timer.elapsed());
+        std::cout << "Edges visited: " << pathEdgeCount << " by path, " << uniqueEdgeCount << " unique" << std::endl;
+        REQUIRE(uniqueEdgeCount == 4 * depth - 1);
+    }
+}
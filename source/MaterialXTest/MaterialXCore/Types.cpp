@@ -4,15 +4,84 @@
 //
 
 #include <MaterialXTest/Catch/catch.hpp>
+#include <MaterialXTest/BenchmarkUtil.h>
 
 #include <MaterialXCore/Types.h>
 #include <MaterialXCore/Value.h>
 
+#include <random>
+
 namespace mx = MaterialX;
 
 const float EPSILON = 1e-4f;
 const float PI = std::acos(-1.0f);
 
+namespace {
+
+// Scalar reference implementations of the specialized Matrix44 kernels.
+
+mx::Matrix44 referenceProduct(const mx::Matrix44& lhs, const mx::Matrix44& rhs)
+{
+    mx::Matrix44 res;
+    for (size_t i = 0; i < 4; i++)
+        for (size_t j = 0; j < 4; j++)
+            for (size_t k = 0; k < 4; k++)
+                res[i][j] += lhs[i][k] * rhs[k][j];
+    return res;
+}
+
+mx::Matrix44 referenceInverse(const mx::Matrix44& m)
+{
+    return m.getAdjugate() / m.getDeterminant();
+}
+
+mx::Vector4 referenceMultiply(const mx::Matrix44& m, const mx::Vector4& v)
+{
+    return mx::Vector4(
+        v[0]*m[0][0] + v[1]*m[1][0] + v[2]*m[2][0] + v[3]*m[3][0],
+        v[0]*m[0][1] + v[1]*m[1][1] + v[2]*m[2][1] + v[3]*m[3][1],
+        v[0]*m[0][2] + v[1]*m[1][2] + v[2]*m[2][2] + v[3]*m[3][2],
+        v[0]*m[0][3] + v[1]*m[1][3] + v[2]*m[2][3] + v[3]*m[3][3]);
+}
+
+// Return the largest absolute component of the given matrix, for use in
+// scaling comparison tolerances.
+float getMaxMagnitude(const mx::Matrix44& m)
+{
+    float magnitude = 0.0f;
+    for (const auto& row : m)
+        for (float value : row)
+            magnitude = std::max(magnitude, std::abs(value));
+    return magnitude;
+}
+
+// Return true if the given vectors are equivalent within the given tolerance.
+template<class V> bool isEquivalent(const V& lhs, const V& rhs, float tolerance)
+{
+    for (size_t i = 0; i < V::numElements(); i++)
+    {
+        if (std::abs(lhs[i] - rhs[i]) > tolerance)
+            return false;
+    }
+    return true;
+}
+
+// Return a random affine transform, composed of a rotation, a non-uniform
+// scale and a translation.
+mx::Matrix44 createRandomTransform(std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> angleDist(-PI, PI);
+    std::uniform_real_distribution<float> scaleDist(0.5f, 2.0f);
+    std::uniform_real_distribution<float> offsetDist(-10.0f, 10.0f);
+    return mx::Matrix44::createScale(mx::Vector3(scaleDist(rng), scaleDist(rng), scaleDist(rng))) *
+           mx::Matrix44::createRotationX(angleDist(rng)) *
+           mx::Matrix44::createRotationY(angleDist(rng)) *
+           mx::Matrix44::createRotationZ(angleDist(rng)) *
+           mx::Matrix44::createTranslation(mx::Vector3(offsetDist(rng), offsetDist(rng), offsetDist(rng)));
+}
+
+} // anonymous namespace
+
 TEST_CASE("Vectors", "[types]")
 {
     mx::Vector3 v1(1, 2, 3);
@@ -121,3 +190,159 @@ TEST_CASE("Matrices", "[types]")
     REQUIRE((rotX * rotZ).isEquivalent(mx::Matrix44::createScale({-1, 1, -1}), EPSILON));
     REQUIRE((rotY * rotZ).isEquivalent(mx::Matrix44::createScale({1, -1, -1}), EPSILON));
 }
+
+TEST_CASE("Matrix kernels", "[types]")
+{
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> valueDist(-4.0f, 4.0f);
+
+    for (int i = 0; i < 1000; i++)
+    {
+        mx::Matrix44 m1 = createRandomTransform(rng);
+        mx::Matrix44 m2(mx::Uninit{});
+        for (float& value : m2[0]) value = valueDist(rng);
+        for (float& value : m2[1]) value = valueDist(rng);
+        for (float& value : m2[2]) value = valueDist(rng);
+        for (float& value : m2[3]) value = valueDist(rng);
+
+        // Products and vector transforms match the scalar reference within a
+        // tolerance scaled to the magnitude of the result.
+        mx::Matrix44 product = referenceProduct(m1, m2);
+        REQUIRE((m1 * m2).isEquivalent(product, EPSILON * std::max(getMaxMagnitude(product), 1.0f)));
+        product = referenceProduct(m2, m1);
+        REQUIRE((m2 * m1).isEquivalent(product, EPSILON * std::max(getMaxMagnitude(product), 1.0f)));
+        mx::Vector4 v(valueDist(rng), valueDist(rng), valueDist(rng), valueDist(rng));
+        REQUIRE(isEquivalent(m2.multiply(v), referenceMultiply(m2, v), EPSILON * std::max(getMaxMagnitude(m2), 1.0f)));
+
+        // Inverses match the scalar reference within tolerance.
+        REQUIRE(m1.getInverse().isEquivalent(referenceInverse(m1), EPSILON));
+        REQUIRE((m1 * m1.getInverse()).isEquivalent(mx::Matrix44::IDENTITY, EPSILON));
+        if (std::abs(m2.getDeterminant()) > 1.0f)
+        {
+            mx::Matrix44 inverse = m2.getInverse();
+            mx::Matrix44 reference = referenceInverse(m2);
+            REQUIRE(inverse.isEquivalent(reference, EPSILON * std::max(getMaxMagnitude(reference), 1.0f)));
+        }
+
+        // Batched transforms match their single-vector equivalents within
+        // tolerance.
+        const float transformTolerance = EPSILON * std::max(getMaxMagnitude(m1), 1.0f);
+        std::vector<mx::Vector3> points(7);
+        for (mx::Vector3& point : points)
+        {
+            point = mx::Vector3(valueDist(rng), valueDist(rng), valueDist(rng));
+        }
+        std::vector<mx::Vector3> transformed(points.size());
+        m1.transformPoints(points[0].data(), transformed[0].data(), points.size());
+        for (size_t j = 0; j < points.size(); j++)
+        {
+            REQUIRE(isEquivalent(transformed[j], m1.transformPoint(points[j]), transformTolerance));
+        }
+        m1.transformVectors(points[0].data(), transformed[0].data(), points.size());
+        for (size_t j = 0; j < points.size(); j++)
+        {
+            REQUIRE(isEquivalent(transformed[j], m1.transformVector(points[j]), transformTolerance));
+        }
+        std::vector<mx::Vector3> normals = points;
+        m1.transformNormals(normals[0].data(), normals[0].data(), normals.size());
+        for (size_t j = 0; j < points.size(); j++)
+        {
+            REQUIRE(isEquivalent(normals[j], m1.transformNormal(points[j]), transformTolerance));
+        }
+    }
+}
+
+TEST_CASE("Matrix kernel benchmark", "[types][benchmark]")
+{
+    const size_t ITERATIONS = 1000000;
+    const size_t VECTOR_COUNT = 100000;
+
+    std::mt19937 rng(1);
+    std::vector<mx::Matrix44> matrices;
+    for (int i = 0; i < 64; i++)
+    {
+        matrices.push_back(createRandomTransform(rng));
+    }
+
+    // Matrix products
+    mx::Matrix44 scalarSum(0.0f);
+    mx::Matrix44 simdSum(0.0f);
+    BenchmarkUtil::Timer timer;
+    for (size_t i = 0; i < ITERATIONS; i++)
+    {
+        scalarSum += referenceProduct(matrices[i % 64], matrices[(i + 1) % 64]);
+    }
+    BenchmarkUtil::report("Scalar Matrix44 product", timer.elapsed(), ITERATIONS);
+    timer.reset();
+    for (size_t i = 0; i < ITERATIONS; i++)
+    {
+        simdSum += matrices[i % 64] * matrices[(i + 1) % 64];
+    }
+    BenchmarkUtil::report("SIMD Matrix44 product", timer.elapsed(), ITERATIONS);
+    REQUIRE(simdSum == scalarSum);
+
+    // Matrix inverses
+    scalarSum = mx::Matrix44(0.0f);
+    simdSum = mx::Matrix44(0.0f);
+    timer.reset();
+    for (size_t i = 0; i < ITERATIONS; i++)
+    {
+        scalarSum += referenceInverse(matrices[i % 64]);
+    }
+    BenchmarkUtil::report("Scalar Matrix44 inverse", timer.elapsed(), ITERATIONS);
+    timer.reset();
+    for (size_t i = 0; i < ITERATIONS; i++)
+    {
+        simdSum += matrices[i % 64].getInverse();
+    }
+    BenchmarkUtil::report("SIMD Matrix44 inverse", timer.elapsed(), ITERATIONS);
+    REQUIRE((simdSum / (float) ITERATIONS).isEquivalent(scalarSum / (float) ITERATIONS, EPSILON));
+
+    // Point and normal transforms
+    std::vector<mx::Vector3> points(VECTOR_COUNT);
+    std::uniform_real_distribution<float> valueDist(-1.0f, 1.0f);
+    for (mx::Vector3& point : points)
+    {
+        point = mx::Vector3(valueDist(rng), valueDist(rng), valueDist(rng));
+    }
+    std::vector<mx::Vector3> scalarResults(VECTOR_COUNT);
+    std::vector<mx::Vector3> batchResults(VECTOR_COUNT);
+    const mx::Matrix44& m = matrices[0];
+    timer.reset();
+    for (size_t i = 0; i < VECTOR_COUNT; i++)
+    {
+        mx::Vector4 res = referenceMultiply(m, mx::Vector4(points[i][0], points[i][1], points[i][2], 1.0f));
+        scalarResults[i] = mx::Vector3(res[0], res[1], res[2]);
+    }
+    BenchmarkUtil::report("Scalar point transform", timer.elapsed(), VECTOR_COUNT);
+    timer.reset();
+    m.transformPoints(points[0].data(), batchResults[0].data(), VECTOR_COUNT);
+    BenchmarkUtil::report("SIMD batched point transform", timer.elapsed(), VECTOR_COUNT);
+    REQUIRE(batchResults == scalarResults);
+
+    timer.reset();
+    for (size_t i = 0; i < VECTOR_COUNT; i++)
+    {
+        mx::Matrix44 normalMatrix = referenceInverse(m).getTranspose();
+        mx::Vector4 res = referenceMultiply(normalMatrix, mx::Vector4(points[i][0], points[i][1], points[i][2], 0.0f));
+        scalarResults[i] = mx::Vector3(res[0], res[1], res[2]);
+    }
+    BenchmarkUtil::report("Scalar per-vector normal transform", timer.elapsed(), VECTOR_COUNT);
+    timer.reset();
+    m.transformNormals(points[0].data(), batchResults[0].data(), VECTOR_COUNT);
+    BenchmarkUtil::report("SIMD batched normal transform", timer.elapsed(), VECTOR_COUNT);
+    for (size_t i = 0; i < VECTOR_COUNT; i++)
+    {
+        REQUIRE((batchResults[i] - scalarResults[i]).getMagnitude() < EPSILON);
+    }
+
+    // Vector arithmetic
+    mx::Vector3 accum(0.0f);
+    timer.reset();
+    for (size_t i = 0; i + 1 < VECTOR_COUNT; i++)
+    {
+        accum += (points[i] - points[i + 1]).cross(points[i] * 2.0f) + points[i] / 4.0f;
+    }
+    BenchmarkUtil::report("Vector3 arithmetic", timer.elapsed(), VECTOR_COUNT);
+    REQUIRE(accum.getMagnitude() >= 0.0f);
+}
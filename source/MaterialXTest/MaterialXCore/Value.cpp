@@ -4,12 +4,78 @@
 //
 
 #include <MaterialXTest/Catch/catch.hpp>
+#include <MaterialXTest/BenchmarkUtil.h>
 
 #include <MaterialXCore/Util.h>
 #include <MaterialXCore/Value.h>
 
+#include <cmath>
+#include <limits>
+#include <locale>
+#include <random>
+#include <sstream>
+
 namespace mx = MaterialX;
 
+namespace {
+
+// A numeric punctuation facet with a comma as its decimal point.
+class CommaNumPunct : public std::numpunct<char>
+{
+  protected:
+    char do_decimal_point() const override
+    {
+        return ',';
+    }
+};
+
+// Return the given number as formatted by a stream in the classic locale.
+template <class T> std::string getStreamString(T data, std::ios_base::fmtflags floatField, int precision)
+{
+    std::ostringstream ss;
+    ss.imbue(std::locale::classic());
+    ss.setf(floatField, std::ios_base::floatfield);
+    ss.precision(precision);
+    ss << data;
+    return ss.str();
+}
+
+// Return the given string as parsed by a stream in the classic locale.
+template <class T> T getStreamData(const std::string& str)
+{
+    std::istringstream ss(str);
+    ss.imbue(std::locale::classic());
+    T data{};
+    ss >> data;
+    return data;
+}
+
+template <class T> void benchmarkTypedValue(const std::string& label, const T& data)
+{
+    const size_t ITERATIONS = 100000;
+
+    const std::string valueString = mx::toValueString(data);
+    BenchmarkUtil::Timer timer;
+    size_t matches = 0;
+    for (size_t i = 0; i < ITERATIONS; i++)
+    {
+        matches += mx::fromValueString<T>(valueString) == data;
+    }
+    BenchmarkUtil::report("Parse " + label, timer.elapsed(), ITERATIONS);
+    REQUIRE(matches == ITERATIONS);
+
+    timer.reset();
+    size_t length = 0;
+    for (size_t i = 0; i < ITERATIONS; i++)
+    {
+        length += mx::toValueString(data).size();
+    }
+    BenchmarkUtil::report("Format " + label, timer.elapsed(), ITERATIONS);
+    REQUIRE(length == valueString.size() * ITERATIONS);
+}
+
+} // anonymous namespace
+
 template<class T> void testTypedValue(const T& v1, const T& v2)
 {
     T v0{};
@@ -124,3 +190,142 @@ TEST_CASE("Typed values", "[value]")
     REQUIRE(value->isA<std::string>());
     REQUIRE(value->asA<std::string>() == "text");
 }
+
+TEST_CASE("Value string conversion", "[value]")
+{
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> mantissaDist(-1.0f, 1.0f);
+    std::uniform_int_distribution<int> exponentDist(-12, 12);
+    std::uniform_int_distribution<int> intDist(std::numeric_limits<int>::min(), std::numeric_limits<int>::max());
+
+    // Formatting matches that of a classic stream, in each float format.
+    const std::vector<std::pair<mx::Value::FloatFormat, std::ios_base::fmtflags>> formats =
+    {
+        { mx::Value::FloatFormatDefault, std::ios_base::fmtflags(0) },
+        { mx::Value::FloatFormatFixed, std::ios_base::fixed },
+        { mx::Value::FloatFormatScientific, std::ios_base::scientific }
+    };
+    for (const auto& format : formats)
+    {
+        for (int precision : { 0, 3, 6, 9, 17 })
+        {
+            mx::ScopedFloatFormatting fmt(format.first, precision);
+            for (int i = 0; i < 200; i++)
+            {
+                float f = std::ldexp(mantissaDist(rng), exponentDist(rng) * 3);
+                double d = (double) f * 1.0000001;
+                REQUIRE(mx::toValueString(f) == getStreamString(f, format.second, precision));
+                REQUIRE(mx::toValueString(d) == getStreamString(d, format.second, precision));
+            }
+            REQUIRE(mx::toValueString(1.0e30f) == getStreamString(1.0e30f, format.second, precision));
+            REQUIRE(mx::toValueString(-0.0f) == getStreamString(-0.0f, format.second, precision));
+        }
+    }
+    for (int i = 0; i < 1000; i++)
+    {
+        int value = intDist(rng);
+        REQUIRE(mx::toValueString(value) == std::to_string(value));
+    }
+    REQUIRE(mx::toValueString(std::numeric_limits<int>::min()) == std::to_string(std::numeric_limits<int>::min()));
+    REQUIRE(mx::toValueString(std::numeric_limits<long>::min()) == std::to_string(std::numeric_limits<long>::min()));
+    REQUIRE(mx::toValueString(0) == "0");
+
+    // Parsing matches that of a classic stream, and default formatting at
+    // full precision round trips.
+    {
+        mx::ScopedFloatFormatting fmt(mx::Value::FloatFormatDefault, 9);
+        for (int i = 0; i < 1000; i++)
+        {
+            float f = std::ldexp(mantissaDist(rng), exponentDist(rng) * 3);
+            std::string valueString = mx::toValueString(f);
+            REQUIRE(mx::fromValueString<float>(valueString) == f);
+            REQUIRE(mx::fromValueString<float>(valueString) == getStreamData<float>(valueString));
+            REQUIRE(mx::fromValueString<double>(valueString) == getStreamData<double>(valueString));
+        }
+    }
+    const std::vector<std::string> numberStrings =
+    {
+        "0", "-0", "+1.5", ".5", "5.", "-.25", "  42", "1e3", "1.5E-3", "2.5e+2", "7.0x",
+        "0.1", "0.3", "3.14159265358979323846", "12345678901234567890",
+        "123456789", "16777217", "9007199254740993", "0.000000000000000000000000001", "1.17549435e-38"
+    };
+    for (const std::string& str : numberStrings)
+    {
+        REQUIRE(mx::fromValueString<float>(str) == getStreamData<float>(str));
+        REQUIRE(mx::fromValueString<double>(str) == getStreamData<double>(str));
+    }
+    for (const char* str : { "0", "-7", "+12", "  5", "2147483647", "-2147483648", "3.5", "12abc" })
+    {
+        REQUIRE(mx::fromValueString<int>(str) == getStreamData<int>(str));
+        REQUIRE(mx::fromValueString<long>(str) == getStreamData<long>(str));
+    }
+    // Out-of-range values are rejected or clamped as by a stream.
+    for (const char* str : { "1e-45", "1e39", "1e-400", "1e400" })
+    {
+        bool streamValid = true;
+        float streamData = 0.0f;
+        {
+            std::istringstream ss(str);
+            streamValid = (bool) (ss >> streamData);
+        }
+        if (streamValid)
+        {
+            REQUIRE(mx::fromValueString<float>(str) == streamData);
+        }
+        else
+        {
+            REQUIRE_THROWS_AS(mx::fromValueString<float>(str), mx::ExceptionTypeError&);
+        }
+    }
+    REQUIRE(mx::fromValueString<long>("-9223372036854775808") == std::numeric_limits<long>::min());
+    REQUIRE_THROWS_AS(mx::fromValueString<int>("2147483648"), mx::ExceptionTypeError&);
+    REQUIRE_THROWS_AS(mx::fromValueString<float>("."), mx::ExceptionTypeError&);
+    REQUIRE_THROWS_AS(mx::fromValueString<float>("-"), mx::ExceptionTypeError&);
+    REQUIRE_THROWS_AS(mx::fromValueString<float>("1e"), mx::ExceptionTypeError&);
+    REQUIRE_THROWS_AS(mx::fromValueString<float>("1e+"), mx::ExceptionTypeError&);
+    REQUIRE_THROWS_AS(mx::fromValueString<int>(""), mx::ExceptionTypeError&);
+
+    // Array values are tokenized on any combination of separators.
+    REQUIRE(mx::fromValueString<mx::Vector3>(" 1,2 ,, 3 ") == mx::Vector3(1.0f, 2.0f, 3.0f));
+    REQUIRE(mx::fromValueString<mx::IntVec>("1, 2,3") == mx::IntVec({ 1, 2, 3 }));
+    REQUIRE(mx::fromValueString<mx::BoolVec>("true, false") == mx::BoolVec({ true, false }));
+    REQUIRE(mx::fromValueString<mx::StringVec>("a, b c") == mx::StringVec({ "a", "b", "c" }));
+    REQUIRE(mx::fromValueString<mx::FloatVec>("").empty());
+    mx::Matrix33 matrix(1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f);
+    REQUIRE(mx::fromValueString<mx::Matrix33>(mx::toValueString(matrix)) == matrix);
+    REQUIRE_THROWS_AS(mx::fromValueString<mx::Vector3>("1, 2"), mx::ExceptionTypeError&);
+    REQUIRE_THROWS_AS(mx::fromValueString<mx::Vector3>("1, 2, 3, 4"), mx::ExceptionTypeError&);
+    REQUIRE_THROWS_AS(mx::fromValueString<mx::Matrix33>("1, 2, 3"), mx::ExceptionTypeError&);
+    REQUIRE_THROWS_AS(mx::fromValueString<mx::BoolVec>("true, 1"), mx::ExceptionTypeError&);
+
+    // Conversions are independent of the global locale.
+    std::locale previousLocale = std::locale::global(std::locale(std::locale::classic(), new CommaNumPunct));
+    REQUIRE(mx::toValueString(0.5f) == "0.5");
+    REQUIRE(mx::toValueString(1234567) == "1234567");
+    REQUIRE(mx::fromValueString<float>("0.5") == 0.5f);
+    REQUIRE(mx::fromValueString<double>("3.14159265358979323846") == getStreamData<double>("3.14159265358979323846"));
+    REQUIRE(mx::fromValueString<mx::Vector2>("0.5, 1.5") == mx::Vector2(0.5f, 1.5f));
+    std::locale::global(previousLocale);
+}
+
+TEST_CASE("Value string conversion benchmark", "[value][benchmark]")
+{
+    benchmarkTypedValue("integer", 123456);
+    benchmarkTypedValue("boolean", true);
+    benchmarkTypedValue("float", 0.123456f);
+    benchmarkTypedValue("color2", mx::Color2(0.1f, 0.2f));
+    benchmarkTypedValue("color3", mx::Color3(0.1f, 0.2f, 0.3f));
+    benchmarkTypedValue("color4", mx::Color4(0.1f, 0.2f, 0.3f, 0.4f));
+    benchmarkTypedValue("vector2", mx::Vector2(1.5f, -2.5f));
+    benchmarkTypedValue("vector3", mx::Vector3(1.5f, -2.5f, 3.25f));
+    benchmarkTypedValue("vector4", mx::Vector4(1.5f, -2.5f, 3.25f, 0.125f));
+    benchmarkTypedValue("matrix33", mx::Matrix33(0.5f, 0.0f, 0.0f, 0.0f, 0.5f, 0.0f, 1.0f, 2.0f, 1.0f));
+    benchmarkTypedValue("matrix44", mx::Matrix44::IDENTITY);
+    benchmarkTypedValue("boolean array", mx::BoolVec{ true, false, true, false });
+    benchmarkTypedValue("integer array", mx::IntVec{ 1, -20, 300, -4000, 50000 });
+    benchmarkTypedValue("float array", mx::FloatVec{ 0.1f, 0.25f, -3.5f, 100.0f, 1.0e-4f });
+    benchmarkTypedValue("string array", mx::StringVec{ "one", "two", "three" });
+    benchmarkTypedValue("string", std::string("value"));
+    benchmarkTypedValue("long", 1234567890l);
+    benchmarkTypedValue("double", 0.125);
+}
@@ -0,0 +1,224 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#include <MaterialXTest/Catch/catch.hpp>
+#include <MaterialXTest/BenchmarkUtil.h>
+
+#include <MaterialXFormat/BinaryIo.h>
+#include <MaterialXFormat/File.h>
+#include <MaterialXFormat/XmlIo.h>
+
+#include <cstdio>
+#include <sstream>
+
+namespace mx = MaterialX;
+
+namespace {
+
+// Return all MaterialX files within the given root directory and its
+// subdirectories.
+mx::FilePathVec getDocumentFiles(const mx::FilePath& rootPath)
+{
+    mx::FilePathVec files;
+    for (const mx::FilePath& dir : rootPath.getSubDirectories())
+    {
+        for (const mx::FilePath& filename : dir.getFilesInDirectory(mx::MTLX_EXTENSION))
+        {
+            files.push_back(dir / filename);
+        }
+    }
+    return files;
+}
+
+// Return the keys of the given index entries, in order.
+template <class T> std::vector<std::string> getIndexKeys(const std::vector<std::pair<std::string, T>>& entries)
+{
+    std::vector<std::string> keys;
+    for (const auto& entry : entries)
+    {
+        keys.push_back(entry.first + ":" + entry.second->getNamePath());
+    }
+    return keys;
+}
+
+} // anonymous namespace
+
+TEST_CASE("Binary round trip", "[binaryio]")
+{
+    mx::FilePathVec rootPaths = { "libraries", "resources/Materials/Examples" };
+    for (const mx::FilePath& rootPath : rootPaths)
+    {
+        for (const mx::FilePath& filename : getDocumentFiles(rootPath))
+        {
+            mx::FileSearchPath searchPath(filename.getParentPath());
+            searchPath.append(mx::FilePath("libraries/stdlib"));
+            mx::DocumentPtr xmlDoc = mx::createDocument();
+            mx::readFromXmlFile(xmlDoc, filename, searchPath);
+            std::string binaryString = mx::writeToBinaryString(xmlDoc);
+
+            for (bool readElementIndex : { true, false })
+            {
+                // Binary reads reproduce the content of the original document,
+                // including the source URIs of its elements.
+                mx::BinaryReadOptions readOptions;
+                readOptions.readElementIndex = readElementIndex;
+                mx::DocumentPtr binaryDoc = mx::createDocument();
+                mx::readFromBinaryBuffer(binaryDoc, binaryString.data(), binaryString.size(), &readOptions);
+                REQUIRE(*binaryDoc == *xmlDoc);
+                REQUIRE(mx::writeToXmlString(binaryDoc) == mx::writeToXmlString(xmlDoc));
+                std::vector<mx::ElementPtr> xmlElements, binaryElements;
+                for (mx::ElementPtr elem : xmlDoc->traverseTree())
+                {
+                    xmlElements.push_back(elem);
+                }
+                for (mx::ElementPtr elem : binaryDoc->traverseTree())
+                {
+                    binaryElements.push_back(elem);
+                }
+                REQUIRE(binaryElements.size() == xmlElements.size());
+                for (size_t i = 0; i < xmlElements.size(); i++)
+                {
+                    REQUIRE(binaryElements[i]->getSourceUri() == xmlElements[i]->getSourceUri());
+                }
+
+                // Restored indices match those built by traversal.
+                mx::DocumentIndex xmlIndex = xmlDoc->getElementIndex();
+                mx::DocumentIndex binaryIndex = binaryDoc->getElementIndex();
+                REQUIRE(getIndexKeys(binaryIndex.portElements) == getIndexKeys(xmlIndex.portElements));
+                REQUIRE(getIndexKeys(binaryIndex.nodeDefs) == getIndexKeys(xmlIndex.nodeDefs));
+                REQUIRE(getIndexKeys(binaryIndex.implementations) == getIndexKeys(xmlIndex.implementations));
+                for (mx::NodeDefPtr nodeDef : xmlDoc->getNodeDefs())
+                {
+                    std::vector<mx::NodeDefPtr> xmlMatches = xmlDoc->getMatchingNodeDefs(nodeDef->getNodeString());
+                    std::vector<mx::NodeDefPtr> binaryMatches = binaryDoc->getMatchingNodeDefs(nodeDef->getNodeString());
+                    REQUIRE(binaryMatches.size() == xmlMatches.size());
+                    for (size_t i = 0; i < xmlMatches.size(); i++)
+                    {
+                        REQUIRE(binaryMatches[i]->getNamePath() == xmlMatches[i]->getNamePath());
+                    }
+                }
+            }
+
+            // Binary writes are deterministic.
+            mx::DocumentPtr binaryDoc = mx::createDocument();
+            mx::readFromBinaryBuffer(binaryDoc, binaryString.data(), binaryString.size());
+            REQUIRE(mx::writeToBinaryString(binaryDoc) == binaryString);
+        }
+    }
+
+    // Binary files round trip through the file system.
+    const std::string binaryFilename = "binary_round_trip.mtlxb";
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::readFromXmlFile(doc, "libraries/stdlib/stdlib_defs.mtlx");
+    mx::writeToBinaryFile(doc, binaryFilename);
+    mx::DocumentPtr fileDoc = mx::createDocument();
+    mx::readFromBinaryFile(fileDoc, binaryFilename);
+    REQUIRE(*fileDoc == *doc);
+    std::remove(binaryFilename.c_str());
+
+    // Reads into a document with existing content keep the existing
+    // elements in the lookup cache.
+    mx::DocumentPtr pbrDoc = mx::createDocument();
+    mx::readFromXmlFile(pbrDoc, "libraries/pbrlib/pbrlib_defs.mtlx");
+    std::string pbrString = mx::writeToBinaryString(pbrDoc);
+    mx::DocumentPtr mergedDoc = mx::createDocument();
+    mx::readFromXmlFile(mergedDoc, "libraries/stdlib/stdlib_defs.mtlx");
+    mx::readFromBinaryBuffer(mergedDoc, pbrString.data(), pbrString.size());
+    mx::DocumentPtr referenceDoc = mx::createDocument();
+    mx::readFromXmlFile(referenceDoc, "libraries/stdlib/stdlib_defs.mtlx");
+    mx::readFromXmlFile(referenceDoc, "libraries/pbrlib/pbrlib_defs.mtlx");
+    REQUIRE(*mergedDoc == *referenceDoc);
+    REQUIRE(mergedDoc->getNodeDef("ND_image_color3"));
+    REQUIRE(mergedDoc->getNodeDef("ND_diffuse_brdf"));
+    mx::DocumentIndex mergedIndex = mergedDoc->getElementIndex();
+    mx::DocumentIndex referenceIndex = referenceDoc->getElementIndex();
+    REQUIRE(getIndexKeys(mergedIndex.portElements) == getIndexKeys(referenceIndex.portElements));
+    REQUIRE(getIndexKeys(mergedIndex.nodeDefs) == getIndexKeys(referenceIndex.nodeDefs));
+    REQUIRE(getIndexKeys(mergedIndex.implementations) == getIndexKeys(referenceIndex.implementations));
+
+    // The index of a frozen document cannot be replaced.
+    mergedDoc->freeze();
+    REQUIRE_THROWS_AS(mergedDoc->setElementIndex(referenceIndex), mx::ExceptionFrozenDocument&);
+
+    // Invalid and truncated data is reported as a parse error.
+    std::string binaryString = mx::writeToBinaryString(doc);
+    mx::DocumentPtr errorDoc = mx::createDocument();
+    REQUIRE_THROWS_AS(mx::readFromBinaryBuffer(errorDoc, binaryString.data(), binaryString.size() / 2), mx::ExceptionParseError&);
+    std::string xmlString = mx::writeToXmlString(doc);
+    REQUIRE_THROWS_AS(mx::readFromBinaryBuffer(errorDoc, xmlString.data(), xmlString.size()), mx::ExceptionParseError&);
+    REQUIRE_THROWS_AS(mx::readFromBinaryFile(errorDoc, "NonExistent.mtlxb"), mx::ExceptionFileMissing&);
+}
+
+TEST_CASE("Binary load benchmark", "[binaryio][benchmark]")
+{
+    const size_t ITERATIONS = 10;
+
+    // Gather the XML and binary representations of the full library set.
+    std::vector<std::string> xmlStrings;
+    std::vector<std::string> binaryStrings;
+    size_t xmlSize = 0;
+    size_t binarySize = 0;
+    for (const mx::FilePath& filename : getDocumentFiles("libraries"))
+    {
+        mx::DocumentPtr doc = mx::createDocument();
+        mx::readFromXmlFile(doc, filename);
+        xmlStrings.push_back(mx::writeToXmlString(doc));
+        binaryStrings.push_back(mx::writeToBinaryString(doc));
+        xmlSize += xmlStrings.back().size();
+        binarySize += binaryStrings.back().size();
+    }
+    BenchmarkUtil::reportMemory("Library XML size", xmlSize);
+    BenchmarkUtil::reportMemory("Library binary size", binarySize);
+
+    // Compare load times, including the first indexed lookup.
+    for (int binary = 0; binary < 2; binary++)
+    {
+        const std::string label = binary ? "Binary library load" : "XML library load";
+        BenchmarkUtil::Timer timer;
+        for (size_t i = 0; i < ITERATIONS; i++)
+        {
+            for (size_t j = 0; j < xmlStrings.size(); j++)
+            {
+                mx::DocumentPtr doc = mx::createDocument();
+                if (binary)
+                {
+                    mx::readFromBinaryBuffer(doc, binaryStrings[j].data(), binaryStrings[j].size());
+                }
+                else
+                {
+                    mx::readFromXmlString(doc, xmlStrings[j]);
+                }
+                doc->getMatchingNodeDefs("add");
+            }
+        }
+        BenchmarkUtil::report(label, timer.elapsed(), ITERATIONS);
+    }
+
+    // Compare save times.
+    std::vector<mx::DocumentPtr> docs;
+    for (const std::string& xmlString : xmlStrings)
+    {
+        docs.push_back(mx::createDocument());
+        mx::readFromXmlString(docs.back(), xmlString);
+    }
+    mx::BinaryWriteOptions unindexedOptions;
+    unindexedOptions.writeElementIndex = false;
+    for (int format = 0; format < 3; format++)
+    {
+        const std::string label = format == 2 ? "Binary library save without index" :
+                                  format == 1 ? "Binary library save" : "XML library save";
+        BenchmarkUtil::Timer timer;
+        for (size_t i = 0; i < ITERATIONS; i++)
+        {
+            for (mx::DocumentPtr doc : docs)
+            {
+                std::string output = format == 2 ? mx::writeToBinaryString(doc, &unindexedOptions) :
+                                     format == 1 ? mx::writeToBinaryString(doc) : mx::writeToXmlString(doc);
+                REQUIRE(!output.empty());
+            }
+        }
+        BenchmarkUtil::report(label, timer.elapsed(), ITERATIONS);
+    }
+}
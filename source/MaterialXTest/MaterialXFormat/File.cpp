@@ -4,9 +4,15 @@
 //
 
 #include <MaterialXTest/Catch/catch.hpp>
+#include <MaterialXTest/BenchmarkUtil.h>
 
 #include <MaterialXFormat/File.h>
 
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <thread>
+
 namespace mx = MaterialX;
 
 TEST_CASE("Syntactic operations", "[file]")
@@ -70,3 +76,108 @@ TEST_CASE("File search path operations", "[file]")
         REQUIRE(searchPath.find(filename).exists());
     }
 }
+
+TEST_CASE("File resolution cache", "[file]")
+{
+    const mx::FilePath testDir("resolution_cache_test");
+    const mx::FilePath filename("resolved.mtlx");
+    const mx::FilePath testFile = testDir / filename;
+    testDir.createDirectory();
+    std::remove(testFile.asString().c_str());
+
+    mx::FileSearchPath searchPath("libraries/stdlib");
+    searchPath.append(testDir);
+    mx::FileResolutionCachePtr cache = mx::FileResolutionCache::create();
+    searchPath.setResolutionCache(cache);
+
+    // Negative results are cached, and copies of the search path share the cache.
+    REQUIRE(searchPath.find(filename) == filename);
+    std::ofstream(testFile.asString()) << "<materialx version=\"1.37\" />";
+    mx::FileSearchPath copiedPath(searchPath);
+    copiedPath.append(mx::FilePath("resources"));
+    REQUIRE(searchPath.find(filename) == filename);
+    REQUIRE(cache->getHitCount() == 1);
+    REQUIRE(cache->getMissCount() == 1);
+
+    // Differing path sequences and filenames are cached separately.
+    REQUIRE(copiedPath.find(filename) == testFile);
+    REQUIRE(searchPath.find("stdlib_defs.mtlx").exists());
+    REQUIRE(cache->getEntryCount() == 3);
+
+    // Clearing the cache exposes changes to the file system.
+    cache->clear();
+    REQUIRE(searchPath.find(filename) == testFile);
+    std::remove(testFile.asString().c_str());
+    REQUIRE(searchPath.find(filename) == testFile);
+
+    // Expired entries are resolved again.
+    cache->setTimeToLive(0.05);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    REQUIRE(searchPath.find(filename) == filename);
+    cache->resetCounters();
+    REQUIRE(cache->getHitCount() == 0);
+
+    // Absolute filenames bypass the cache.
+    mx::FilePath absolutePath = mx::FilePath::getCurrentPath() / mx::FilePath("libraries/stdlib/stdlib_defs.mtlx");
+    REQUIRE(searchPath.find(absolutePath) == absolutePath);
+    REQUIRE(cache->getMissCount() == 0);
+
+    // Requests from concurrent threads are consistent.
+    cache->setTimeToLive(0.0);
+    std::vector<std::thread> threads;
+    bool results[4] = { false, false, false, false };
+    for (size_t i = 0; i < 4; i++)
+    {
+        threads.emplace_back([&searchPath, &results, i]()
+        {
+            bool found = true;
+            for (size_t j = 0; j < 1000; j++)
+            {
+                found = found && searchPath.find("stdlib_defs.mtlx").exists();
+            }
+            results[i] = found;
+        });
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    for (bool result : results)
+    {
+        REQUIRE(result);
+    }
+
+    std::remove(testDir.asString().c_str());
+}
+
+TEST_CASE("File resolution cache benchmark", "[file][benchmark]")
+{
+    const size_t ITERATIONS = 20000;
+
+    // Search for files in the last of several library directories.
+    mx::FileSearchPath searchPath;
+    for (const mx::FilePath& dir : mx::FilePath("libraries").getSubDirectories())
+    {
+        searchPath.append(dir);
+    }
+    mx::FilePathVec filenames = { "stdlib_defs.mtlx", "missing_file.mtlx" };
+
+    for (int cached = 0; cached < 2; cached++)
+    {
+        mx::FileSearchPath benchmarkPath(searchPath);
+        if (cached)
+        {
+            benchmarkPath.setResolutionCache(mx::FileResolutionCache::create());
+        }
+        BenchmarkUtil::Timer timer;
+        for (size_t i = 0; i < ITERATIONS; i++)
+        {
+            for (const mx::FilePath& filename : filenames)
+            {
+                benchmarkPath.find(filename);
+            }
+        }
+        BenchmarkUtil::report(std::string(cached ? "Cached" : "Uncached") + " search path resolution, " +
+                              std::to_string(searchPath.size()) + " paths", timer.elapsed(), ITERATIONS);
+    }
+}
@@ -0,0 +1,117 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#include <MaterialXTest/Catch/catch.hpp>
+#include <MaterialXTest/BenchmarkUtil.h>
+
+#include <MaterialXFormat/File.h>
+#include <MaterialXFormat/Util.h>
+
+#include <cstdio>
+#include <fstream>
+
+namespace mx = MaterialX;
+
+TEST_CASE("Parallel library load", "[util]")
+{
+    const mx::StringVec libraryNames = { "stdlib", "pbrlib", "bxdf" };
+    mx::FileSearchPath searchPath(mx::FilePath("libraries"));
+
+    // Parallel loads are identical to serial loads.
+    mx::DocumentPtr serialDoc = mx::createDocument();
+    mx::StringVec serialFiles = mx::loadLibraries(libraryNames, searchPath, serialDoc);
+    REQUIRE(!serialFiles.empty());
+    for (unsigned int threadCount : { 0, 2, 4 })
+    {
+        mx::DocumentPtr parallelDoc = mx::createDocument();
+        mx::StringVec errors;
+        mx::StringVec parallelFiles = mx::loadLibraries(libraryNames, searchPath, parallelDoc, nullptr, threadCount, &errors);
+        REQUIRE(errors.empty());
+        REQUIRE(parallelFiles == serialFiles);
+        REQUIRE(*parallelDoc == *serialDoc);
+        REQUIRE(mx::writeToXmlString(parallelDoc) == mx::writeToXmlString(serialDoc));
+    }
+
+    // Documents are returned in scan order.
+    mx::FilePath rootPath("resources/Materials/TestSuite");
+    mx::XmlReadOptions readOptions;
+    std::vector<mx::DocumentPtr> serialDocs, parallelDocs;
+    mx::StringVec serialPaths, parallelPaths, serialErrors, parallelErrors;
+    mx::loadDocuments(rootPath, searchPath, {}, {}, serialDocs, serialPaths, readOptions, serialErrors);
+    mx::loadDocuments(rootPath, searchPath, {}, {}, parallelDocs, parallelPaths, readOptions, parallelErrors, 4);
+    REQUIRE(!serialDocs.empty());
+    REQUIRE(parallelPaths == serialPaths);
+    REQUIRE(parallelErrors == serialErrors);
+    REQUIRE(parallelDocs.size() == serialDocs.size());
+    for (size_t i = 0; i < serialDocs.size(); i++)
+    {
+        REQUIRE(*parallelDocs[i] == *serialDocs[i]);
+    }
+
+    // Build a library with a file that cannot be parsed.
+    mx::FilePath libraryRoot("parallel_load_test");
+    mx::FilePath libraryDir = libraryRoot / mx::FilePath("testlib");
+    mx::FilePath subDir = libraryDir / mx::FilePath("defs");
+    libraryRoot.createDirectory();
+    libraryDir.createDirectory();
+    subDir.createDirectory();
+    const mx::FilePath validFile = subDir / mx::FilePath("a_valid.mtlx");
+    const mx::FilePath invalidFile = subDir / mx::FilePath("b_invalid.mtlx");
+    const mx::FilePath otherFile = subDir / mx::FilePath("c_valid.mtlx");
+    std::ofstream(validFile.asString()) << "<materialx version=\"1.37\"><nodedef name=\"ND_a\" node=\"a\" /></materialx>";
+    std::ofstream(invalidFile.asString()) << "<materialx version=\"1.37\"><nodedef name=\"ND_b\"></materialx>";
+    std::ofstream(otherFile.asString()) << "<materialx version=\"1.37\"><nodedef name=\"ND_c\" node=\"c\" /></materialx>";
+
+    // Errors are reported per file, and the remaining files are loaded.
+    mx::FileSearchPath librarySearchPath(libraryRoot);
+    for (unsigned int threadCount : { 1, 4 })
+    {
+        mx::DocumentPtr doc = mx::createDocument();
+        mx::StringVec errors;
+        mx::StringVec loaded = mx::loadLibraries({ "testlib" }, librarySearchPath, doc, nullptr, threadCount, &errors);
+        REQUIRE(loaded.size() == 2);
+        REQUIRE(errors.size() == 1);
+        REQUIRE(errors[0].find(invalidFile.asString()) != std::string::npos);
+        REQUIRE(doc->getNodeDef("ND_a"));
+        REQUIRE(doc->getNodeDef("ND_c"));
+    }
+
+    // Without an error vector, the first failure is thrown once all prior
+    // files have been imported, as in a serial load.
+    mx::DocumentPtr serialThrowDoc = mx::createDocument();
+    mx::DocumentPtr parallelThrowDoc = mx::createDocument();
+    REQUIRE_THROWS_AS(mx::loadLibraries({ "testlib" }, librarySearchPath, serialThrowDoc), mx::ExceptionParseError&);
+    REQUIRE_THROWS_AS(mx::loadLibraries({ "testlib" }, librarySearchPath, parallelThrowDoc, nullptr, 4), mx::ExceptionParseError&);
+    REQUIRE(*parallelThrowDoc == *serialThrowDoc);
+
+    std::remove(validFile.asString().c_str());
+    std::remove(invalidFile.asString().c_str());
+    std::remove(otherFile.asString().c_str());
+    std::remove(subDir.asString().c_str());
+    std::remove(libraryDir.asString().c_str());
+    std::remove(libraryRoot.asString().c_str());
+}
+
+TEST_CASE("Parallel library load benchmark", "[util][benchmark]")
+{
+    const mx::StringVec libraryNames = { "stdlib", "pbrlib", "bxdf", "lights" };
+    mx::FileSearchPath searchPath(mx::FilePath("libraries"));
+    mx::FilePath rootPath("resources/Materials/TestSuite");
+    mx::XmlReadOptions readOptions;
+
+    for (unsigned int threadCount : { 1, 2, 4, 8 })
+    {
+        BenchmarkUtil::Timer timer;
+        mx::DocumentPtr doc = mx::createDocument();
+        mx::StringVec errors;
+        mx::loadLibraries(libraryNames, searchPath, doc, nullptr, threadCount, &errors);
+        std::vector<mx::DocumentPtr> documents;
+        mx::StringVec documentPaths;
+        mx::loadDocuments(rootPath, searchPath, {}, {}, documents, documentPaths, readOptions, errors, threadCount);
+        BenchmarkUtil::report("Library and test suite load with " + std::to_string(threadCount) + " threads",
+                              timer.elapsed(), 1);
+        REQUIRE(!documents.empty());
+    }
+}
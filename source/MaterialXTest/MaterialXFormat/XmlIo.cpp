@@ -4,13 +4,46 @@
 //
 
 #include <MaterialXTest/Catch/catch.hpp>
+#include <MaterialXTest/BenchmarkUtil.h>
 
 #include <MaterialXFormat/Environ.h>
 #include <MaterialXFormat/File.h>
+#include <MaterialXFormat/Util.h>
 #include <MaterialXFormat/XmlIo.h>
 
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
 namespace mx = MaterialX;
 
+namespace {
+
+// Write a synthetic document of approximately the given size, containing
+// nodegraphs with chains of nodes.
+void writeSyntheticDocument(const std::string& filename, size_t targetSize, size_t nodesPerGraph = 1000)
+{
+    std::ofstream stream(filename);
+    stream << "<?xml version=\"1.0\"?>\n<materialx version=\"1.37\">\n";
+    size_t graphIndex = 0;
+    while ((size_t) stream.tellp() < targetSize)
+    {
+        stream << "  <nodegraph name=\"graph" << graphIndex++ << "\">\n";
+        for (size_t i = 0; i < nodesPerGraph; i++)
+        {
+            stream << "    <add name=\"add" << i << "\" type=\"color3\">\n";
+            stream << "      <input name=\"in1\" type=\"color3\" value=\"0.1, 0.2, 0.3\" />\n";
+            stream << "      <input name=\"in2\" type=\"color3\" nodename=\"add" << (i ? i - 1 : 0) << "\" />\n";
+            stream << "    </add>\n";
+        }
+        stream << "  </nodegraph>\n";
+    }
+    stream << "</materialx>\n";
+}
+
+} // anonymous namespace
+
 TEST_CASE("Load content", "[xmlio]")
 {
     mx::XmlReadOptions readOptions;
@@ -261,3 +294,832 @@ TEST_CASE("Load content", "[xmlio]")
         REQUIRE(nullptr != parentDoc->getNodeDef("ND_TestMetal"));
     }
 }
+
+TEST_CASE("XInclude cache", "[xmlio]")
+{
+    const std::string libraryFilename = "xinclude_cache_library.mtlx";
+    const std::string assetString =
+        "<?xml version=\"1.0\"?>\n"
+        "<materialx version=\"1.37\" xmlns:xi=\"http://www.w3.org/2001/XInclude\">\n"
+        "  <xi:include href=\"" + libraryFilename + "\" />\n"
+        "  <nodegraph name=\"graph1\" />\n"
+        "</materialx>\n";
+    auto writeLibrary = [&](const std::string& nodeDefName)
+    {
+        std::ofstream stream(libraryFilename);
+        stream << "<?xml version=\"1.0\"?>\n"
+                  "<materialx version=\"1.37\">\n"
+                  "  <nodedef name=\"" << nodeDefName << "\" node=\"custom\">\n"
+                  "    <output name=\"out\" type=\"float\" />\n"
+                  "  </nodedef>\n"
+                  "</materialx>\n";
+    };
+    writeLibrary("ND_custom_float");
+
+    mx::XmlReadOptions readOptions;
+    readOptions.includeCache = mx::XmlIncludeCache::create();
+    mx::XmlReadOptions uncachedOptions;
+
+    // Each unique include is parsed once, and then imported from the cache.
+    mx::DocumentPtr uncachedDoc = mx::createDocument();
+    mx::readFromXmlString(uncachedDoc, assetString, &uncachedOptions);
+    for (int i = 0; i < 4; i++)
+    {
+        mx::DocumentPtr doc = mx::createDocument();
+        mx::readFromXmlString(doc, assetString, &readOptions);
+        REQUIRE(doc->getNodeDef("ND_custom_float"));
+        REQUIRE(*doc == *uncachedDoc);
+    }
+    REQUIRE(readOptions.includeCache->getMissCount() == 1);
+    REQUIRE(readOptions.includeCache->getHitCount() == 3);
+    REQUIRE(readOptions.includeCache->getParsedByteCount() == mx::FilePath(libraryFilename).getFileSize());
+    REQUIRE(readOptions.includeCache->getEntryCount() == 1);
+
+    // Edits to an included file cause it to be parsed again.
+    writeLibrary("ND_custom_float_edited");
+    mx::DocumentPtr editedDoc = mx::createDocument();
+    mx::readFromXmlString(editedDoc, assetString, &readOptions);
+    REQUIRE(editedDoc->getNodeDef("ND_custom_float_edited"));
+    REQUIRE(readOptions.includeCache->getMissCount() == 2);
+
+    // Counters and entries may be reset independently.
+    readOptions.includeCache->resetCounters();
+    REQUIRE(readOptions.includeCache->getHitCount() == 0);
+    REQUIRE(readOptions.includeCache->getParsedByteCount() == 0);
+    readOptions.includeCache->clear();
+    REQUIRE(readOptions.includeCache->getEntryCount() == 0);
+
+    // Edits to a nested include cause the includes that contain it to be
+    // parsed again.
+    const std::string outerFilename = "xinclude_cache_outer.mtlx";
+    {
+        std::ofstream stream(outerFilename);
+        stream << "<?xml version=\"1.0\"?>\n"
+                  "<materialx version=\"1.37\" xmlns:xi=\"http://www.w3.org/2001/XInclude\">\n"
+                  "  <xi:include href=\"" << libraryFilename << "\" />\n"
+                  "</materialx>\n";
+    }
+    const std::string nestedAssetString =
+        "<?xml version=\"1.0\"?>\n"
+        "<materialx version=\"1.37\" xmlns:xi=\"http://www.w3.org/2001/XInclude\">\n"
+        "  <xi:include href=\"" + outerFilename + "\" />\n"
+        "</materialx>\n";
+    mx::DocumentPtr nestedDoc = mx::createDocument();
+    mx::readFromXmlString(nestedDoc, nestedAssetString, &readOptions);
+    REQUIRE(nestedDoc->getNodeDef("ND_custom_float_edited"));
+    nestedDoc = mx::createDocument();
+    mx::readFromXmlString(nestedDoc, nestedAssetString, &readOptions);
+    REQUIRE(nestedDoc->getNodeDef("ND_custom_float_edited"));
+    REQUIRE(readOptions.includeCache->getHitCount() == 1);
+    writeLibrary("ND_custom_float_nested_edit");
+    nestedDoc = mx::createDocument();
+    mx::readFromXmlString(nestedDoc, nestedAssetString, &readOptions);
+    REQUIRE(nestedDoc->getNodeDef("ND_custom_float_nested_edit"));
+    REQUIRE(!nestedDoc->getNodeDef("ND_custom_float_edited"));
+
+    // Includes read by a custom function are not cached.
+    size_t customReadCount = 0;
+    mx::XmlReadOptions customOptions;
+    customOptions.includeCache = mx::XmlIncludeCache::create();
+    customOptions.readXIncludeFunction = [&customReadCount](mx::DocumentPtr doc, const mx::FilePath& filename,
+                                                            const mx::FileSearchPath& searchPath, const mx::XmlReadOptions* options)
+    {
+        customReadCount++;
+        mx::readFromXmlFile(doc, filename, searchPath, options);
+    };
+    for (int i = 0; i < 2; i++)
+    {
+        mx::DocumentPtr doc = mx::createDocument();
+        mx::readFromXmlString(doc, assetString, &customOptions);
+        REQUIRE(doc->getNodeDef("ND_custom_float_nested_edit"));
+    }
+    REQUIRE(customReadCount == 2);
+    REQUIRE(customOptions.includeCache->getHitCount() == 0);
+    REQUIRE(customOptions.includeCache->getEntryCount() == 0);
+
+    std::remove(outerFilename.c_str());
+    std::remove(libraryFilename.c_str());
+}
+
+TEST_CASE("Memory-mapped load", "[xmlio]")
+{
+    mx::XmlReadOptions readOptions;
+    mx::XmlReadOptions mappedOptions;
+    mappedOptions.memoryMapFiles = true;
+
+    // Memory-mapped reads produce the same content as standard reads.
+    mx::FilePathVec rootPaths = { "libraries/stdlib", "resources/Materials/Examples/Syntax" };
+    for (const mx::FilePath& rootPath : rootPaths)
+    {
+        mx::FileSearchPath searchPath(rootPath);
+        for (const mx::FilePath& filename : rootPath.getFilesInDirectory(mx::MTLX_EXTENSION))
+        {
+            mx::DocumentPtr doc = mx::createDocument();
+            mx::readFromXmlFile(doc, filename, searchPath, &readOptions);
+            mx::DocumentPtr mappedDoc = mx::createDocument();
+            mx::readFromXmlFile(mappedDoc, filename, searchPath, &mappedOptions);
+            REQUIRE(*mappedDoc == *doc);
+        }
+    }
+
+    // Missing files are reported in the standard way.
+    mx::DocumentPtr doc = mx::createDocument();
+    REQUIRE_THROWS_AS(mx::readFromXmlFile(doc, "NonExistent.mtlx", mx::FileSearchPath(), &mappedOptions), mx::ExceptionFileMissing&);
+}
+
+TEST_CASE("Parallel element construction", "[xmlio]")
+{
+    mx::XmlReadOptions readOptions;
+    readOptions.skipConflictingElements = true;
+    mx::XmlReadOptions parallelOptions = readOptions;
+    parallelOptions.buildThreadCount = 4;
+
+    // Documents constructed in parallel are identical to those constructed
+    // on a single thread.
+    mx::FilePathVec rootPaths = { "libraries/stdlib", "libraries/pbrlib", "resources/Materials/Examples/Syntax" };
+    for (const mx::FilePath& rootPath : rootPaths)
+    {
+        mx::FileSearchPath searchPath(rootPath);
+        for (const mx::FilePath& filename : rootPath.getFilesInDirectory(mx::MTLX_EXTENSION))
+        {
+            mx::DocumentPtr doc = mx::createDocument();
+            mx::readFromXmlFile(doc, filename, searchPath, &readOptions);
+            for (bool useArena : { false, true })
+            {
+                mx::DocumentPtr parallelDoc = mx::createDocument(useArena);
+                mx::readFromXmlFile(parallelDoc, filename, searchPath, &parallelOptions);
+                REQUIRE(*parallelDoc == *doc);
+                REQUIRE(mx::writeToXmlString(parallelDoc) == mx::writeToXmlString(doc));
+            }
+        }
+    }
+
+    // Conflicting elements are reported as on a single thread.
+    const std::string conflictString =
+        "<?xml version=\"1.0\"?>\n"
+        "<materialx version=\"1.37\">\n"
+        "  <nodegraph name=\"graph1\"><add name=\"add1\" type=\"float\" /></nodegraph>\n"
+        "  <nodegraph name=\"graph1\"><add name=\"add2\" type=\"float\" /></nodegraph>\n"
+        "</materialx>\n";
+    mx::XmlReadOptions strictOptions;
+    strictOptions.buildThreadCount = 4;
+    mx::DocumentPtr conflictDoc = mx::createDocument();
+    REQUIRE_THROWS_AS(mx::readFromXmlString(conflictDoc, conflictString, &strictOptions), mx::Exception&);
+}
+
+TEST_CASE("Streaming read", "[xmlio]")
+{
+    // A handler that records the element events of a streaming read.
+    class EventRecorder : public mx::XmlStreamHandler
+    {
+      public:
+        void beginElement(const std::string& category, const mx::XmlAttributeVec& attributes) override
+        {
+            events.push_back("begin " + category);
+            for (const auto& attr : attributes)
+            {
+                events.push_back(attr.first + "=" + attr.second);
+            }
+            depth++;
+            maxDepth = std::max(depth, maxDepth);
+            elementCount++;
+        }
+        void endElement(const std::string& category) override
+        {
+            events.push_back("end " + category);
+            depth--;
+        }
+
+        std::vector<std::string> events;
+        size_t depth = 0;
+        size_t maxDepth = 0;
+        size_t elementCount = 0;
+    };
+
+    // Element events are issued in document order, with entity references
+    // resolved and markup other than elements skipped.
+    const std::string eventString =
+        "<?xml version=\"1.0\"?>\n"
+        "<!-- comment <nodedef> -->\n"
+        "<materialx version=\"1.37\">\n"
+        "  <nodedef name=\"ND_a&amp;b&#65;&#x42;\" doc='&lt;&quot;&gt;'><![CDATA[<ignored/>]]>\n"
+        "    <output name=\"out\" type=\"float\"/>\n"
+        "  </nodedef>\n"
+        "</materialx>\n";
+    EventRecorder recorder;
+    std::istringstream eventStream(eventString);
+    mx::streamFromXmlStream(eventStream, recorder);
+    std::vector<std::string> expectedEvents =
+    {
+        "begin materialx", "version=1.37",
+        "begin nodedef", "name=ND_a&bAB", "doc=<\">",
+        "begin output", "name=out", "type=float", "end output",
+        "end nodedef",
+        "end materialx"
+    };
+    REQUIRE(recorder.events == expectedEvents);
+    REQUIRE(recorder.maxDepth == 3);
+
+    // Malformed content is reported as a parse error.
+    EventRecorder errorRecorder;
+    std::istringstream errorStream("<materialx><nodedef></materialx>");
+    REQUIRE_THROWS_AS(mx::streamFromXmlStream(errorStream, errorRecorder), mx::ExceptionParseError&);
+    const std::vector<std::string> malformedStrings =
+    {
+        "<materialx name=\"a&#0;b\"/>",
+        "<materialx name=\"&#xD800;\"/>",
+        "<materialx name=\"&#x110000;\"/>",
+        "<materialx name=\"&#x;\"/>",
+        "<materialx name=\"&#12a;\"/>",
+        "<materialx><1nodedef/></materialx>",
+        "<materialx><node\"def/></materialx>",
+        "<materialx na<me=\"a\"/>",
+        "<materialx =\"a\"/>"
+    };
+    for (const std::string& malformedString : malformedStrings)
+    {
+        std::istringstream malformedStream(malformedString);
+        REQUIRE_THROWS_AS(mx::streamFromXmlStream(malformedStream, errorRecorder), mx::ExceptionParseError&);
+    }
+
+    // Markup characters within quoted literals do not end a document type
+    // declaration, and valid character references are encoded as UTF-8.
+    EventRecorder doctypeRecorder;
+    std::istringstream doctypeStream("<!DOCTYPE materialx SYSTEM \"a>b\" [<!ENTITY e '<nodedef/>'>]>"
+                                     "<materialx name=\"&#xE9;&#x1F600;\"/>");
+    mx::streamFromXmlStream(doctypeStream, doctypeRecorder);
+    REQUIRE(doctypeRecorder.events == std::vector<std::string>({ "begin materialx", "name=\xC3\xA9\xF0\x9F\x98\x80", "end materialx" }));
+    REQUIRE_THROWS_AS(mx::streamFromXmlFile("NonExistent.mtlx", errorRecorder), mx::ExceptionFileMissing&);
+
+    // Streaming reads with a permissive predicate produce the same content
+    // as standard reads, including the elements of XInclude references.
+    mx::XmlReadOptions readOptions;
+    readOptions.skipConflictingElements = true;
+    mx::XmlReadOptions streamOptions = readOptions;
+    streamOptions.elementPredicate = [](mx::ConstElementPtr) { return true; };
+    mx::FilePathVec rootPaths = { "libraries/stdlib", "libraries/pbrlib", "resources/Materials/Examples/Syntax" };
+    for (const mx::FilePath& rootPath : rootPaths)
+    {
+        mx::FileSearchPath searchPath(rootPath);
+        for (const mx::FilePath& filename : rootPath.getFilesInDirectory(mx::MTLX_EXTENSION))
+        {
+            mx::DocumentPtr doc = mx::createDocument();
+            mx::readFromXmlFile(doc, filename, searchPath, &readOptions);
+            mx::DocumentPtr streamDoc = mx::createDocument();
+            mx::readFromXmlFile(streamDoc, filename, searchPath, &streamOptions);
+            REQUIRE(*streamDoc == *doc);
+            REQUIRE(mx::writeToXmlString(streamDoc) == mx::writeToXmlString(doc));
+
+            // Each element of the file is reported as an event.
+            EventRecorder fileRecorder;
+            mx::streamFromXmlFile(filename, fileRecorder, searchPath);
+            REQUIRE(fileRecorder.elementCount > 0);
+            REQUIRE(fileRecorder.depth == 0);
+        }
+    }
+
+    // Includes that follow local elements take precedence over them, and
+    // are ordered ahead of them, as in a standard read.
+    const std::string includeFilename = "streaming_read_include.mtlx";
+    std::ofstream(includeFilename) <<
+        "<materialx version=\"1.37\">\n"
+        "  <nodedef name=\"ND_a\" node=\"a\"><output name=\"out\" type=\"float\"/></nodedef>\n"
+        "  <nodedef name=\"ND_b\" node=\"b\"><output name=\"out\" type=\"float\"/></nodedef>\n"
+        "</materialx>\n";
+    const std::string includeString =
+        "<materialx version=\"1.37\" xmlns:xi=\"http://www.w3.org/2001/XInclude\">\n"
+        "  <nodedef name=\"ND_b\" node=\"b\"><output name=\"out\" type=\"color3\"/></nodedef>\n"
+        "  <nodegraph name=\"graph1\"/>\n"
+        "  <xi:include href=\"" + includeFilename + "\"/>\n"
+        "  <nodegraph name=\"graph2\"/>\n"
+        "</materialx>\n";
+    mx::DocumentPtr includeDoc = mx::createDocument();
+    mx::readFromXmlString(includeDoc, includeString, &readOptions);
+    mx::DocumentPtr streamIncludeDoc = mx::createDocument();
+    mx::readFromXmlString(streamIncludeDoc, includeString, &streamOptions);
+    REQUIRE(*streamIncludeDoc == *includeDoc);
+    REQUIRE(mx::writeToXmlString(streamIncludeDoc) == mx::writeToXmlString(includeDoc));
+    REQUIRE(streamIncludeDoc->getNodeDef("ND_b")->getOutput("out")->getType() == "float");
+    REQUIRE(streamIncludeDoc->getChildIndex("ND_b") == 1);
+    mx::XmlReadOptions strictStreamOptions;
+    strictStreamOptions.elementPredicate = streamOptions.elementPredicate;
+    mx::DocumentPtr conflictDoc = mx::createDocument();
+    REQUIRE_THROWS_AS(mx::readFromXmlString(conflictDoc, includeString), mx::Exception&);
+    mx::DocumentPtr streamConflictDoc = mx::createDocument();
+    REQUIRE_THROWS_AS(mx::readFromXmlString(streamConflictDoc, includeString, &strictStreamOptions), mx::Exception&);
+    std::remove(includeFilename.c_str());
+
+    // Predicates materialize only the matching subtrees of a document.
+    mx::FilePath stdlibDefs("libraries/stdlib/stdlib_defs.mtlx");
+    mx::DocumentPtr fullDoc = mx::createDocument();
+    mx::readFromXmlFile(fullDoc, stdlibDefs, mx::FileSearchPath(), &readOptions);
+    mx::XmlReadOptions nodeDefOptions;
+    nodeDefOptions.elementPredicate = [](mx::ConstElementPtr elem)
+    {
+        return !elem->getParent()->isA<mx::Document>() || elem->isA<mx::NodeDef>();
+    };
+    mx::DocumentPtr nodeDefDoc = mx::createDocument();
+    mx::readFromXmlFile(nodeDefDoc, stdlibDefs, mx::FileSearchPath(), &nodeDefOptions);
+    REQUIRE(!nodeDefDoc->getNodeDefs().empty());
+    REQUIRE(nodeDefDoc->getChildren().size() == nodeDefDoc->getNodeDefs().size());
+    REQUIRE(nodeDefDoc->getNodeDefs().size() == fullDoc->getNodeDefs().size());
+    for (mx::NodeDefPtr nodeDef : nodeDefDoc->getNodeDefs())
+    {
+        REQUIRE(*nodeDef == *fullDoc->getNodeDef(nodeDef->getName()));
+    }
+}
+
+TEST_CASE("Streaming write", "[xmlio]")
+{
+    // Written documents use the layout of the synthetic document writer.
+    const std::string filename = "streaming_write.mtlx";
+    writeSyntheticDocument(filename, 64 * 1024, 10);
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::readFromXmlFile(doc, filename);
+    REQUIRE(mx::writeToXmlString(doc) == mx::readFile(filename));
+    std::remove(filename.c_str());
+
+    // Attribute values are escaped, with angle brackets preserved.
+    doc = mx::createDocument();
+    mx::ElementPtr elem = doc->addChildOfCategory("custom", "custom1");
+    elem->setAttribute("text", "a&b<c>\"d\"\te\nf");
+    elem->setAttribute("empty", mx::EMPTY_STRING);
+    mx::NodeGraphPtr nodeGraph = doc->addNodeGraph("graph1");
+    nodeGraph->addNode("add", "add1", "float")->setSourceUri("include1.mtlx");
+    nodeGraph->addNode("add", "add2", "float")->setSourceUri("include1.mtlx");
+    nodeGraph->addNode("add", "add3", "float");
+    doc->addLook("look1");
+    std::string version = doc->getVersionString();
+    REQUIRE(mx::writeToXmlString(doc) ==
+        "<?xml version=\"1.0\"?>\n"
+        "<materialx version=\"" + version + "\">\n"
+        "  <custom name=\"custom1\" text=\"a&amp;b<c>&quot;d&quot;\te&#10;f\" empty=\"\" />\n"
+        "  <nodegraph name=\"graph1\" xmlns:xi=\"http://www.w3.org/2001/XInclude\">\n"
+        "    <xi:include href=\"include1.mtlx\" />\n"
+        "    <add name=\"add3\" type=\"float\" />\n"
+        "  </nodegraph>\n"
+        "  <look name=\"look1\" />\n"
+        "</materialx>\n");
+
+    // Elements rejected by the predicate are omitted, along with their
+    // XInclude references.
+    mx::XmlWriteOptions writeOptions;
+    writeOptions.elementPredicate = [](mx::ConstElementPtr elem)
+    {
+        return elem->getName() != "add1" && elem->getName() != "add2" && elem->getName() != "add3";
+    };
+    REQUIRE(mx::writeToXmlString(doc, &writeOptions) ==
+        "<?xml version=\"1.0\"?>\n"
+        "<materialx version=\"" + version + "\">\n"
+        "  <custom name=\"custom1\" text=\"a&amp;b<c>&quot;d&quot;\te&#10;f\" empty=\"\" />\n"
+        "  <nodegraph name=\"graph1\" />\n"
+        "  <look name=\"look1\" />\n"
+        "</materialx>\n");
+}
+
+TEST_CASE("Read stats", "[xmlio]")
+{
+    const std::string libraryFilename = "read_stats_library.mtlx";
+    const std::string assetFilename = "read_stats_asset.mtlx";
+    {
+        std::ofstream stream(libraryFilename);
+        stream << "<?xml version=\"1.0\"?>\n"
+                  "<materialx version=\"1.37\">\n"
+                  "  <nodedef name=\"ND_custom_float\" node=\"custom\">\n"
+                  "    <output name=\"out\" type=\"float\" />\n"
+                  "  </nodedef>\n"
+                  "</materialx>\n";
+    }
+    const std::string assetString =
+        "<?xml version=\"1.0\"?>\n"
+        "<materialx version=\"1.37\" xmlns:xi=\"http://www.w3.org/2001/XInclude\">\n"
+        "  <xi:include href=\"" + libraryFilename + "\" />\n"
+        "  <nodegraph name=\"graph1\">\n"
+        "    <add name=\"add1\" type=\"float\">\n"
+        "      <input name=\"in1\" type=\"float\" value=\"1.0\" />\n"
+        "    </add>\n"
+        "  </nodegraph>\n"
+        "  <nodegraph name=\"graph1\">\n"
+        "    <add name=\"add1\" type=\"float\">\n"
+        "      <input name=\"in1\" type=\"float\" value=\"1.0\" />\n"
+        "    </add>\n"
+        "  </nodegraph>\n"
+        "</materialx>\n";
+    std::ofstream(assetFilename) << assetString;
+
+    // Each supported reader records the same counts, along with the tree of
+    // followed includes.
+    mx::XmlReadOptions domOptions;
+    mx::XmlReadOptions mappedOptions;
+    mappedOptions.memoryMapFiles = true;
+    mx::XmlReadOptions parallelOptions;
+    parallelOptions.buildThreadCount = 4;
+    mx::XmlReadOptions streamingOptions;
+    streamingOptions.elementPredicate = [](mx::ConstElementPtr) { return true; };
+    for (mx::XmlReadOptions* readOptions : { &domOptions, &mappedOptions, &parallelOptions, &streamingOptions })
+    {
+        readOptions->readStats = mx::XmlReadStats::create();
+        mx::DocumentPtr doc = mx::createDocument();
+        mx::readFromXmlFile(doc, assetFilename, mx::FileSearchPath(), readOptions);
+        REQUIRE(doc->getNodeDef("ND_custom_float"));
+
+        mx::XmlReadStatsPtr stats = readOptions->readStats;
+        REQUIRE(stats->getSource() == mx::FilePath(assetFilename).asString());
+        REQUIRE(stats->getByteCount() == assetString.size());
+        REQUIRE(stats->getElementCount() == 6);
+        REQUIRE(stats->getAttributeCount() == 8);
+        for (int phase = 0; phase < mx::XmlReadStats::PhaseCount; phase++)
+        {
+            REQUIRE(stats->getPhaseTime((mx::XmlReadStats::Phase) phase) >= 0.0);
+        }
+        REQUIRE(stats->getTotalTime() >= stats->getPhaseTime(mx::XmlReadStats::PhaseXInclude));
+
+        std::vector<mx::XmlReadStatsPtr> includes = stats->getIncludes();
+        REQUIRE(includes.size() == 1);
+        REQUIRE(includes[0]->getSource() == mx::FilePath(libraryFilename).asString());
+        REQUIRE(includes[0]->getByteCount() == mx::FilePath(libraryFilename).getFileSize());
+        REQUIRE(includes[0]->getElementCount() == 2);
+        REQUIRE(includes[0]->getIncludes().empty());
+        REQUIRE(stats->getPhaseTime(mx::XmlReadStats::PhaseXInclude) >= includes[0]->getTotalTime());
+    }
+
+    // The byte counts of string reads match the size of the string.
+    mx::XmlReadOptions stringOptions;
+    stringOptions.readStats = mx::XmlReadStats::create("string");
+    mx::DocumentPtr stringDoc = mx::createDocument();
+    mx::readFromXmlString(stringDoc, assetString, &stringOptions);
+    REQUIRE(stringOptions.readStats->getSource() == "string");
+    REQUIRE(stringOptions.readStats->getByteCount() == assetString.size());
+    REQUIRE(stringOptions.readStats->getElementCount() == 6);
+
+    // Stats may be written as JSON, including special characters in sources.
+    mx::XmlReadStatsPtr stats = domOptions.readStats;
+    stats->getIncludes()[0]->setSource("quote\"tab\t");
+    std::string json = stats->toJson();
+    REQUIRE(json.find("\"elementCount\": 6") != std::string::npos);
+    REQUIRE(json.find("\"byteCount\": " + std::to_string(assetString.size())) != std::string::npos);
+    REQUIRE(json.find("\"quote\\\"tab\\u0009\"") != std::string::npos);
+    for (int phase = 0; phase < mx::XmlReadStats::PhaseCount; phase++)
+    {
+        REQUIRE(json.find("\"" + mx::XmlReadStats::getPhaseName((mx::XmlReadStats::Phase) phase) + "\": ") != std::string::npos);
+    }
+    REQUIRE(std::count(json.begin(), json.end(), '{') == std::count(json.begin(), json.end(), '}'));
+    REQUIRE(std::count(json.begin(), json.end(), '[') == std::count(json.begin(), json.end(), ']'));
+    REQUIRE_THROWS_AS(mx::XmlReadStats::getPhaseName(mx::XmlReadStats::PhaseCount), mx::Exception&);
+
+    // Stats accumulate across reads until cleared.
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::readFromXmlFile(doc, assetFilename, mx::FileSearchPath(), &domOptions);
+    REQUIRE(stats->getElementCount() == 12);
+    REQUIRE(stats->getIncludes().size() == 2);
+    stats->clear();
+    REQUIRE(stats->getElementCount() == 0);
+    REQUIRE(stats->getByteCount() == 0);
+    REQUIRE(stats->getTotalTime() == 0.0);
+    REQUIRE(stats->getIncludes().empty());
+
+    std::remove(libraryFilename.c_str());
+    std::remove(assetFilename.c_str());
+}
+
+TEST_CASE("Load content memory benchmark", "[xmlio][benchmark]")
+{
+    const size_t COPY_COUNT = 4;
+
+    mx::XmlReadOptions readOptions;
+    readOptions.skipConflictingElements = true;
+    mx::FilePathVec rootPaths = { "libraries", "resources/Materials" };
+
+    // Gather all documents beneath the given root paths.
+    mx::FilePathVec filenames;
+    for (const mx::FilePath& rootPath : rootPaths)
+    {
+        for (const mx::FilePath& dir : rootPath.getSubDirectories())
+        {
+            for (const mx::FilePath& filename : dir.getFilesInDirectory(mx::MTLX_EXTENSION))
+            {
+                filenames.push_back(dir / filename);
+            }
+        }
+    }
+    REQUIRE(!filenames.empty());
+
+    // Read several copies of each document, measuring the growth in
+    // resident memory.
+    std::vector<mx::DocumentPtr> docs;
+    size_t elementCount = 0;
+    size_t startMemory = BenchmarkUtil::getResidentMemory();
+    for (size_t i = 0; i < COPY_COUNT; i++)
+    {
+        for (const mx::FilePath& filename : filenames)
+        {
+            mx::DocumentPtr doc = mx::createDocument();
+            try
+            {
+                mx::readFromXmlFile(doc, filename, mx::FileSearchPath(filename.getParentPath()), &readOptions);
+            }
+            catch (mx::Exception&)
+            {
+                continue;
+            }
+            for (mx::ElementPtr elem : doc->traverseTree())
+            {
+                elementCount++;
+            }
+            docs.push_back(doc);
+        }
+    }
+    size_t endMemory = BenchmarkUtil::getResidentMemory();
+    REQUIRE(elementCount > 0);
+
+    if (endMemory > startMemory)
+    {
+        BenchmarkUtil::reportMemory("Load content memory", endMemory - startMemory, elementCount);
+    }
+}
+
+TEST_CASE("Load content arena benchmark", "[xmlio][benchmark]")
+{
+    const size_t ROUND_COUNT = 3;
+
+    mx::XmlReadOptions readOptions;
+    readOptions.skipConflictingElements = true;
+    mx::FilePath rootPath("resources/Materials/TestSuite");
+
+    mx::FilePathVec filenames;
+    for (const mx::FilePath& dir : rootPath.getSubDirectories())
+    {
+        for (const mx::FilePath& filename : dir.getFilesInDirectory(mx::MTLX_EXTENSION))
+        {
+            filenames.push_back(dir / filename);
+        }
+    }
+    REQUIRE(!filenames.empty());
+
+    // Load and release all documents, with and without an allocation arena.
+    for (bool useArena : { false, true })
+    {
+        double loadTime = 0.0;
+        double releaseTime = 0.0;
+        for (size_t i = 0; i < ROUND_COUNT; i++)
+        {
+            BenchmarkUtil::Timer timer;
+            std::vector<mx::DocumentPtr> docs;
+            for (const mx::FilePath& filename : filenames)
+            {
+                mx::DocumentPtr doc = mx::createDocument(useArena);
+                try
+                {
+                    mx::readFromXmlFile(doc, filename, mx::FileSearchPath(filename.getParentPath()), &readOptions);
+                }
+                catch (mx::Exception&)
+                {
+                    continue;
+                }
+                docs.push_back(doc);
+            }
+            loadTime += timer.elapsed();
+
+            // Verify that arena documents match their default counterparts.
+            if (useArena && i == 0)
+            {
+                for (mx::DocumentPtr doc : docs)
+                {
+                    mx::DocumentPtr defaultDoc = mx::createDocument();
+                    mx::readFromXmlFile(defaultDoc, doc->getSourceUri(), mx::FileSearchPath(mx::FilePath(doc->getSourceUri()).getParentPath()), &readOptions);
+                    REQUIRE(*defaultDoc == *doc);
+                }
+            }
+
+            timer.reset();
+            docs.clear();
+            releaseTime += timer.elapsed();
+        }
+        std::string label = useArena ? "arena" : "default";
+        BenchmarkUtil::report("TestSuite load (" + label + ")", loadTime, ROUND_COUNT);
+        BenchmarkUtil::report("TestSuite release (" + label + ")", releaseTime, ROUND_COUNT);
+    }
+}
+
+TEST_CASE("XInclude cache benchmark", "[xmlio][benchmark]")
+{
+    const size_t DOCUMENT_COUNT = 100;
+    const std::string assetString =
+        "<?xml version=\"1.0\"?>\n"
+        "<materialx version=\"1.37\" xmlns:xi=\"http://www.w3.org/2001/XInclude\">\n"
+        "  <xi:include href=\"libraries/stdlib/stdlib_defs.mtlx\" />\n"
+        "  <xi:include href=\"libraries/pbrlib/pbrlib_defs.mtlx\" />\n"
+        "</materialx>\n";
+
+    mx::XmlReadOptions uncachedOptions;
+    mx::XmlReadOptions cachedOptions;
+    cachedOptions.includeCache = mx::XmlIncludeCache::create();
+    for (const mx::XmlReadOptions* readOptions : { &uncachedOptions, &cachedOptions })
+    {
+        BenchmarkUtil::Timer timer;
+        for (size_t i = 0; i < DOCUMENT_COUNT; i++)
+        {
+            mx::DocumentPtr doc = mx::createDocument();
+            mx::readFromXmlString(doc, assetString, readOptions);
+            REQUIRE(doc->getNodeDef("ND_image_color3"));
+        }
+        BenchmarkUtil::report(readOptions->includeCache ? "XInclude read with cache" : "XInclude read without cache",
+                              timer.elapsed(), DOCUMENT_COUNT);
+    }
+
+    mx::XmlIncludeCachePtr cache = cachedOptions.includeCache;
+    std::cout << "XInclude cache: " << cache->getHitCount() << " hits, " << cache->getMissCount() << " misses, " <<
+                 cache->getParsedByteCount() << " bytes parsed" << std::endl;
+    REQUIRE(cache->getMissCount() == 2);
+    REQUIRE(cache->getHitCount() == 2 * (DOCUMENT_COUNT - 1));
+}
+
+TEST_CASE("Memory-mapped load benchmark", "[xmlio][benchmark]")
+{
+    const size_t TARGET_FILE_SIZE = 16 * 1024 * 1024;
+    const std::string filename = "memory_mapped_benchmark.mtlx";
+
+    writeSyntheticDocument(filename, TARGET_FILE_SIZE);
+    size_t fileSize = mx::FilePath(filename).getFileSize();
+    BenchmarkUtil::reportMemory("Synthetic document size", fileSize);
+
+    mx::XmlReadOptions standardOptions;
+    mx::XmlReadOptions mappedOptions;
+    mappedOptions.memoryMapFiles = true;
+    size_t elementCounts[2] = { 0, 0 };
+    for (int mapped = 0; mapped < 2; mapped++)
+    {
+        const std::string label = mapped ? "Memory-mapped load" : "Standard load";
+        BenchmarkUtil::resetPeakResidentMemory();
+        size_t startMemory = BenchmarkUtil::getResidentMemory();
+        BenchmarkUtil::Timer timer;
+        mx::DocumentPtr doc = mx::createDocument();
+        mx::readFromXmlFile(doc, filename, mx::FileSearchPath(), mapped ? &mappedOptions : &standardOptions);
+        BenchmarkUtil::report(label, timer.elapsed());
+        size_t peakMemory = BenchmarkUtil::getPeakResidentMemory();
+        if (peakMemory > startMemory)
+        {
+            BenchmarkUtil::reportMemory(label + " peak memory", peakMemory - startMemory);
+        }
+        for (mx::ElementPtr elem : doc->traverseTree())
+        {
+            elementCounts[mapped]++;
+        }
+    }
+    REQUIRE(elementCounts[0] == elementCounts[1]);
+
+    std::remove(filename.c_str());
+}
+
+TEST_CASE("Parallel element construction benchmark", "[xmlio][benchmark]")
+{
+    const size_t TARGET_FILE_SIZE = 8 * 1024 * 1024;
+    const std::string filename = "parallel_construction_benchmark.mtlx";
+    writeSyntheticDocument(filename, TARGET_FILE_SIZE, 100);
+
+    std::string serialString;
+    for (unsigned int threadCount : { 1, 2, 4, 8 })
+    {
+        mx::XmlReadOptions readOptions;
+        readOptions.buildThreadCount = threadCount;
+        BenchmarkUtil::Timer timer;
+        mx::DocumentPtr doc = mx::createDocument();
+        mx::readFromXmlFile(doc, filename, mx::FileSearchPath(), &readOptions);
+        BenchmarkUtil::report("Element construction with " + std::to_string(threadCount) + " threads", timer.elapsed());
+
+        std::string docString = mx::writeToXmlString(doc);
+        if (serialString.empty())
+        {
+            serialString = docString;
+        }
+        REQUIRE(docString == serialString);
+    }
+
+    std::remove(filename.c_str());
+}
+
+TEST_CASE("Streaming read benchmark", "[xmlio][benchmark]")
+{
+    const size_t TARGET_FILE_SIZE = 16 * 1024 * 1024;
+    const std::string filename = "streaming_read_benchmark.mtlx";
+
+    writeSyntheticDocument(filename, TARGET_FILE_SIZE);
+    size_t fileSize = mx::FilePath(filename).getFileSize();
+    BenchmarkUtil::reportMemory("Synthetic document size", fileSize);
+
+    // Compare a full read with a filtered read of a single nodegraph.
+    mx::XmlReadOptions standardOptions;
+    mx::XmlReadOptions filteredOptions;
+    filteredOptions.elementPredicate = [](mx::ConstElementPtr elem)
+    {
+        return !elem->getParent()->isA<mx::Document>() || elem->getName() == "graph0";
+    };
+    mx::ElementPtr graphs[2];
+    for (int filtered = 0; filtered < 2; filtered++)
+    {
+        const std::string label = filtered ? "Filtered streaming read" : "Standard read";
+        BenchmarkUtil::resetPeakResidentMemory();
+        size_t startMemory = BenchmarkUtil::getResidentMemory();
+        BenchmarkUtil::Timer timer;
+        mx::DocumentPtr doc = mx::createDocument();
+        mx::readFromXmlFile(doc, filename, mx::FileSearchPath(), filtered ? &filteredOptions : &standardOptions);
+        BenchmarkUtil::report(label, timer.elapsed());
+        size_t peakMemory = BenchmarkUtil::getPeakResidentMemory();
+        if (peakMemory > startMemory)
+        {
+            BenchmarkUtil::reportMemory(label + " peak memory", peakMemory - startMemory);
+        }
+        graphs[filtered] = doc->getNodeGraph("graph0");
+        REQUIRE(graphs[filtered]);
+        if (filtered)
+        {
+            REQUIRE(doc->getChildren().size() == 1);
+        }
+    }
+    REQUIRE(*graphs[0] == *graphs[1]);
+
+    // Count elements with the event interface alone.
+    class ElementCounter : public mx::XmlStreamHandler
+    {
+      public:
+        void beginElement(const std::string&, const mx::XmlAttributeVec&) override
+        {
+            count++;
+        }
+        void endElement(const std::string&) override
+        {
+        }
+        size_t count = 0;
+    };
+    BenchmarkUtil::resetPeakResidentMemory();
+    size_t startMemory = BenchmarkUtil::getResidentMemory();
+    BenchmarkUtil::Timer timer;
+    ElementCounter counter;
+    mx::streamFromXmlFile(filename, counter);
+    BenchmarkUtil::report("Streaming element events", timer.elapsed(), counter.count);
+    size_t peakMemory = BenchmarkUtil::getPeakResidentMemory();
+    BenchmarkUtil::reportMemory("Streaming element events peak memory", peakMemory > startMemory ? peakMemory - startMemory : 0);
+
+    std::remove(filename.c_str());
+}
+
+TEST_CASE("Streaming write benchmark", "[xmlio][benchmark]")
+{
+    const size_t TARGET_FILE_SIZE = 16 * 1024 * 1024;
+    const std::string filename = "streaming_write_benchmark.mtlx";
+    const std::string outputFilename = "streaming_write_benchmark_output.mtlx";
+
+    writeSyntheticDocument(filename, TARGET_FILE_SIZE);
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::readFromXmlFile(doc, filename);
+    BenchmarkUtil::reportMemory("Synthetic document size", mx::FilePath(filename).getFileSize());
+
+    // Measure the time and the peak memory of a write, beyond that of the
+    // document itself.
+    BenchmarkUtil::resetPeakResidentMemory();
+    size_t startMemory = BenchmarkUtil::getResidentMemory();
+    BenchmarkUtil::Timer timer;
+    mx::writeToXmlFile(doc, outputFilename);
+    BenchmarkUtil::report("Document write", timer.elapsed());
+    size_t peakMemory = BenchmarkUtil::getPeakResidentMemory();
+    BenchmarkUtil::reportMemory("Document write peak memory", peakMemory > startMemory ? peakMemory - startMemory : 0);
+    REQUIRE(mx::FilePath(outputFilename).getFileSize() == mx::FilePath(filename).getFileSize());
+
+    std::remove(filename.c_str());
+    std::remove(outputFilename.c_str());
+}
+
+TEST_CASE("Read stats benchmark", "[xmlio][benchmark]")
+{
+    const size_t ITERATIONS = 10;
+    const mx::FilePath libraryPath("libraries/stdlib/stdlib_defs.mtlx");
+
+    // Measure the overhead of recording read stats.
+    mx::XmlReadOptions readOptions;
+    mx::XmlReadOptions statsOptions;
+    statsOptions.readStats = mx::XmlReadStats::create();
+    for (const mx::XmlReadOptions* options : { &readOptions, &statsOptions })
+    {
+        BenchmarkUtil::Timer timer;
+        for (size_t i = 0; i < ITERATIONS; i++)
+        {
+            mx::DocumentPtr doc = mx::createDocument();
+            mx::readFromXmlFile(doc, libraryPath, mx::FileSearchPath(), options);
+        }
+        BenchmarkUtil::report(options->readStats ? "Library read with stats" : "Library read without stats",
+                              timer.elapsed(), ITERATIONS);
+    }
+
+    // Report the phases of the read.
+    mx::XmlReadStatsPtr stats = statsOptions.readStats;
+    for (int phase = 0; phase < mx::XmlReadStats::PhaseCount; phase++)
+    {
+        mx::XmlReadStats::Phase readPhase = (mx::XmlReadStats::Phase) phase;
+        BenchmarkUtil::report("Library read phase: " + mx::XmlReadStats::getPhaseName(readPhase),
+                              stats->getPhaseTime(readPhase), ITERATIONS);
+    }
+    std::cout << "Library read: " << stats->getElementCount() / ITERATIONS << " elements, " <<
+                 stats->getAttributeCount() / ITERATIONS << " attributes, " <<
+                 stats->getByteCount() / ITERATIONS << " bytes" << std::endl;
+    REQUIRE(stats->getElementCount() > 0);
+}
@@ -4,18 +4,26 @@
 //
 
 #include <MaterialXTest/Catch/catch.hpp>
+#include <MaterialXTest/BenchmarkUtil.h>
 #include <MaterialXTest/MaterialXGenShader/GenShaderUtil.h>
 #include <MaterialXTest/MaterialXGenGlsl/GenGlsl.h>
 
 #include <MaterialXCore/Document.h>
 
 #include <MaterialXFormat/File.h>
+#include <MaterialXFormat/Util.h>
+#include <MaterialXFormat/XmlIo.h>
 
+#include <MaterialXGenShader/Util.h>
+
+#include <MaterialXGenShader/Shader.h>
 #include <MaterialXGenShader/TypeDesc.h>
 
 #include <MaterialXGenGlsl/GlslShaderGenerator.h>
 #include <MaterialXGenGlsl/GlslSyntax.h>
 
+#include <thread>
+
 namespace mx = MaterialX;
 
 TEST_CASE("GenShader: GLSL Syntax Check", "[genglsl]")
@@ -120,6 +128,90 @@ TEST_CASE("GenShader: Bind Light Shaders", "[genglsl]")
     REQUIRE_NOTHROW(mx::HwShaderGenerator::bindLightShader(*spotLightShader, 66, context));
 }
 
+TEST_CASE("GenShader: GLSL Concurrent Generation", "[genglsl]")
+{
+    const mx::FilePath searchPath = mx::FilePath::getCurrentPath() / mx::FilePath("libraries");
+    const mx::FilePath materialPath = mx::FilePath::getCurrentPath() /
+        mx::FilePath("resources/Materials/Examples/StandardSurface/standard_surface_default.mtlx");
+
+    mx::DocumentPtr doc = mx::createDocument();
+    loadLibraries({ "stdlib", "pbrlib", "bxdf" }, searchPath, doc);
+    mx::readFromXmlFile(doc, materialPath);
+    doc->freeze();
+
+    std::vector<mx::TypedElementPtr> elements;
+    mx::findRenderableElements(doc, elements);
+    REQUIRE(!elements.empty());
+
+    // Generate reference code serially.
+    mx::ShaderGeneratorPtr shadergen = mx::GlslShaderGenerator::create();
+    auto generateAll = [&shadergen, &elements, &searchPath](mx::StringVec& results)
+    {
+        mx::GenContext context(shadergen);
+        context.registerSourceCodeSearchPath(searchPath);
+        for (mx::TypedElementPtr element : elements)
+        {
+            mx::ShaderPtr shader = shadergen->generate(mx::createValidName(element->getNamePath()), element, context);
+            results.push_back(shader ? shader->getSourceCode(mx::Stage::PIXEL) : mx::EMPTY_STRING);
+        }
+    };
+    mx::StringVec reference;
+    generateAll(reference);
+    REQUIRE(!reference[0].empty());
+
+    // Generate code from multiple threads sharing the frozen document and
+    // generator, each with its own context.
+    const size_t THREAD_COUNT = 4;
+    std::vector<mx::StringVec> results(THREAD_COUNT);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < THREAD_COUNT; i++)
+    {
+        threads.emplace_back(generateAll, std::ref(results[i]));
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    for (const mx::StringVec& result : results)
+    {
+        REQUIRE(result == reference);
+    }
+}
+
+TEST_CASE("GenShader: GLSL Value Parse Benchmark", "[genglsl][benchmark]")
+{
+    const mx::FilePath searchPath = mx::FilePath::getCurrentPath() / mx::FilePath("libraries");
+    const mx::FilePath materialPath = mx::FilePath::getCurrentPath() /
+        mx::FilePath("resources/Materials/Examples/StandardSurface/standard_surface_default.mtlx");
+
+    mx::DocumentPtr doc = mx::createDocument();
+    loadLibraries({ "stdlib", "pbrlib", "bxdf" }, searchPath, doc);
+    mx::readFromXmlFile(doc, materialPath);
+
+    std::vector<mx::TypedElementPtr> elements;
+    mx::findRenderableElements(doc, elements);
+    REQUIRE(!elements.empty());
+
+    // Report the value strings parsed per generated shader, with the first
+    // pass parsing each value, and later passes reusing cached values.
+    mx::ShaderGeneratorPtr shadergen = mx::GlslShaderGenerator::create();
+    mx::GenContext context(shadergen);
+    context.registerSourceCodeSearchPath(searchPath);
+    for (const std::string& pass : mx::StringVec{ "Cold", "Warm" })
+    {
+        size_t parseCount = mx::Value::getParseCount();
+        BenchmarkUtil::Timer timer;
+        for (mx::TypedElementPtr element : elements)
+        {
+            mx::ShaderPtr shader = shadergen->generate(mx::createValidName(element->getNamePath()), element, context);
+            REQUIRE(shader);
+        }
+        BenchmarkUtil::report(pass + " GLSL generation", timer.elapsed(), elements.size());
+        size_t shaderParseCount = (mx::Value::getParseCount() - parseCount) / elements.size();
+        std::cout << "Benchmark: " << pass << " value parses per shader: " << shaderParseCount << std::endl;
+    }
+}
+
 static void generateGlslCode()
 {
     const mx::FilePath testRootPath = mx::FilePath::getCurrentPath() / mx::FilePath("resources/Materials/TestSuite");
@@ -176,6 +176,7 @@ class ShaderRenderTester
         _skipFiles.insert("light_rig_test_1.mtlx");
         _skipFiles.insert("light_rig_test_2.mtlx");
         _skipFiles.insert("light_compound_test.mtlx");
+        _skipFiles.insert("1_22_to_1_37.mtlx");
     }
 
     // Load dependencies
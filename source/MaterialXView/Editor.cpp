@@ -141,7 +141,7 @@ void PropertyEditor::addItemToForm(const mx::UIPropertyItem& item, const std::st
                                    ng::Widget* container, Viewer* viewer, bool editable)
 {
     const mx::UIProperties& ui = item.ui;
-    mx::ValuePtr value = item.variable->getValue();
+    mx::ConstValuePtr value = item.variable->getValue();
     if (!value)
     {
         return;
@@ -481,15 +481,16 @@ void Material::bindLights(const mx::GenContext& genContext, mx::LightHandlerPtr
                     std::string inputName(prefix + "." + input->getName());
                     if (_glShader->uniform(inputName, false) != -1)
                     {
-                        if (input->getName() == "direction" && input->hasValue() && input->getValue()->isA<mx::Vector3>())
+                        mx::ConstValuePtr value = input->getCachedValue();
+                        if (input->getName() == "direction" && value && value->isA<mx::Vector3>())
                         {
-                            mx::Vector3 dir = input->getValue()->asA<mx::Vector3>();
+                            mx::Vector3 dir = value->asA<mx::Vector3>();
                             dir = lightingState.lightTransform.transformVector(dir);
                             bindUniform(inputName, mx::Value::createValue(dir));
                         }
                         else
                         {
-                            bindUniform(inputName, input->getValue());
+                            bindUniform(inputName, value);
                         }
                     }
                 }
@@ -504,7 +505,7 @@ void Material::bindLights(const mx::GenContext& genContext, mx::LightHandlerPtr
                     std::string paramName(prefix + "." + param->getName());
                     if (_glShader->uniform(paramName, false) != -1)
                     {
-                        bindUniform(paramName, param->getValue());
+                        bindUniform(paramName, param->getCachedValue());
                     }
                 }
             }
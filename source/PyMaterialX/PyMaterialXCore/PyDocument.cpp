@@ -12,7 +12,7 @@ namespace mx = MaterialX;
 
 void bindPyDocument(py::module& mod)
 {
-    mod.def("createDocument", &mx::createDocument);
+    mod.def("createDocument", &mx::createDocument, py::arg("useArena") = false);
 
     py::class_<mx::Document, mx::DocumentPtr, mx::GraphElement>(mod, "Document")
         .def("initialize", &mx::Document::initialize)
@@ -20,6 +20,24 @@ void bindPyDocument(py::module& mod)
         .def("importLibrary", &mx::Document::importLibrary,
             py::arg("library"), py::arg("copyOptions") = (const mx::CopyOptions*) nullptr)
         .def("getReferencedSourceUris", &mx::Document::getReferencedSourceUris)
+        .def("referenceLibrary", &mx::Document::referenceLibrary)
+        .def("getReferencedLibraries", &mx::Document::getReferencedLibraries)
+        .def("clearReferencedLibraries", &mx::Document::clearReferencedLibraries)
+        .def("getReferencedElement", &mx::Document::getReferencedElement)
+        .def("copyReferencedElement", &mx::Document::copyReferencedElement)
+        .def("freeze", &mx::Document::freeze)
+        .def("isFrozen", &mx::Document::isFrozen)
+        .def("validateDiagnostics", [](mx::Document& doc, const mx::ValidationOptions& options)
+            {
+                mx::ValidationDiagnosticVec diagnostics;
+                bool res = doc.validate(diagnostics, options);
+                return std::pair<bool, mx::ValidationDiagnosticVec>(res, diagnostics);
+            },
+            py::arg("options") = mx::ValidationOptions())
+        .def("setNodeDefCacheStatsEnabled", &mx::Document::setNodeDefCacheStatsEnabled)
+        .def("isNodeDefCacheStatsEnabled", &mx::Document::isNodeDefCacheStatsEnabled)
+        .def("getNodeDefCacheStats", &mx::Document::getNodeDefCacheStats)
+        .def("resetNodeDefCacheStats", &mx::Document::resetNodeDefCacheStats)
         .def("addNodeGraph", &mx::Document::addNodeGraph,
             py::arg("name") = mx::EMPTY_STRING)
         .def("getNodeGraph", &mx::Document::getNodeGraph)
@@ -100,4 +118,15 @@ void bindPyDocument(py::module& mod)
         .def("setColorManagementConfig", &mx::Document::setColorManagementConfig)
         .def("hasColorManagementConfig", &mx::Document::hasColorManagementConfig)
         .def("getColorManagementConfig", &mx::Document::getColorManagementConfig);
+
+    py::class_<mx::ValidationOptions>(mod, "ValidationOptions")
+        .def(py::init())
+        .def_readwrite("threadCount", &mx::ValidationOptions::threadCount)
+        .def_readwrite("maxErrors", &mx::ValidationOptions::maxErrors);
+
+    py::class_<mx::NodeDefCacheStats>(mod, "NodeDefCacheStats")
+        .def(py::init())
+        .def_readonly("hits", &mx::NodeDefCacheStats::hits)
+        .def_readonly("misses", &mx::NodeDefCacheStats::misses)
+        .def("getHitRate", &mx::NodeDefCacheStats::getHitRate);
 }
@@ -30,6 +30,11 @@ void bindPyElement(py::module& mod)
         .def(py::init())
         .def_readwrite("skipConflictingElements", &mx::CopyOptions::skipConflictingElements);
 
+    py::class_<mx::ValidationDiagnostic>(mod, "ValidationDiagnostic")
+        .def_readonly("elementPath", &mx::ValidationDiagnostic::elementPath)
+        .def_readonly("rule", &mx::ValidationDiagnostic::rule)
+        .def_readonly("message", &mx::ValidationDiagnostic::message);
+
     py::class_<mx::Element, mx::ElementPtr>(mod, "Element")
         .def(py::self == py::self)
         .def(py::self != py::self)
@@ -80,7 +85,7 @@ void bindPyElement(py::module& mod)
         .def("setChildIndex", &mx::Element::setChildIndex)
         .def("getChildIndex", &mx::Element::getChildIndex)
         .def("removeChild", &mx::Element::removeChild)
-        .def("setAttribute", &mx::Element::setAttribute)
+        .def("setAttribute", static_cast<void (mx::Element::*)(const std::string&, const std::string&)>(&mx::Element::setAttribute))
         .def("hasAttribute", &mx::Element::hasAttribute)
         .def("getAttribute", &mx::Element::getAttribute)
         .def("getAttributeNames", &mx::Element::getAttributeNames)
@@ -92,6 +97,8 @@ void bindPyElement(py::module& mod)
         .def("traverseTree", &mx::Element::traverseTree)
         .def("traverseGraph", &mx::Element::traverseGraph,
             py::arg("material") = nullptr)
+        .def("traverseGraphUnique", &mx::Element::traverseGraphUnique,
+            py::arg("material") = nullptr)
         .def("getUpstreamEdge", &mx::Element::getUpstreamEdge,
             py::arg("material") = nullptr, py::arg("index") = 0)
         .def("getUpstreamEdgeCount", &mx::Element::getUpstreamEdgeCount)
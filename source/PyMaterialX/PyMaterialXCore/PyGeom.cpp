@@ -19,6 +19,8 @@ void bindPyGeom(py::module& mod)
         .def("setGeom", &mx::GeomElement::setGeom)
         .def("hasGeom", &mx::GeomElement::hasGeom)
         .def("getGeom", &mx::GeomElement::getGeom)
+        .def("matchesGeomString", &mx::GeomElement::matchesGeomString)
+        .def("matchesGeomStrings", &mx::GeomElement::matchesGeomStrings)
         .def("setCollectionString", &mx::GeomElement::setCollectionString)
         .def("hasCollectionString", &mx::GeomElement::hasCollectionString)
         .def("getCollectionString", &mx::GeomElement::getCollectionString)
@@ -87,7 +89,15 @@ void bindPyGeom(py::module& mod)
         .def("getIncludeCollections", &mx::Collection::getIncludeCollections)
         .def("hasIncludeCycle", &mx::Collection::hasIncludeCycle)
         .def("matchesGeomString", &mx::Collection::matchesGeomString)
+        .def("matchesGeomStrings", &mx::Collection::matchesGeomStrings)
         .def_readonly_static("CATEGORY", &mx::Collection::CATEGORY);
 
+    py::class_<mx::GeomPathMatcher>(mod, "GeomPathMatcher")
+        .def(py::init<>())
+        .def(py::init<const std::string&>())
+        .def("matches", &mx::GeomPathMatcher::matches,
+            py::arg("geom"), py::arg("contains") = false)
+        .def("isEmpty", &mx::GeomPathMatcher::isEmpty);
+
     mod.def("geomStringsMatch", &mx::geomStringsMatch);
 }
@@ -40,10 +40,16 @@ void bindPyNode(py::module& mod)
         .def("getBackdrops", &mx::GraphElement::getBackdrops)
         .def("removeBackdrop", &mx::GraphElement::removeBackdrop)
         .def("flattenSubgraphs", &mx::GraphElement::flattenSubgraphs,
-            py::arg("target") = mx::EMPTY_STRING)
+            py::arg("target") = mx::EMPTY_STRING, py::arg("stats") = (mx::FlattenStats*) nullptr)
         .def("topologicalSort", &mx::GraphElement::topologicalSort)
         .def("asStringDot", &mx::GraphElement::asStringDot);
 
+    py::class_<mx::FlattenStats>(mod, "FlattenStats")
+        .def(py::init())
+        .def_readonly("flattenedNodeCount", &mx::FlattenStats::flattenedNodeCount)
+        .def_readonly("instantiatedNodeCount", &mx::FlattenStats::instantiatedNodeCount)
+        .def_readonly("nestingDepth", &mx::FlattenStats::nestingDepth);
+
     py::class_<mx::NodeGraph, mx::NodeGraphPtr, mx::GraphElement>(mod, "NodeGraph")
         .def("setNodeDef", &mx::NodeGraph::setNodeDef)
         .def("getNodeDef", &mx::NodeGraph::getNodeDef)
@@ -27,7 +27,7 @@ void bindPyObserver(py::module& mod)
 
 void bindPyObservedDocument(py::module& mod)
 {
-    mod.def("createObservedDocument", &mx::Document::createDocument<mx::ObservedDocument>);
+    mod.def("createObservedDocument", &mx::Document::createDocument<mx::ObservedDocument>, py::arg("useArena") = false);
 
     py::class_<mx::ObservedDocument, mx::ObservedDocumentPtr, mx::Document>(mod, "ObservedDocument")
         .def("copy", &mx::ObservedDocument::copy)
@@ -45,6 +45,7 @@ void bindPyTraversal(py::module& mod)
         .def("getNodeDepth", &mx::GraphIterator::getNodeDepth)
         .def("setPruneSubgraph", &mx::GraphIterator::setPruneSubgraph)
         .def("getPruneSubgraph", &mx::GraphIterator::getPruneSubgraph)
+        .def("isUnique", &mx::GraphIterator::isUnique)
         .def("__iter__", [](mx::GraphIterator& it) -> mx::GraphIterator&
             {
                 return it.begin(1);
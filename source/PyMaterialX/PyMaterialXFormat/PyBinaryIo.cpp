@@ -0,0 +1,40 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#include <PyMaterialX/PyMaterialX.h>
+
+#include <MaterialXFormat/BinaryIo.h>
+#include <MaterialXCore/Document.h>
+
+namespace py = pybind11;
+namespace mx = MaterialX;
+
+void bindPyBinaryIo(py::module& mod)
+{
+    py::class_<mx::BinaryReadOptions>(mod, "BinaryReadOptions")
+        .def(py::init())
+        .def_readwrite("readElementIndex", &mx::BinaryReadOptions::readElementIndex)
+        .def_readwrite("applyFutureUpdates", &mx::BinaryReadOptions::applyFutureUpdates);
+
+    py::class_<mx::BinaryWriteOptions>(mod, "BinaryWriteOptions")
+        .def(py::init())
+        .def_readwrite("writeElementIndex", &mx::BinaryWriteOptions::writeElementIndex);
+
+    mod.def("readFromBinaryFile", &mx::readFromBinaryFile,
+        py::arg("doc"), py::arg("filename"), py::arg("searchPath") = mx::FileSearchPath(), py::arg("readOptions") = (mx::BinaryReadOptions*) nullptr);
+    mod.def("readFromBinaryString", [](mx::DocumentPtr doc, const py::bytes& data, const mx::BinaryReadOptions* readOptions)
+        {
+            std::string buffer = data;
+            mx::readFromBinaryBuffer(doc, buffer.data(), buffer.size(), readOptions);
+        },
+        py::arg("doc"), py::arg("data"), py::arg("readOptions") = (mx::BinaryReadOptions*) nullptr);
+    mod.def("writeToBinaryFile", mx::writeToBinaryFile,
+        py::arg("doc"), py::arg("filename"), py::arg("writeOptions") = (mx::BinaryWriteOptions*) nullptr);
+    mod.def("writeToBinaryString", [](mx::DocumentPtr doc, const mx::BinaryWriteOptions* writeOptions)
+        {
+            return py::bytes(mx::writeToBinaryString(doc, writeOptions));
+        },
+        py::arg("doc"), py::arg("writeOptions") = (mx::BinaryWriteOptions*) nullptr);
+}
@@ -41,11 +41,24 @@ void bindPyFile(py::module& mod)
         .def("removeExtension", &mx::FilePath::removeExtension)
         .def("exists", &mx::FilePath::exists)
         .def("isDirectory", &mx::FilePath::isDirectory)
+        .def("getModificationTime", &mx::FilePath::getModificationTime)
+        .def("getFileSize", &mx::FilePath::getFileSize)
         .def("getFilesInDirectory", &mx::FilePath::getFilesInDirectory)
         .def("getSubDirectories", &mx::FilePath::getSubDirectories)
         .def("createDirectory", &mx::FilePath::createDirectory)
         .def_static("getCurrentPath", &mx::FilePath::getCurrentPath);
 
+    py::class_<mx::FileResolutionCache, mx::FileResolutionCachePtr>(mod, "FileResolutionCache")
+        .def_static("create", &mx::FileResolutionCache::create)
+        .def("find", &mx::FileResolutionCache::find)
+        .def("setTimeToLive", &mx::FileResolutionCache::setTimeToLive)
+        .def("getTimeToLive", &mx::FileResolutionCache::getTimeToLive)
+        .def("getHitCount", &mx::FileResolutionCache::getHitCount)
+        .def("getMissCount", &mx::FileResolutionCache::getMissCount)
+        .def("getEntryCount", &mx::FileResolutionCache::getEntryCount)
+        .def("resetCounters", &mx::FileResolutionCache::resetCounters)
+        .def("clear", &mx::FileResolutionCache::clear);
+
     py::class_<mx::FileSearchPath>(mod, "FileSearchPath")
         .def(py::init<>())
         .def(py::init<const std::string&, const std::string&>(),
@@ -58,6 +71,8 @@ void bindPyFile(py::module& mod)
         .def("clear", &mx::FileSearchPath::clear)
         .def("size", &mx::FileSearchPath::size)
         .def("isEmpty", &mx::FileSearchPath::isEmpty)
+        .def("setResolutionCache", &mx::FileSearchPath::setResolutionCache)
+        .def("getResolutionCache", &mx::FileSearchPath::getResolutionCache)
         .def("find", &mx::FileSearchPath::find);
 
     py::implicitly_convertible<std::string, mx::FilePath>();
@@ -7,6 +7,7 @@
 
 namespace py = pybind11;
 
+void bindPyBinaryIo(py::module& mod);
 void bindPyFile(py::module& mod);
 void bindPyXmlIo(py::module& mod);
 
@@ -16,4 +17,5 @@ PYBIND11_MODULE(PyMaterialXFormat, mod)
 
     bindPyFile(mod);
     bindPyXmlIo(mod);
+    bindPyBinaryIo(mod);
 }
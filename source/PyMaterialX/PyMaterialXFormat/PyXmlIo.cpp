@@ -11,12 +11,85 @@
 namespace py = pybind11;
 namespace mx = MaterialX;
 
+class PyXmlStreamHandler : public mx::XmlStreamHandler
+{
+  public:
+    PyXmlStreamHandler()
+    {
+    }
+
+    void beginElement(const std::string& category, const mx::XmlAttributeVec& attributes) override
+    {
+        PYBIND11_OVERLOAD_PURE(
+            void,
+            mx::XmlStreamHandler,
+            beginElement,
+            category,
+            attributes
+        );
+    }
+
+    void endElement(const std::string& category) override
+    {
+        PYBIND11_OVERLOAD_PURE(
+            void,
+            mx::XmlStreamHandler,
+            endElement,
+            category
+        );
+    }
+};
+
 void bindPyXmlIo(py::module& mod)
 {
     py::class_<mx::XmlReadOptions, mx::CopyOptions>(mod, "XmlReadOptions")
         .def(py::init())
         .def_readwrite("readXIncludeFunction", &mx::XmlReadOptions::readXIncludeFunction)
-        .def_readwrite("parentXIncludes", &mx::XmlReadOptions::parentXIncludes);
+        .def_readwrite("parentXIncludes", &mx::XmlReadOptions::parentXIncludes)
+        .def_readwrite("memoryMapFiles", &mx::XmlReadOptions::memoryMapFiles)
+        .def_readwrite("buildThreadCount", &mx::XmlReadOptions::buildThreadCount)
+        .def_readwrite("includeCache", &mx::XmlReadOptions::includeCache)
+        .def_readwrite("elementPredicate", &mx::XmlReadOptions::elementPredicate)
+        .def_readwrite("readStats", &mx::XmlReadOptions::readStats);
+
+    py::class_<mx::XmlReadStats, mx::XmlReadStatsPtr> readStats(mod, "XmlReadStats");
+
+    py::enum_<mx::XmlReadStats::Phase>(readStats, "Phase")
+        .value("PhaseParse", mx::XmlReadStats::Phase::PhaseParse)
+        .value("PhaseXInclude", mx::XmlReadStats::Phase::PhaseXInclude)
+        .value("PhaseConstruct", mx::XmlReadStats::Phase::PhaseConstruct)
+        .value("PhaseDuplicates", mx::XmlReadStats::Phase::PhaseDuplicates)
+        .value("PhaseUpgrade", mx::XmlReadStats::Phase::PhaseUpgrade)
+        .export_values();
+
+    readStats
+        .def_static("create", &mx::XmlReadStats::create,
+            py::arg("source") = mx::EMPTY_STRING)
+        .def_static("getPhaseName", &mx::XmlReadStats::getPhaseName)
+        .def("setSource", &mx::XmlReadStats::setSource)
+        .def("getSource", &mx::XmlReadStats::getSource)
+        .def("getPhaseTime", &mx::XmlReadStats::getPhaseTime)
+        .def("getTotalTime", &mx::XmlReadStats::getTotalTime)
+        .def("getElementCount", &mx::XmlReadStats::getElementCount)
+        .def("getAttributeCount", &mx::XmlReadStats::getAttributeCount)
+        .def("getByteCount", &mx::XmlReadStats::getByteCount)
+        .def("getIncludes", &mx::XmlReadStats::getIncludes)
+        .def("toJson", &mx::XmlReadStats::toJson)
+        .def("clear", &mx::XmlReadStats::clear);
+
+    py::class_<mx::XmlIncludeCache, mx::XmlIncludeCachePtr>(mod, "XmlIncludeCache")
+        .def_static("create", &mx::XmlIncludeCache::create)
+        .def("getHitCount", &mx::XmlIncludeCache::getHitCount)
+        .def("getMissCount", &mx::XmlIncludeCache::getMissCount)
+        .def("getParsedByteCount", &mx::XmlIncludeCache::getParsedByteCount)
+        .def("getEntryCount", &mx::XmlIncludeCache::getEntryCount)
+        .def("resetCounters", &mx::XmlIncludeCache::resetCounters)
+        .def("clear", &mx::XmlIncludeCache::clear);
+
+    py::class_<mx::XmlStreamHandler, PyXmlStreamHandler>(mod, "XmlStreamHandler")
+        .def(py::init<>())
+        .def("beginElement", &mx::XmlStreamHandler::beginElement)
+        .def("endElement", &mx::XmlStreamHandler::endElement);
 
     py::class_<mx::XmlWriteOptions>(mod, "XmlWriteOptions")
         .def(py::init())
@@ -27,6 +100,8 @@ void bindPyXmlIo(py::module& mod)
         py::arg("doc"), py::arg("filename"), py::arg("searchPath") = mx::FileSearchPath(), py::arg("readOptions") = (mx::XmlReadOptions*) nullptr);
     mod.def("readFromXmlString", &mx::readFromXmlString,
         py::arg("doc"), py::arg("str"), py::arg("readOptions") = (mx::XmlReadOptions*) nullptr);
+    mod.def("streamFromXmlFile", &mx::streamFromXmlFile,
+        py::arg("filename"), py::arg("handler"), py::arg("searchPath") = mx::FileSearchPath());
     mod.def("writeToXmlFile", mx::writeToXmlFile,
         py::arg("doc"), py::arg("filename"), py::arg("writeOptions") = (mx::XmlWriteOptions*) nullptr);
     mod.def("writeToXmlString", mx::writeToXmlString,
@@ -20,8 +20,8 @@ void bindPyShaderPort(py::module& mod)
         .def("getFullName", &mx::ShaderPort::getFullName)
         .def("setSemantic", &mx::ShaderPort::setSemantic)
         .def("getSemantic", &mx::ShaderPort::getSemantic)
-        .def("setValue", &mx::ShaderPort::setValue)
-        .def("getValue", &mx::ShaderPort::getValue)
+        .def("setValue", [](mx::ShaderPort& port, mx::ValuePtr value) { port.setValue(value); })
+        .def("getValue", [](const mx::ShaderPort& port) { return port.getValue() ? port.getValue()->copy() : nullptr; })
         .def("setPath", &mx::ShaderPort::setPath)
         .def("getPath", &mx::ShaderPort::getPath)
         .def("setUnit", &mx::ShaderPort::setUnit)
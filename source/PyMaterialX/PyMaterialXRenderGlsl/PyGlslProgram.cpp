@@ -46,7 +46,9 @@ void bindPyGlslProgram(py::module& mod)
         .def_readwrite("gltype", &mx::GlslProgram::Input::gltype)
         .def_readwrite("size", &mx::GlslProgram::Input::size)
         .def_readwrite("typeString", &mx::GlslProgram::Input::typeString)
-        .def_readwrite("value", &mx::GlslProgram::Input::value)
+        .def_property("value",
+            [](const mx::GlslProgram::Input& input) { return input.value ? input.value->copy() : nullptr; },
+            [](mx::GlslProgram::Input& input, mx::ValuePtr value) { input.value = value; })
         .def_readwrite("isConstant", &mx::GlslProgram::Input::isConstant)
         .def_readwrite("path", &mx::GlslProgram::Input::path)
         .def(py::init<int, int, int, std::string>());